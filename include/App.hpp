@@ -3,6 +3,7 @@
 
 #include "common/Types.hpp"
 #include "core/EventBus.hpp"
+#include "core/TopicRouter.hpp"
 
 #include "services/AttendanceService.hpp"
 #include "services/ConfigService.hpp"
@@ -13,6 +14,7 @@
 #include "services/Pn532Service.hpp"
 #include "services/PowerService.hpp"
 #include "services/WiFiService.hpp"
+#include "utils/EventJournalRecorder.hpp"
 
 #include <TaskSchedulerDeclarations.h>
 #include <ESPAsyncWebServer.h>
@@ -56,6 +58,10 @@ public:
     {
         return m_eventBus;
     }
+    TopicRouter &getTopicRouter()
+    {
+        return m_topicRouter;
+    }
     ConfigService &getConfigService()
     {
         return m_configService;
@@ -98,19 +104,20 @@ private:
     void startWebServer();
 
     // Static callbacks for TaskScheduler
-    static constexpr uint32_t EVENTBUS_INTERVAL_MS = 10; // High priority: 100Hz event dispatch
+    static constexpr uint32_t EVENTBUS_INTERVAL_MS = 10; // Follow-up tick while events remain; idle = disabled
+    static constexpr uint32_t EVENTBUS_MAX_EVENTS_PER_TICK = 16; // Leftovers carry over to the next tick
+    static constexpr uint32_t EVENTBUS_BUDGET_US = 4000;         // Leave most of the tick to PN532 & co.
     static constexpr uint32_t CONFIG_INTERVAL_MS = 5000;
     static constexpr uint32_t WIFI_INTERVAL_MS = 1000;
     static constexpr uint32_t MQTT_INTERVAL_MS = 1000;
     static constexpr uint32_t PN532_INTERVAL_MS = 100;
-    static constexpr uint32_t ATTENDANCE_INTERVAL_MS = 100;
     static constexpr uint32_t FEEDBACK_INTERVAL_MS = 20; // Fast for smooth LED
-    static constexpr uint32_t HEALTH_INTERVAL_MS = 10000;
     static constexpr uint32_t OTA_INTERVAL_MS = 1000;
     static constexpr uint32_t POWER_INTERVAL_MS = 1000;
 
     Scheduler m_scheduler;
     EventBus m_eventBus;
+    TopicRouter m_topicRouter; ///< Inbound MQTT routes, filled by service constructors
     AsyncWebServer m_webServer;
 
     ConfigService m_configService;
@@ -122,15 +129,16 @@ private:
     FeedbackService m_feedbackService;
     HealthService m_healthService;
     PowerService m_powerService;
+#ifdef ISIC_ENABLE_EVENT_JOURNAL
+    utils::EventJournalRecorder m_journalRecorder;
+#endif
 
     Task m_eventBusTask;
     Task m_configTask;
     Task m_wifiTask;
     Task m_mqttTask;
     Task m_pn532Task;
-    Task m_attendanceTask;
     Task m_feedbackTask;
-    Task m_healthTask;
     Task m_otaTask;
     Task m_powerTask;
 
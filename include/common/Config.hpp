@@ -191,27 +191,36 @@ struct AttendanceConfig
         DropNewest, ///< Reject new records when buffer is full
         DropAll, ///< Clear entire buffer when full (for critical-only mode)
     };
-    
-    struct Constants
+
+    enum class PayloadFormat : std::uint8_t
     {
-        static constexpr auto kDebounceCacheSize{8};
+        Json = 0, ///< JSON array of {"uid","ts","seq"} on <device>/attendance
+        Packed, ///< Varint-packed records on <device>/attendance/packed, see tools/attendance_decode.py
     };
 
     static constexpr auto kDefaultDebounceIntervalMs{60'000}; // 60 seconds
+    static constexpr auto kDefaultDebounceCacheSize{256}; // Distinct cards remembered at once, up to ISIC_DEBOUNCE_MAX_CAPACITY (512 on ESP8266)
     static constexpr auto kDefaultBatchMaxSize{5};
     static constexpr auto kDefaultOfflineBufferSize{20};
     static constexpr auto kDefaultBatchFlushIntervalMs{10'000}; // 10 seconds
     static constexpr auto kDefaultBatchingEnabled{false}; // Disabled by default
     static constexpr auto kDefaultOfflineBufferFlushIntervalMs{5'000}; // 5 seconds
     static constexpr auto kDefaultOfflineQueuePolicy{OfflineQueuePolicy::DropOldest}; // Drop oldest by default
+    static constexpr auto kDefaultJournalEnabled{true}; // Offline records go to flash, offlineBufferSize is the RAM fallback
+    static constexpr auto kDefaultJournalMaxRecords{20'000}; // 20 bytes each on LittleFS
+    static constexpr auto kDefaultPayloadFormat{PayloadFormat::Json}; // What existing backends parse
 
     std::uint32_t debounceIntervalMs{kDefaultDebounceIntervalMs};
     std::uint32_t batchFlushIntervalMs{kDefaultBatchFlushIntervalMs};
     std::uint32_t offlineBufferFlushIntervalMs{kDefaultOfflineBufferFlushIntervalMs};
+    std::uint32_t journalMaxRecords{kDefaultJournalMaxRecords};
     std::uint16_t offlineBufferSize{kDefaultOfflineBufferSize};
+    std::uint16_t debounceCacheSize{kDefaultDebounceCacheSize};
     std::uint8_t batchMaxSize{kDefaultBatchMaxSize};
     OfflineQueuePolicy offlineQueuePolicy{kDefaultOfflineQueuePolicy};
+    PayloadFormat payloadFormat{kDefaultPayloadFormat};
     bool batchingEnabled{kDefaultBatchingEnabled};
+    bool journalEnabled{kDefaultJournalEnabled};
 
     [[nodiscard]] constexpr bool isConfigured() const // NOLINT
     {
@@ -221,12 +230,16 @@ struct AttendanceConfig
     constexpr void restoreDefaults()
     {
         debounceIntervalMs = kDefaultDebounceIntervalMs;
+        debounceCacheSize = kDefaultDebounceCacheSize;
         batchMaxSize = kDefaultBatchMaxSize;
         batchFlushIntervalMs = kDefaultBatchFlushIntervalMs;
         offlineBufferSize = kDefaultOfflineBufferSize;
         offlineBufferFlushIntervalMs = kDefaultOfflineBufferFlushIntervalMs;
         batchingEnabled = kDefaultBatchingEnabled;
         offlineQueuePolicy = kDefaultOfflineQueuePolicy;
+        journalEnabled = kDefaultJournalEnabled;
+        journalMaxRecords = kDefaultJournalMaxRecords;
+        payloadFormat = kDefaultPayloadFormat;
     }
 };
 
@@ -280,7 +293,7 @@ struct HealthConfig
 {
     struct Constants
     {
-        static constexpr auto kMaxComponentsCount{8};
+        static constexpr auto kMaxComponentsCount{9}; // 8 services + EventBus
         static constexpr auto kHeapCriticalThresholdBytes{4096};
         static constexpr auto kHeapWarningThresholdBytes{8192};
         static constexpr auto kRssiCriticalThresholdDbm {-90};
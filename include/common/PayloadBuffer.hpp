@@ -0,0 +1,443 @@
+#ifndef ISIC_COMMON_PAYLOAD_BUFFER_HPP
+#define ISIC_COMMON_PAYLOAD_BUFFER_HPP
+
+/**
+ * @file PayloadBuffer.hpp
+ * @brief Pooled, reference-counted byte buffers for MQTT payloads
+ *
+ * A payload is written once into a block from a fixed pool and then only the
+ * handle travels: through the EventBus, to every subscriber and into the
+ * MQTT client. Copying a handle bumps a counter, never the bytes, and the
+ * block returns to the pool when the last handle goes away.
+ */
+
+#include "platform/PlatformAtomic.hpp"
+#include "platform/PlatformMutex.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <string_view>
+
+namespace isic
+{
+/// 512 B blocks: single events, health and most config responses
+#ifndef ISIC_PAYLOAD_SMALL_BLOCKS
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ISIC_PLATFORM_ESP8266)
+#define ISIC_PAYLOAD_SMALL_BLOCKS 4
+#else
+#define ISIC_PAYLOAD_SMALL_BLOCKS 8
+#endif
+#endif
+
+/// 4 KB blocks: attendance batches, metrics and full config (PubSubClient buffer is 4024 B)
+#ifndef ISIC_PAYLOAD_LARGE_BLOCKS
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ISIC_PLATFORM_ESP8266)
+#define ISIC_PAYLOAD_LARGE_BLOCKS 1
+#else
+#define ISIC_PAYLOAD_LARGE_BLOCKS 2
+#endif
+#endif
+
+struct PayloadPoolMetrics
+{
+    std::uint16_t smallInUse{0};
+    std::uint16_t smallPeak{0};
+    std::uint16_t largeInUse{0};
+    std::uint16_t largePeak{0};
+    std::uint32_t heapFallbacks{0}; ///< Payloads that did not fit a free block and went to the heap
+    std::uint32_t allocFailures{0}; ///< Heap fallback failed too, payload dropped
+};
+
+/**
+ * @class PayloadPool
+ * @brief Fixed pool of small and large payload blocks
+ *
+ * Block storage is static, so steady-state MQTT traffic never touches the
+ * heap and cannot fragment it. A payload that does not fit its size class
+ * (pool exhausted or larger than a large block) falls back to the heap and
+ * is counted, so the pool can be sized from the field metrics.
+ *
+ * @par Thread Safety
+ * acquire()/retain()/release() take a CriticalSection for a few instructions
+ * (free-list pop/push, reference count), safe from any task.
+ */
+class PayloadPool
+{
+public:
+    static constexpr std::size_t kSmallBlockSize{512};
+    static constexpr std::size_t kLargeBlockSize{4096};
+    static constexpr std::size_t kSmallBlockCount{ISIC_PAYLOAD_SMALL_BLOCKS};
+    static constexpr std::size_t kLargeBlockCount{ISIC_PAYLOAD_LARGE_BLOCKS};
+
+    /// Block header, followed in memory by the payload bytes
+    struct Block
+    {
+        enum class Origin : std::uint8_t
+        {
+            Small,
+            Large,
+            Heap,
+        };
+
+        Block *nextFree{nullptr};
+        std::uint16_t refs{0};
+        std::uint16_t size{0};
+        std::uint16_t capacity{0}; ///< Usable bytes, excluding the NUL terminator
+        Origin origin{Origin::Small};
+
+        [[nodiscard]] char *bytes()
+        {
+            return reinterpret_cast<char *>(this + 1);
+        }
+    };
+
+    PayloadPool(const PayloadPool &) = delete;
+    PayloadPool &operator=(const PayloadPool &) = delete;
+
+    static PayloadPool &instance()
+    {
+        static PayloadPool pool;
+        return pool;
+    }
+
+    /**
+     * @brief Take a block able to hold @p capacity bytes plus a terminator
+     *
+     * @return Block with one reference, or nullptr if even the heap is out
+     */
+    [[nodiscard]] Block *acquire(const std::size_t capacity)
+    {
+        if (capacity < kSmallBlockSize)
+        {
+            if (auto *block{takeFree(m_freeSmall, m_metrics.smallInUse, m_metrics.smallPeak)})
+            {
+                return block;
+            }
+        }
+        else if (capacity < kLargeBlockSize)
+        {
+            if (auto *block{takeFree(m_freeLarge, m_metrics.largeInUse, m_metrics.largePeak)})
+            {
+                return block;
+            }
+        }
+        return acquireFromHeap(capacity);
+    }
+
+    void retain(Block *block)
+    {
+        LockGuard<CriticalSection> lock(m_lock);
+        ++block->refs;
+    }
+
+    void release(Block *block)
+    {
+        {
+            LockGuard<CriticalSection> lock(m_lock);
+            if (--block->refs > 0)
+            {
+                return;
+            }
+
+            if (block->origin != Block::Origin::Heap)
+            {
+                const bool small{block->origin == Block::Origin::Small};
+                block->nextFree = small ? m_freeSmall : m_freeLarge;
+                (small ? m_freeSmall : m_freeLarge) = block;
+                --(small ? m_metrics.smallInUse : m_metrics.largeInUse);
+                return;
+            }
+        }
+
+        block->~Block();
+        ::operator delete(static_cast<void *>(block));
+    }
+
+    /// Snapshot of usage counters
+    [[nodiscard]] PayloadPoolMetrics getMetrics() const
+    {
+        LockGuard<CriticalSection> lock(m_lock);
+        return m_metrics;
+    }
+
+private:
+    template<std::size_t BlockSize, std::size_t Count>
+    struct Arena
+    {
+        alignas(Block) std::uint8_t storage[Count][sizeof(Block) + BlockSize];
+    };
+
+    PayloadPool()
+    {
+        m_freeSmall = threadFreeList(m_small.storage, kSmallBlockSize, Block::Origin::Small);
+        m_freeLarge = threadFreeList(m_large.storage, kLargeBlockSize, Block::Origin::Large);
+    }
+
+    template<std::size_t Stride, std::size_t Count>
+    static Block *threadFreeList(std::uint8_t (&storage)[Count][Stride], const std::size_t blockSize, const Block::Origin origin)
+    {
+        Block *head{nullptr};
+        for (std::size_t i{Count}; i-- > 0;)
+        {
+            auto *block{new (storage[i]) Block{}};
+            block->capacity = static_cast<std::uint16_t>(blockSize - 1);
+            block->origin = origin;
+            block->nextFree = head;
+            head = block;
+        }
+        return head;
+    }
+
+    Block *takeFree(Block *&head, std::uint16_t &inUse, std::uint16_t &peak)
+    {
+        LockGuard<CriticalSection> lock(m_lock);
+        auto *block{head};
+        if (block)
+        {
+            head = block->nextFree;
+            block->nextFree = nullptr;
+            block->refs = 1;
+            block->size = 0;
+            if (++inUse > peak)
+            {
+                peak = inUse;
+            }
+        }
+        return block;
+    }
+
+    Block *acquireFromHeap(const std::size_t capacity)
+    {
+        // Payload sizes are bounded by the 16-bit header fields
+        void *raw{capacity < 0xFFFF ? ::operator new(sizeof(Block) + capacity + 1, std::nothrow) : nullptr};
+
+        LockGuard<CriticalSection> lock(m_lock);
+        if (!raw)
+        {
+            ++m_metrics.allocFailures;
+            return nullptr;
+        }
+        ++m_metrics.heapFallbacks;
+
+        auto *block{new (raw) Block{}};
+        block->refs = 1;
+        block->capacity = static_cast<std::uint16_t>(capacity);
+        block->origin = Block::Origin::Heap;
+        return block;
+    }
+
+    mutable CriticalSection m_lock;
+    Block *m_freeSmall{nullptr};
+    Block *m_freeLarge{nullptr};
+    PayloadPoolMetrics m_metrics{};
+
+    Arena<kSmallBlockSize, kSmallBlockCount> m_small{};
+    Arena<kLargeBlockSize, kLargeBlockCount> m_large{};
+};
+
+/**
+ * @class PayloadBuffer
+ * @brief Shared, immutable-once-published handle to a pooled payload
+ *
+ * Reads look like std::string_view; the bytes are always NUL-terminated so
+ * c_str() can feed C APIs directly. An empty payload holds no block.
+ *
+ * @par Writing
+ * Use allocate() and fill data() before the handle is shared (published or
+ * copied). After that the bytes are treated as read-only by every holder.
+ *
+ * @par Usage
+ * @code
+ * auto payload{PayloadBuffer::allocate(measureJson(doc))};
+ * payload.resize(serializeJson(doc, payload.data(), payload.capacity() + 1));
+ * bus.publish(Event{EventType::MqttPublishRequest, MqttEvent{"attendance", std::move(payload)}});
+ * @endcode
+ */
+class PayloadBuffer
+{
+public:
+    PayloadBuffer() = default;
+
+    // Implicit on purpose: keeps MqttEvent{.payload = "..."} call sites working, at the cost of one copy
+    PayloadBuffer(const std::string_view text) // NOLINT(google-explicit-constructor)
+    {
+        assign(text);
+    }
+
+    PayloadBuffer(const char *text) // NOLINT(google-explicit-constructor)
+        : PayloadBuffer(std::string_view{text ? text : ""})
+    {
+    }
+
+    PayloadBuffer(const std::string &text) // NOLINT(google-explicit-constructor)
+        : PayloadBuffer(std::string_view{text})
+    {
+    }
+
+    ~PayloadBuffer()
+    {
+        reset();
+    }
+
+    PayloadBuffer(const PayloadBuffer &other)
+        : m_block(other.m_block)
+    {
+        if (m_block)
+        {
+            PayloadPool::instance().retain(m_block);
+        }
+    }
+
+    PayloadBuffer &operator=(const PayloadBuffer &other)
+    {
+        if (this != &other)
+        {
+            PayloadBuffer copy{other};
+            std::swap(m_block, copy.m_block);
+        }
+        return *this;
+    }
+
+    PayloadBuffer(PayloadBuffer &&other) noexcept
+        : m_block(other.m_block)
+    {
+        other.m_block = nullptr;
+    }
+
+    PayloadBuffer &operator=(PayloadBuffer &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            m_block = other.m_block;
+            other.m_block = nullptr;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Writable buffer of at least @p capacity bytes, size 0
+     *
+     * @return Empty handle (capacity() == 0) if no block could be obtained
+     */
+    [[nodiscard]] static PayloadBuffer allocate(const std::size_t capacity)
+    {
+        PayloadBuffer buffer;
+        buffer.m_block = PayloadPool::instance().acquire(capacity);
+        if (buffer.m_block)
+        {
+            buffer.m_block->bytes()[0] = '\0';
+        }
+        return buffer;
+    }
+
+    /// Writable bytes; only valid before the handle is shared
+    [[nodiscard]] char *data()
+    {
+        return m_block ? m_block->bytes() : nullptr;
+    }
+
+    [[nodiscard]] const char *data() const
+    {
+        return m_block ? m_block->bytes() : nullptr;
+    }
+
+    [[nodiscard]] const char *c_str() const
+    {
+        return m_block ? m_block->bytes() : "";
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return m_block ? m_block->size : 0;
+    }
+
+    [[nodiscard]] std::size_t length() const
+    {
+        return size();
+    }
+
+    /// Usable bytes, excluding the NUL terminator
+    [[nodiscard]] std::size_t capacity() const
+    {
+        return m_block ? m_block->capacity : 0;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /// Set the written length (clamped to capacity) and terminate
+    void resize(const std::size_t size)
+    {
+        if (m_block)
+        {
+            m_block->size = static_cast<std::uint16_t>(size < m_block->capacity ? size : m_block->capacity);
+            m_block->bytes()[m_block->size] = '\0';
+        }
+    }
+
+    [[nodiscard]] std::string_view view() const
+    {
+        return {c_str(), size()};
+    }
+
+    operator std::string_view() const // NOLINT(google-explicit-constructor)
+    {
+        return view();
+    }
+
+    /// Drop this handle's reference
+    void reset()
+    {
+        if (m_block)
+        {
+            PayloadPool::instance().release(m_block);
+            m_block = nullptr;
+        }
+    }
+
+private:
+    void assign(const std::string_view text)
+    {
+        if (text.empty())
+        {
+            return;
+        }
+        *this = allocate(text.size());
+        if (m_block)
+        {
+            std::memcpy(m_block->bytes(), text.data(), text.size());
+            resize(text.size());
+        }
+    }
+
+    PayloadPool::Block *m_block{nullptr};
+};
+
+/**
+ * @brief Serialize an ArduinoJson document straight into a pooled buffer
+ *
+ * measureJson()/serializeJson() resolve by argument-dependent lookup, so this
+ * header does not need to pull in ArduinoJson.
+ *
+ * @return Serialized payload, empty if no buffer could be obtained
+ */
+template<typename TJson>
+[[nodiscard]] PayloadBuffer serializeJsonPayload(const TJson &json)
+{
+    auto payload{PayloadBuffer::allocate(measureJson(json))};
+    if (payload.capacity() > 0)
+    {
+        payload.resize(serializeJson(json, payload.data(), payload.capacity() + 1));
+    }
+    return payload;
+}
+} // namespace isic
+
+#endif // ISIC_COMMON_PAYLOAD_BUFFER_HPP
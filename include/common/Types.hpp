@@ -4,9 +4,13 @@
 #include <array>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <variant>
 
 #include "Config.hpp"
+#include "PayloadBuffer.hpp"
+
+class Print; // Arduino, for PayloadWriter
 
 namespace isic
 {
@@ -138,9 +142,11 @@ enum class EventType : std::uint8_t
     MqttConnected,
     MqttDisconnected,
     MqttError,
-    MqttMessage,
+    MqttMessage, // Not published by MqttService, inbound messages are delivered through TopicRouter
     MqttPublishRequest,
     MqttSubscribeRequest,
+    MqttPublished,     // Outcome of a MqttPublishRequest with confirm set
+    MqttPublishFailed,
 
     // NFC
     NfcReady,
@@ -166,6 +172,21 @@ enum class EventType : std::uint8_t
     _Count, // NOLINT (must be last)
 };
 
+/**
+ * @brief Dispatch priority class of an event (lower value runs first)
+ *
+ * Assigned per EventType in core/EventTraits.hpp.
+ */
+enum class EventPriority : std::uint8_t
+{
+    Critical, ///< User-facing: card taps and their feedback
+    High,     ///< Attendance, NFC and remote commands
+    Normal,   ///< Connectivity and outbound publishes
+    Low,      ///< Health, config and other housekeeping
+
+    _Count, // NOLINT (must be last)
+};
+
 enum class StatusCode : std::uint8_t
 {
     Ok,
@@ -202,7 +223,8 @@ inline constexpr const char *kWakeupReasonNames[]{"power_on", "timer", "external
 
 inline constexpr const char *kFeedbackSignalNames[]{"none", "success", "error", "processing", "connected", "disconnected", "ota_start", "ota_complete"};
 
-inline constexpr const char *kEventTypeNames[]{"none", "system_ready", "system_error", "config_changed", "config_error", "wifi_connected", "wifi_disconnected", "wifi_error", "wifi_ap_started", "wifi_ap_stopped", "wifi_ap_error", "wifi_ap_client", "mqtt_connected", "mqtt_disconnected", "mqtt_error", "mqtt_message", "mqtt_publish_req", "mqtt_subscribe_req", "nfc_ready", "card_scanned", "card_removed", "nfc_error", "attendance_recorded", "attendance_error", "ota_started", "ota_progress", "ota_completed", "ota_error", "feedback_request", "health_changed", "power_state_change", "sleep_requested", "wakeup_occurred"};
+inline constexpr const char *kEventTypeNames[]{"none", "system_ready", "system_error", "config_changed", "config_error", "wifi_connected", "wifi_disconnected", "wifi_ap_started", "wifi_ap_stopped", "wifi_ap_error", "wifi_ap_client", "mqtt_connected", "mqtt_disconnected", "mqtt_error", "mqtt_message", "mqtt_publish_req", "mqtt_subscribe_req", "mqtt_published", "mqtt_publish_failed", "nfc_ready", "card_scanned", "card_removed", "nfc_error", "attendance_recorded", "attendance_error", "feedback_request", "health_changed", "power_state_change", "sleep_requested", "wakeup_occurred"};
+static_assert(sizeof(kEventTypeNames) / sizeof(kEventTypeNames[0]) == static_cast<std::size_t>(EventType::_Count), "kEventTypeNames out of sync with EventType");
 
 inline constexpr const char *kStatusCodeNames[]{"ok", "error", "timeout", "not_ready", "invalid_arg", "no_memory", "not_found", "busy"};
 
@@ -296,11 +318,23 @@ struct CardEvent
 };
 static_assert(sizeof(CardEvent) == 12, "CardEvent size changed");
 
+/**
+ * @brief Streams a payload kept in another form (e.g. packed records) to @p out
+ *
+ * Called twice per publish: with @p out null to measure the length for the
+ * MQTT header, then with the client to write it.
+ *
+ * @return Bytes written, or that would be
+ */
+using PayloadWriter = std::size_t (*)(std::string_view source, Print *out);
+
 struct MqttEvent
 {
     std::string topic;
-    std::string payload;
+    PayloadBuffer payload; ///< Pooled and shared: copying the event never copies the bytes
     bool retain{false};
+    bool confirm{false}; ///< Answer with MqttPublished / MqttPublishFailed carrying the same payload
+    PayloadWriter writer{nullptr}; ///< Set: payload is only the writer's source, the writer's output goes on air
 };
 // No static_assert, size may vary due to std::string
 
@@ -331,7 +365,8 @@ struct Event
 
     Payload data{std::monostate{}};
     EventType type{EventType::None};
-    std::uint8_t priority{0};
+    EventPriority priority{EventPriority::Normal}; ///< Stamped by EventBus::publish() from the type traits
+    bool deliveredDirect{false};                   ///< Set by EventBus::publish() once Direct subscribers have run
 
     Event() = default;
     explicit Event(EventType t)
@@ -371,6 +406,7 @@ struct MqttMetrics
     std::uint32_t messagesPublished{0};
     std::uint32_t messagesFailed{0};
     std::uint32_t messagesReceived{0};
+    std::uint32_t messagesUnrouted{0}; ///< Outside the device prefix, too deep, or no matching route
     std::uint32_t reconnectCount{0};
 };
 
@@ -386,6 +422,8 @@ struct AttendanceMetrics
     std::uint32_t cardsDebounced{0};
     std::uint32_t batchesSent{0};
     std::uint32_t errorCount{0};
+    std::uint32_t offlineRecordsSent{0};
+    std::uint32_t offlineDrainRecordsPerSec{0}; ///< Throughput of the last backlog drained to empty
 };
 
 struct Pn532Metrics
@@ -394,6 +432,30 @@ struct Pn532Metrics
     std::uint32_t readErrors{0};
     std::uint32_t successfulReads{0};
     std::uint32_t recoveryAttempts{0};
+    std::uint32_t publishRetries{0}; ///< CardScanned refused by a full bus queue and retried
+    std::uint32_t cardsLost{0};      ///< Taps that could not be queued even after retrying
+};
+
+struct EventBusMetrics
+{
+    std::uint32_t eventsDispatched{0};
+    std::uint32_t budgetOverruns{0};   ///< Ticks that hit the budget with events still pending
+    std::uint32_t eventsCarriedOver{0}; ///< Pending events left by the last overrun
+    std::uint32_t maxDispatchUs{0};     ///< Longest single dispatch() call
+    std::uint32_t directDeliveries{0};  ///< Events handed to Direct subscribers inside publish()
+    std::uint32_t directFallbacks{0};   ///< Direct deliveries queued instead because ISIC_DIRECT_DEPTH_LIMIT was hit
+};
+
+struct EventTypeMetrics
+{
+    std::uint32_t published{0};
+    std::uint32_t dispatched{0};
+    std::uint32_t dropped{0};
+    std::uint32_t blocked{0};
+    std::uint32_t coalesced{0};
+    std::uint16_t maxQueueDepth{0};
+    std::uint32_t maxCallbackUs{0};   ///< Longest time spent in all subscribers of one event
+    std::uint64_t totalCallbackUs{0}; ///< Sum over all dispatched events, for the average
 };
 
 struct PowerMetrics
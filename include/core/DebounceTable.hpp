@@ -0,0 +1,285 @@
+#ifndef ISIC_CORE_DEBOUNCE_TABLE_HPP
+#define ISIC_CORE_DEBOUNCE_TABLE_HPP
+
+/**
+ * @file DebounceTable.hpp
+ * @brief Open-addressing hash set of recently seen card UIDs with time-based expiry
+ *
+ * Linear probing over a power-of-two slot array kept at most 75% full, so a
+ * lookup or insert touches a couple of slots whatever the capacity. Erasing
+ * shifts the rest of the cluster back instead of leaving tombstones, which
+ * keeps probe lengths short on a table that churns all day. Entries expire
+ * lazily: the ones met on a probe path are erased on the spot, and every
+ * call also sweeps a few slots behind a cursor, so stale cards leave without
+ * ever walking the whole table.
+ */
+
+#include "common/Types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+/// Upper bound on the configured debounce capacity (override with -DISIC_DEBOUNCE_MAX_CAPACITY=N)
+#ifndef ISIC_DEBOUNCE_MAX_CAPACITY
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ISIC_PLATFORM_ESP8266)
+#define ISIC_DEBOUNCE_MAX_CAPACITY 512
+#else
+#define ISIC_DEBOUNCE_MAX_CAPACITY 2048
+#endif
+#endif
+
+namespace isic
+{
+struct DebounceTableMetrics
+{
+    std::uint32_t evictions{0}; ///< Cards still inside the window dropped because the table was full
+    std::uint16_t entries{0};   ///< Cards currently remembered, expired ones not yet swept included
+    std::uint16_t peakEntries{0};
+};
+
+/**
+ * @class DebounceTable
+ * @brief Fixed-budget "seen within the last N ms" set keyed on CardUid
+ *
+ * The slot array is allocated once by reset() and never grows: 12 bytes per
+ * slot, 4/3 of the capacity rounded up to a power of two (4096 slots, 48 KB,
+ * for the 2048 maximum; 1024 slots, 12 KB, for the ESP8266's 512). When more
+ * distinct cards than the capacity are live at once, the stalest entry of the
+ * new card's cluster makes room.
+ *
+ * @par Thread Safety
+ * Main loop only (no locking).
+ */
+class DebounceTable
+{
+public:
+    static constexpr std::size_t kMaxCapacity{ISIC_DEBOUNCE_MAX_CAPACITY};
+
+    static_assert(kMaxCapacity > 0 && kMaxCapacity <= 0x8000, "ISIC_DEBOUNCE_MAX_CAPACITY out of range");
+
+    DebounceTable() = default;
+
+    DebounceTable(const DebounceTable &) = delete;
+    DebounceTable &operator=(const DebounceTable &) = delete;
+    DebounceTable(DebounceTable &&) = delete;
+    DebounceTable &operator=(DebounceTable &&) = delete;
+
+    /**
+     * @brief Forget every card and size the table for @p capacity live entries
+     *
+     * The new slot array is allocated before the old one is freed, without
+     * throwing: on a heap too fragmented for it the table is left as it was.
+     *
+     * @param capacity Clamped to [1, kMaxCapacity]
+     * @return false if the slot array could not be allocated
+     */
+    bool reset(std::size_t capacity)
+    {
+        capacity = capacity == 0 ? 1 : (capacity > kMaxCapacity ? kMaxCapacity : capacity);
+
+        std::size_t slots{4};
+        while (slots < capacity + capacity / 3)
+        {
+            slots <<= 1;
+        }
+
+        std::unique_ptr<Slot[]> fresh{new (std::nothrow) Slot[slots]};
+        if (!fresh)
+        {
+            return false;
+        }
+        m_slots = std::move(fresh);
+        m_slotCount = slots;
+        m_mask = slots - 1;
+        m_capacity = capacity;
+        m_sweepCursor = 0;
+        m_metrics = {};
+        return true;
+    }
+
+    /**
+     * @brief Record a tap and report whether it falls outside the window
+     *
+     * @param uid Card that was tapped
+     * @param nowMs Current millis()
+     * @param windowMs Debounce interval
+     * @return false if @p uid was admitted less than @p windowMs ago; true
+     *         otherwise, remembering the card from @p nowMs on
+     *
+     * @par Complexity
+     * O(1) expected
+     */
+    [[nodiscard]] bool admit(const CardUid &uid, const std::uint32_t nowMs, const std::uint32_t windowMs) noexcept
+    {
+        if (m_slotCount == 0)
+        {
+            return true;
+        }
+
+        sweep(nowMs, windowMs);
+
+        auto index{home(uid)};
+        while (m_slots[index].used)
+        {
+            auto &slot{m_slots[index]};
+            if (slot.uid == uid)
+            {
+                if (!isExpired(slot, nowMs, windowMs))
+                {
+                    return false;
+                }
+                slot.lastSeenMs = nowMs;
+                return true;
+            }
+            if (isExpired(slot, nowMs, windowMs))
+            {
+                // The shift may pull the card we are looking for into this slot: look again
+                erase(index);
+                continue;
+            }
+            index = (index + 1) & m_mask;
+        }
+
+        if (m_metrics.entries >= m_capacity)
+        {
+            evictStalest(uid, nowMs, windowMs);
+            index = home(uid);
+            while (m_slots[index].used)
+            {
+                index = (index + 1) & m_mask;
+            }
+        }
+
+        m_slots[index] = Slot{uid, true, nowMs};
+        ++m_metrics.entries;
+        if (m_metrics.entries > m_metrics.peakEntries)
+        {
+            m_metrics.peakEntries = m_metrics.entries;
+        }
+        return true;
+    }
+
+    void clear()
+    {
+        for (std::size_t i{0}; i < m_slotCount; ++i)
+        {
+            m_slots[i] = Slot{};
+        }
+        m_metrics.entries = 0;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    [[nodiscard]] std::size_t slotCount() const noexcept
+    {
+        return m_slotCount;
+    }
+
+    [[nodiscard]] const DebounceTableMetrics &getMetrics() const noexcept
+    {
+        return m_metrics;
+    }
+
+private:
+    /// Slots examined by the background sweep on every admit()
+    static constexpr std::size_t kSweepStep{4};
+
+    struct Slot
+    {
+        CardUid uid{};
+        bool used{false};
+        std::uint32_t lastSeenMs{0};
+    };
+
+    static bool isExpired(const Slot &slot, const std::uint32_t nowMs, const std::uint32_t windowMs) noexcept
+    {
+        return (nowMs - slot.lastSeenMs) >= windowMs;
+    }
+
+    /// FNV-1a over the UID bytes
+    [[nodiscard]] std::size_t home(const CardUid &uid) const noexcept
+    {
+        std::uint32_t hash{2166136261U};
+        for (const auto byte: uid)
+        {
+            hash = (hash ^ byte) * 16777619U;
+        }
+        return (hash ^ (hash >> 16)) & m_mask;
+    }
+
+    void sweep(const std::uint32_t nowMs, const std::uint32_t windowMs) noexcept
+    {
+        for (std::size_t step{0}; step < kSweepStep && m_metrics.entries != 0; ++step)
+        {
+            if (m_slots[m_sweepCursor].used && isExpired(m_slots[m_sweepCursor], nowMs, windowMs))
+            {
+                erase(m_sweepCursor); // Re-check the same slot next step: the shift may have refilled it
+            }
+            else
+            {
+                m_sweepCursor = (m_sweepCursor + 1) & m_mask;
+            }
+        }
+    }
+
+    /// Drop the oldest entry in the cluster @p uid hashes into, or in the next one if its home slot is free
+    void evictStalest(const CardUid &uid, const std::uint32_t nowMs, const std::uint32_t windowMs) noexcept
+    {
+        auto index{home(uid)};
+        while (!m_slots[index].used)
+        {
+            index = (index + 1) & m_mask;
+        }
+        auto stalest{index};
+        for (; m_slots[index].used; index = (index + 1) & m_mask)
+        {
+            if (static_cast<std::int32_t>(m_slots[stalest].lastSeenMs - m_slots[index].lastSeenMs) > 0)
+            {
+                stalest = index;
+            }
+        }
+        if (!isExpired(m_slots[stalest], nowMs, windowMs))
+        {
+            ++m_metrics.evictions;
+        }
+        erase(stalest);
+    }
+
+    /// Backward-shift deletion: pull later members of the cluster into the hole when their home allows it
+    void erase(std::size_t hole) noexcept
+    {
+        auto next{hole};
+        while (true)
+        {
+            next = (next + 1) & m_mask;
+            if (!m_slots[next].used)
+            {
+                break;
+            }
+            const auto wanted{home(m_slots[next].uid)};
+            const auto staysPut{hole <= next ? (hole < wanted && wanted <= next) : (hole < wanted || wanted <= next)};
+            if (!staysPut)
+            {
+                m_slots[hole] = m_slots[next];
+                hole = next;
+            }
+        }
+        m_slots[hole] = Slot{};
+        --m_metrics.entries;
+    }
+
+    std::unique_ptr<Slot[]> m_slots{};
+    std::size_t m_slotCount{0};
+    std::size_t m_mask{0};
+    std::size_t m_capacity{0};
+    std::size_t m_sweepCursor{0};
+    DebounceTableMetrics m_metrics{};
+};
+} // namespace isic
+
+#endif // ISIC_CORE_DEBOUNCE_TABLE_HPP
@@ -11,11 +11,24 @@
  */
 
 #include "common/Types.hpp"
-#include "core/Signal.hpp"
+#include "core/EventQueue.hpp"
+#include "core/EventTraits.hpp"
+#include "core/IService.hpp"
+#include "core/SlotList.hpp"
+#include "core/TimerWheel.hpp"
+#include "core/Trace.hpp"
+#include "platform/PlatformAtomic.hpp"
 
+#include <Arduino.h>
 #include <array>
+#include <limits>
 #include <utility>
 
+/// Events with a payload that can wait in publishAfter() at once (payload-less ones need no slot)
+#ifndef ISIC_DELAYED_EVENT_SLOTS
+#define ISIC_DELAYED_EVENT_SLOTS 4
+#endif
+
 namespace isic
 {
 /**
@@ -32,8 +45,59 @@ namespace isic
  * - dispatch(): Must be called from main loop only
  *
  * @par Memory Model
- * - Fixed-size signal array indexed by EventType (no dynamic allocation)
- * - Each signal maintains its own subscriber list and event queue
+ * - One subscriber list per EventType
+ * - Pending events share a single fixed-size pool (EventQueue, sized by
+ *   ISIC_EVENT_POOL_SIZE) threaded into per-type FIFOs - no allocation on publish
+ *
+ * @par Dispatch Order
+ * Pending events are delivered by priority class (see EventTraits.hpp),
+ * FIFO within a type. The highest-priority pending type is re-selected
+ * after every event, so a card scan published while a burst of metrics is
+ * draining is delivered next. dispatch() accepts an event/time budget;
+ * whatever does not fit stays queued for the next call.
+ *
+ * With setDispatchOrder(DispatchOrder::Publish) priorities are ignored and
+ * events of all types are delivered strictly in the order publish() linked
+ * them, e.g. an MqttDisconnected published before a MqttPublishRequest is
+ * always seen first.
+ *
+ * @par Timers
+ * The bus owns the system's TimerWheel: publishAfter()/publishEvery() queue
+ * an event at a deadline, callAfter()/callEvery() run a callback there.
+ * Expired timers run at the start of dispatch(), in the same context as
+ * subscribers, so a service can replace its millis() polling with a timer
+ * and drop its scheduler task. msUntilNextTimer() is the single deadline
+ * the loop (and PowerService) may sleep until.
+ *
+ * @par Idle Wakeup
+ * Every accepted publish() raises a wake flag (one relaxed store, ISR-safe).
+ * The owner polls it with takeWakeRequest() from the main loop and only
+ * runs dispatch() when there is work, so an idle system never ticks the
+ * bus. See App::loop().
+ *
+ * @par Tracing
+ * With ISIC_ENABLE_TRACE every publish (accepted or refused) and the begin
+ * and end of every delivery land in the trace ring (see Trace.hpp).
+ *
+ * @par Direct Connections
+ * A subscription made with ConnectionMode::Direct runs inline inside
+ * publish() instead of waiting for the next dispatch() tick - for the few
+ * latency-critical hops (card scan -> attendance -> feedback). Inline
+ * delivery only happens when publish() is called from the task that runs
+ * dispatch(), outside interrupts, and fewer than ISIC_DIRECT_DEPTH_LIMIT
+ * direct deliveries are already nested; otherwise the event is queued and
+ * dispatch() delivers it to the Direct subscribers as well, so nothing is
+ * lost. The event is queued before the inline call, so a refused publish
+ * (BlockWithError) never reaches a Direct subscriber and a retry cannot
+ * deliver twice. Queued subscribers of the same type still run from
+ * dispatch(). Keep Direct callbacks short: they run on the publisher's stack.
+ *
+ * @par Instrumentation
+ * Always on. Publish-side counters (published, dropped, blocked, coalesced,
+ * max queue depth) are bumped inside the queue's existing critical section;
+ * dispatch-side counters (dispatched, callback time) are main-loop only and
+ * cost one micros() read per event. Register the bus with HealthService to
+ * get everything on the metrics topic (see serializeMetrics()).
  *
  * @par Usage Example
  * @code
@@ -60,21 +124,37 @@ namespace isic
  * }
  * @endcode
  *
- * @see Signal for underlying queue implementation
+ * @see EventQueue for the pending-event pool
+ * @see SlotList for subscriber management
  * @see Event for event payload structure
  */
-class EventBus
+class EventBus : public IMetricsSource
 {
 public:
     static constexpr auto kTag{"EventBus"};
 
-    using SignalType = Signal<const Event &>;
-    using Connection = SignalType::Connection;
-    using ScopedConnection = SignalType::ScopedConnection;
-    using Callback = SignalType::Callback;
+    using Subscribers = SlotList<const Event &>;
+    using Connection = Subscribers::Connection;
+    using ScopedConnection = Subscribers::ScopedConnection;
+    using Callback = Subscribers::Callback;
+    using TimerId = TimerWheel::TimerId;
+    using TimerCallback = TimerWheel::Callback;
+
+    static constexpr TimerId kInvalidTimer{TimerWheel::kInvalidTimer};
+    static constexpr std::uint32_t kNoDeadline{TimerWheel::kNoDeadline};
+
+    /// How dispatch() picks the next event
+    enum class DispatchOrder : std::uint8_t
+    {
+        Priority, ///< Highest priority class first, FIFO within a type (default)
+        Publish,  ///< Global publish order across all types
+    };
+
+    /// Budget value meaning "no limit"
+    static constexpr std::size_t kUnlimitedEvents{std::numeric_limits<std::size_t>::max()};
 
     EventBus() = default;
-    ~EventBus() = default;
+    ~EventBus() override = default;
 
     EventBus(const EventBus &) = delete;
     EventBus &operator=(const EventBus &) = delete;
@@ -86,22 +166,24 @@ public:
      *
      * @param type Event type to subscribe to
      * @param callback Function to invoke when event is dispatched
+     * @param mode Queued (default): run from dispatch(); Direct: run inline
+     *        in publish() when safe (see class docs)
      * @return Connection handle for manual unsubscription, 0 if invalid type
      *
      * @note Prefer subscribeScoped() for automatic lifetime management
-     * @note Callback is NOT invoked immediately - only during dispatch()
+     * @note Callback is NOT invoked immediately - only on the next publish()
      * @warning Must be called from main context (not ISR-safe)
      *
      * @par Complexity
      * O(1) for subscription registration
      */
-    [[nodiscard]] Connection subscribe(const EventType type, Callback &&callback)
+    [[nodiscard]] Connection subscribe(const EventType type, Callback &&callback, const ConnectionMode mode = ConnectionMode::Queued)
     {
         if (type >= EventType::_Count)
         {
             return 0;
         }
-        return m_signals[static_cast<std::size_t>(type)].connect(std::move(callback));
+        return m_subscribers[static_cast<std::size_t>(type)].connect(std::move(callback), mode);
     }
 
     /**
@@ -113,18 +195,20 @@ public:
      *
      * @param type Event type to subscribe to
      * @param callback Function to invoke when event is dispatched
+     * @param mode Queued (default) or Direct, see subscribe()
      * @return ScopedConnection that unsubscribes on destruction
      *
      * @note Store the returned ScopedConnection as a class member
      * @warning Must be called from main context (not ISR-safe)
      */
-    [[nodiscard]] ScopedConnection subscribeScoped(const EventType type, Callback &&callback)
+    [[nodiscard]] ScopedConnection subscribeScoped(const EventType type, Callback &&callback,
+                                                   const ConnectionMode mode = ConnectionMode::Queued)
     {
         if (type >= EventType::_Count)
         {
             return {};
         }
-        return m_signals[static_cast<std::size_t>(type)].connectScoped(std::move(callback));
+        return m_subscribers[static_cast<std::size_t>(type)].connectScoped(std::move(callback), mode);
     }
 
     /**
@@ -143,24 +227,28 @@ public:
         {
             return;
         }
-        m_signals[static_cast<std::size_t>(type)].disconnect(connection);
+        m_subscribers[static_cast<std::size_t>(type)].disconnect(connection);
     }
 
     /**
      * @brief Queue an event for asynchronous delivery
      *
      * Adds the event to the internal queue for the event's type.
-     * Subscribers are NOT invoked immediately - events are delivered
-     * during the next dispatch() call.
+     * Queued subscribers are NOT invoked immediately - events are delivered
+     * during the next dispatch() call. Direct subscribers run before this
+     * returns when called from the dispatch task (see class docs).
      *
-     * @param event Event to publish (moved into queue)
-     * @return true if queued successfully, false if queue full or invalid type
+     * @param event Event to publish (moved into queue when accepted)
+     * @return true if queued, false if invalid type or refused by the type's
+     *         OverflowPolicy (see EventTraits.hpp). The event is left intact
+     *         when refused, so a BlockWithError publisher can retry it
      *
      * @note ISR-safe: can be called from interrupt handlers
      * @note Events are delivered in FIFO order per event type
+     * @note Overwrites event.priority with the priority of its type
      *
      * @par Complexity
-     * O(1) amortized for queue insertion
+     * O(1) amortized for queue insertion, plus the Direct callbacks if any
      */
     bool publish(Event &&event)
     {
@@ -168,7 +256,30 @@ public:
         {
             return false;
         }
-        return m_signals[static_cast<std::size_t>(event.type)].publish(std::move(event));
+        const auto type{static_cast<std::size_t>(event.type)};
+        event.priority = kEventTraitsTable[type].priority;
+        event.deliveredDirect = false;
+
+        if (!canDeliverDirect(type))
+        {
+            return queue(std::move(event));
+        }
+
+        // Queue first: a refused event must not reach Direct subscribers (the publisher may retry it)
+        Event direct{event};
+        event.deliveredDirect = true;
+        if (!queue(std::move(event)))
+        {
+            event.deliveredDirect = false;
+            return false;
+        }
+
+        const detail::DirectDepthScope depth{m_directDepth};
+        ++m_metrics.directDeliveries;
+        ISIC_TRACE_EVENT(DispatchBegin, type, trace::kFlagDirect);
+        m_subscribers[type].invokeDirect(direct);
+        ISIC_TRACE_EVENT(DispatchEnd, type, trace::kFlagDirect);
+        return true;
     }
 
     /**
@@ -193,30 +304,232 @@ public:
     }
 
     /**
-     * @brief Deliver all queued events to their subscribers
+     * @brief Publish an event once @p delayMs have passed
      *
-     * Processes all pending events across all event types, invoking
-     * registered callbacks for each. Events published during dispatch
-     * are queued for the next dispatch cycle.
+     * @param delayMs Delay in milliseconds (0 = on the next dispatch())
+     * @param event Event to publish; moved from only if the timer was armed
+     * @return Handle for cancelTimer(), kInvalidTimer if the type is invalid
+     *         or no timer / delayed-event slot is free
      *
+     * @note Payload events wait in one of ISIC_DELAYED_EVENT_SLOTS slots;
+     *       prefer publishAfter(ms, EventType) when there is no payload
+     * @warning Main loop only (not ISR-safe)
+     */
+    [[nodiscard]] TimerId publishAfter(const std::uint32_t delayMs, Event &&event)
+    {
+        if (event.type >= EventType::_Count)
+        {
+            return kInvalidTimer;
+        }
+        if (event.holds<std::monostate>())
+        {
+            return publishAfter(delayMs, event.type);
+        }
+
+        for (std::size_t slot{0}; slot < m_delayedEvents.size(); ++slot)
+        {
+            auto &delayed{m_delayedEvents[slot]};
+            if (delayed.timer != kInvalidTimer)
+            {
+                continue;
+            }
+            delayed.timer = m_timers.schedule(millis(), delayMs, 0, [this, slot]() {
+                auto &expired{m_delayedEvents[slot]};
+                expired.timer = kInvalidTimer;
+                publish(std::move(expired.event));
+                expired.event = Event{};
+            });
+            if (delayed.timer != kInvalidTimer)
+            {
+                delayed.event = std::move(event);
+            }
+            return delayed.timer;
+        }
+        return kInvalidTimer;
+    }
+
+    /// Publish a payload-less event once @p delayMs have passed (main loop only)
+    [[nodiscard]] TimerId publishAfter(const std::uint32_t delayMs, const EventType type)
+    {
+        if (type >= EventType::_Count)
+        {
+            return kInvalidTimer;
+        }
+        return m_timers.schedule(millis(), delayMs, 0, [this, type]() { publish(type); });
+    }
+
+    /// Publish a payload-less event every @p periodMs, first after one period (main loop only)
+    [[nodiscard]] TimerId publishEvery(const std::uint32_t periodMs, const EventType type)
+    {
+        if (type >= EventType::_Count || periodMs == 0)
+        {
+            return kInvalidTimer;
+        }
+        return m_timers.schedule(millis(), periodMs, periodMs, [this, type]() { publish(type); });
+    }
+
+    /**
+     * @brief Run @p callback once @p delayMs have passed
+     *
+     * @return Handle for cancelTimer(), kInvalidTimer if the pool is exhausted
+     *
+     * @note Runs from dispatch(), like a Queued subscriber
+     * @warning Main loop only (not ISR-safe)
+     */
+    [[nodiscard]] TimerId callAfter(const std::uint32_t delayMs, TimerCallback &&callback)
+    {
+        return m_timers.schedule(millis(), delayMs, 0, std::move(callback));
+    }
+
+    /// Run @p callback every @p periodMs, first after one period (main loop only)
+    [[nodiscard]] TimerId callEvery(const std::uint32_t periodMs, TimerCallback &&callback)
+    {
+        if (periodMs == 0)
+        {
+            return kInvalidTimer;
+        }
+        return m_timers.schedule(millis(), periodMs, periodMs, std::move(callback));
+    }
+
+    /**
+     * @brief Disarm a timer from any of the publishAfter()/callAfter() family
+     *
+     * @param id Handle, reset to kInvalidTimer; stale handles are ignored
+     * @return true if the timer was still armed
+     *
+     * @note Safe from inside timer callbacks, including the timer's own
+     */
+    bool cancelTimer(TimerId &id)
+    {
+        const auto cancelled{m_timers.cancel(id)};
+        for (auto &delayed: m_delayedEvents)
+        {
+            if (cancelled && delayed.timer == id)
+            {
+                delayed.timer = kInvalidTimer;
+                delayed.event = Event{};
+            }
+        }
+        id = kInvalidTimer;
+        return cancelled;
+    }
+
+    /// True while @p id waits for its deadline (false once its callback has started)
+    [[nodiscard]] bool isTimerArmed(const TimerId id) const
+    {
+        return m_timers.isArmed(id);
+    }
+
+    /**
+     * @brief Milliseconds until the next timer needs dispatch()
+     *
+     * @return 0 if due now, kNoDeadline if no timer is armed. Never later
+     *         than the earliest deadline (see TimerWheel::msUntilNext())
+     */
+    [[nodiscard]] std::uint32_t msUntilNextTimer() const
+    {
+        return m_timers.msUntilNext(millis());
+    }
+
+    /**
+     * @brief Deliver queued events to their subscribers (priority or publish order)
+     *
+     * Runs expired timers first, then repeatedly takes the oldest event of
+     * the highest-priority type that has anything pending, so events
+     * published by callbacks are picked up in the same call if they outrank
+     * what is left. Stops when the queue is empty or the budget is spent;
+     * the remainder is carried over to the next call and counted as a budget
+     * overrun. In DispatchOrder::Publish mode the oldest pending event of any
+     * type is taken instead.
+     *
+     * @param maxEvents Maximum events to deliver in this call
+     * @param maxDurationUs Time budget in microseconds, 0 for none. Checked
+     *        between events, so at least one event is always delivered
      * @return Total number of events dispatched
      *
      * @warning Must be called from main loop (not ISR-safe)
      * @warning Callbacks may throw - exceptions propagate to caller
      *
      * @par Complexity
-     * O(E * S) where E = pending events, S = avg subscribers per type
+     * O(E * (P + S)) where E = delivered events, P = priority classes,
+     * S = avg subscribers per type
      */
-    std::size_t dispatch()
+    std::size_t dispatch(const std::size_t maxEvents = kUnlimitedEvents, const std::uint32_t maxDurationUs = 0)
     {
+        m_dispatchTaskId.store(currentTaskId(), std::memory_order_relaxed);
+        m_timers.advance(millis());
+
+        const auto startUs{micros()};
+        auto nowUs{startUs};
         std::size_t totalDispatched{0};
-        for (auto &signal: m_signals)
+
+        while (m_queue.pendingMask() != 0)
         {
-            totalDispatched += signal.dispatch();
+            const bool outOfTime{maxDurationUs != 0 && totalDispatched > 0 && (nowUs - startUs) >= maxDurationUs};
+            if (totalDispatched >= maxEvents || outOfTime)
+            {
+                ++m_metrics.budgetOverruns;
+                m_metrics.eventsCarriedOver = static_cast<std::uint32_t>(m_queue.pendingCount());
+                break;
+            }
+
+            // A publisher may have evicted the last node of the chosen type since the mask was read
+            const auto index{popNext()};
+            if (index == EventQueue::kInvalidIndex)
+            {
+                continue;
+            }
+
+            // Delivered straight from the pool node, no copy out
+            const NodeRelease release{m_queue, index};
+            const auto &event{m_queue.event(index)};
+            const auto type{static_cast<std::size_t>(event.type)};
+            ISIC_TRACE_EVENT(DispatchBegin, type, 0);
+            if (event.deliveredDirect)
+            {
+                m_subscribers[type].invokeQueued(event);
+            }
+            else
+            {
+                m_subscribers[type].invoke(event);
+            }
+            ISIC_TRACE_EVENT(DispatchEnd, type, 0);
+
+            // One clock read per event: it closes this callback window and feeds the next budget check
+            const auto callbackEndUs{micros()};
+            recordDispatch(type, callbackEndUs - nowUs);
+            nowUs = callbackEndUs;
+            ++totalDispatched;
+        }
+
+        const auto elapsedUs{nowUs - startUs};
+        m_metrics.eventsDispatched += static_cast<std::uint32_t>(totalDispatched);
+        if (elapsedUs > m_metrics.maxDispatchUs)
+        {
+            m_metrics.maxDispatchUs = elapsedUs;
         }
         return totalDispatched;
     }
 
+    /**
+     * @brief Consume the wake flag raised by publish()
+     *
+     * @return true if an event was queued since the last call
+     *
+     * @note Main loop only. Clear-then-dispatch ordering means an event
+     *       whose flag is consumed here is already queued for the dispatch()
+     *       that follows, so no wakeup is lost
+     */
+    [[nodiscard]] bool takeWakeRequest()
+    {
+        if (!m_wakeRequested.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        m_wakeRequested.store(false, std::memory_order_relaxed);
+        return true;
+    }
+
     /**
      * @brief Get count of events awaiting dispatch
      *
@@ -227,16 +540,253 @@ public:
      */
     [[nodiscard]] std::size_t pendingCount() const
     {
-        std::size_t total{0};
-        for (const auto &signal: m_signals)
+        return m_queue.pendingCount();
+    }
+
+    /**
+     * @brief Select how dispatch() orders events
+     *
+     * @param order Priority (default) or global publish order
+     *
+     * @note Takes effect on the next event; already queued events keep
+     *       their publish order, so switching is always safe
+     */
+    void setDispatchOrder(const DispatchOrder order) noexcept
+    {
+        m_dispatchOrder = order;
+    }
+
+    [[nodiscard]] DispatchOrder getDispatchOrder() const noexcept
+    {
+        return m_dispatchOrder;
+    }
+
+    /// Events of a type lost to its overflow policy since boot
+    [[nodiscard]] std::uint32_t droppedCount(const EventType type) const
+    {
+        return type < EventType::_Count ? m_queue.droppedCount(static_cast<std::size_t>(type)) : 0;
+    }
+
+    /// Events of a type superseded by a newer one before dispatch (CoalesceLatest)
+    [[nodiscard]] std::uint32_t coalescedCount(const EventType type) const
+    {
+        return type < EventType::_Count ? m_queue.coalescedCount(static_cast<std::size_t>(type)) : 0;
+    }
+
+    /// Publishes of a BlockWithError type refused because its queue was full
+    [[nodiscard]] std::uint32_t blockedCount(const EventType type) const
+    {
+        return type < EventType::_Count ? m_queue.blockedCount(static_cast<std::size_t>(type)) : 0;
+    }
+
+    /// Dispatch statistics (main loop only)
+    [[nodiscard]] const EventBusMetrics &getMetrics() const noexcept
+    {
+        return m_metrics;
+    }
+
+    /**
+     * @brief Counters of one event type since boot
+     *
+     * @param type Event type
+     * @return Publish-side counters (consistent snapshot) merged with the
+     *         dispatch-side ones; all zero for an invalid type
+     *
+     * @note Call from the main loop, dispatch-side counters are not locked
+     */
+    [[nodiscard]] EventTypeMetrics getTypeMetrics(const EventType type) const
+    {
+        if (type >= EventType::_Count)
+        {
+            return {};
+        }
+        const auto index{static_cast<std::size_t>(type)};
+        const auto counters{m_queue.counters(index)};
+        const auto &stats{m_dispatchStats[index]};
+        return {.published = counters.published,
+                .dispatched = stats.dispatched,
+                .dropped = counters.dropped,
+                .blocked = counters.blocked,
+                .coalesced = counters.coalesced,
+                .maxQueueDepth = counters.maxDepth,
+                .maxCallbackUs = stats.maxCallbackUs,
+                .totalCallbackUs = stats.totalCallbackUs};
+    }
+
+    [[nodiscard]] const char *getName() const override
+    {
+        return kTag;
+    }
+
+    /**
+     * @brief Bus totals plus a per-type breakdown for the metrics topic
+     *
+     * Only types that have seen traffic are listed, and drop/block/coalesce
+     * counters only when non-zero, to keep the payload small.
+     */
+    void serializeMetrics(JsonObject &obj) const override
+    {
+        obj["dispatched"] = m_metrics.eventsDispatched;
+        obj["pending"] = pendingCount();
+        obj["budget_overruns"] = m_metrics.budgetOverruns;
+        obj["carried_over"] = m_metrics.eventsCarriedOver;
+        obj["max_dispatch_us"] = m_metrics.maxDispatchUs;
+        obj["direct"] = m_metrics.directDeliveries;
+        obj["direct_fallbacks"] = m_metrics.directFallbacks;
+
+        const auto &timers{m_timers.getMetrics()};
+        auto timersObj{obj["timers"].to<JsonObject>()};
+        timersObj["active"] = timers.active;
+        timersObj["peak"] = timers.peakActive;
+        timersObj["fired"] = timers.fired;
+        if (timers.rejected > 0)
+        {
+            timersObj["rejected"] = timers.rejected;
+        }
+
+        auto typesObj{obj["types"].to<JsonObject>()};
+        for (std::size_t i{0}; i < EventQueue::kTypeCount; ++i)
         {
-            total += signal.pendingCount();
+            const auto type{static_cast<EventType>(i)};
+            const auto metrics{getTypeMetrics(type)};
+            if (metrics.published == 0 && metrics.dropped == 0 && metrics.blocked == 0)
+            {
+                continue;
+            }
+
+            auto typeObj{typesObj[toString(type)].to<JsonObject>()};
+            typeObj["pub"] = metrics.published;
+            typeObj["disp"] = metrics.dispatched;
+            typeObj["depth"] = metrics.maxQueueDepth;
+            typeObj["max_us"] = metrics.maxCallbackUs;
+            typeObj["avg_us"] = metrics.dispatched > 0 ? static_cast<std::uint32_t>(metrics.totalCallbackUs / metrics.dispatched) : 0;
+            if (metrics.dropped > 0)
+            {
+                typeObj["drop"] = metrics.dropped;
+            }
+            if (metrics.blocked > 0)
+            {
+                typeObj["blocked"] = metrics.blocked;
+            }
+            if (metrics.coalesced > 0)
+            {
+                typeObj["coalesced"] = metrics.coalesced;
+            }
         }
-        return total;
     }
 
 private:
-    std::array<SignalType, static_cast<std::size_t>(EventType::_Count)> m_signals;
+    static constexpr std::size_t kNoPendingType{EventQueue::kTypeCount};
+
+    /// Payload event waiting for its publishAfter() timer
+    struct DelayedEvent
+    {
+        Event event{};
+        TimerId timer{kInvalidTimer};
+    };
+
+    /// Dispatch-side counters of one type (main loop only, no locking)
+    struct DispatchStats
+    {
+        std::uint32_t dispatched{0};
+        std::uint32_t maxCallbackUs{0};
+        std::uint64_t totalCallbackUs{0};
+    };
+
+    void recordDispatch(const std::size_t type, const std::uint32_t callbackUs)
+    {
+        auto &stats{m_dispatchStats[type]};
+        ++stats.dispatched;
+        stats.totalCallbackUs += callbackUs;
+        if (callbackUs > stats.maxCallbackUs)
+        {
+            stats.maxCallbackUs = callbackUs;
+        }
+    }
+
+    /**
+     * @brief Whether publish() may run the Direct subscribers of @p type inline
+     *
+     * Only on the task that runs dispatch() (the subscribers' home context,
+     * unknown until the first dispatch()), never from an ISR, and only up to
+     * ISIC_DIRECT_DEPTH_LIMIT nested direct deliveries.
+     */
+    [[nodiscard]] bool canDeliverDirect(const std::size_t type)
+    {
+        if (!m_subscribers[type].hasDirect() || inInterruptContext() ||
+            currentTaskId() != m_dispatchTaskId.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+        if (m_directDepth >= ISIC_DIRECT_DEPTH_LIMIT)
+        {
+            ++m_metrics.directFallbacks;
+            return false;
+        }
+        return true;
+    }
+
+    bool queue(Event &&event)
+    {
+        [[maybe_unused]] const auto type{event.type};
+        if (!m_queue.push(std::move(event)))
+        {
+            ISIC_TRACE_EVENT(Publish, type, trace::kFlagRefused);
+            return false;
+        }
+        ISIC_TRACE_EVENT(Publish, type, 0);
+        m_wakeRequested.store(true, std::memory_order_release);
+        return true;
+    }
+
+    /// Detach the next event according to the dispatch order
+    [[nodiscard]] EventQueue::Index popNext()
+    {
+        if (m_dispatchOrder == DispatchOrder::Publish)
+        {
+            return m_queue.popOldest();
+        }
+
+        const auto type{nextPendingType()};
+        return type == kNoPendingType ? EventQueue::kInvalidIndex : m_queue.popFront(type);
+    }
+
+    /// Lowest-numbered pending type of the highest non-empty priority class
+    [[nodiscard]] std::size_t nextPendingType() const
+    {
+        const auto pending{m_queue.pendingMask()};
+        for (const auto priorityMask: kEventPriorityMasks)
+        {
+            if (const auto candidates{pending & priorityMask}; candidates != 0)
+            {
+                return static_cast<std::size_t>(__builtin_ctz(candidates));
+            }
+        }
+        return kNoPendingType;
+    }
+
+    /// Returns a dispatched node to the pool even if a callback throws (ESP32 builds with exceptions)
+    struct NodeRelease
+    {
+        EventQueue &queue;
+        EventQueue::Index index;
+
+        ~NodeRelease()
+        {
+            queue.release(index);
+        }
+    };
+
+    std::array<Subscribers, EventQueue::kTypeCount> m_subscribers;
+    EventQueue m_queue;
+    EventBusMetrics m_metrics{};
+    std::array<DispatchStats, EventQueue::kTypeCount> m_dispatchStats{};
+    DispatchOrder m_dispatchOrder{DispatchOrder::Priority};
+    std::atomic<std::uintptr_t> m_dispatchTaskId{0}; ///< currentTaskId() of the last dispatch(), 0 before the first
+    std::uint8_t m_directDepth{0};                   ///< Nested direct deliveries (dispatch task only)
+    std::atomic<bool> m_wakeRequested{false};        ///< Raised by publish(), consumed by takeWakeRequest()
+    TimerWheel m_timers;
+    std::array<DelayedEvent, ISIC_DELAYED_EVENT_SLOTS> m_delayedEvents{};
 };
 } // namespace isic
 
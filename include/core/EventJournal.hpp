@@ -0,0 +1,452 @@
+#ifndef ISIC_CORE_EVENT_JOURNAL_HPP
+#define ISIC_CORE_EVENT_JOURNAL_HPP
+
+/**
+ * @file EventJournal.hpp
+ * @brief Line format for recorded EventBus traffic, and its replayer
+ *
+ * A journal captures what reaches the services from outside - card taps,
+ * WiFi/MQTT flaps, inbound MQTT messages such as config pushes - so the
+ * same stream can be fed back into a host build of the services. One entry
+ * per line, fields separated by single spaces:
+ *
+ *   E <millis> <event_name> <payload tag> <payload hex>   bus event
+ *   M <millis> <relative topic> <payload hex>             inbound MQTT message
+ *
+ * <millis> is the device's millis() when the entry was taken. Payload tags
+ * are '-' (none), 'C' CardEvent, 'M' MqttEvent, 'F' FeedbackEvent and 'P'
+ * PowerEvent; their fields are hex-encoded little-endian, so a replayed
+ * event is bit-for-bit the recorded one. Events are named (toString()),
+ * not numbered, so journals survive EventType reordering. Lines are plain
+ * text: a journal on LittleFS can be pulled with esp_fs_inspector.py read.
+ *
+ * Written on the device by utils/EventJournalRecorder.hpp.
+ */
+
+#include "common/Types.hpp"
+#include "core/EventBus.hpp"
+#include "core/TopicRouter.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace isic::journal
+{
+inline constexpr char kEventEntry{'E'};
+inline constexpr char kInboundEntry{'M'};
+
+/// One parsed journal line
+struct Entry
+{
+    char kind{kEventEntry};
+    std::uint32_t timeMs{0};
+    Event event{};                ///< kEventEntry only
+    std::string topic{};          ///< kInboundEntry only
+    std::string payload{};        ///< kInboundEntry only
+};
+
+namespace detail
+{
+inline constexpr const char *kHexDigits{"0123456789abcdef"};
+
+inline void appendHex(std::string &out, const void *data, const std::size_t size)
+{
+    const auto *bytes{static_cast<const std::uint8_t *>(data)};
+    for (std::size_t i{0}; i < size; ++i)
+    {
+        out += kHexDigits[bytes[i] >> 4];
+        out += kHexDigits[bytes[i] & 0x0F];
+    }
+}
+
+template<typename T>
+void appendLe(std::string &out, T value)
+{
+    for (std::size_t i{0}; i < sizeof(T); ++i)
+    {
+        out += kHexDigits[(value >> (8 * i + 4)) & 0x0F];
+        out += kHexDigits[(value >> (8 * i)) & 0x0F];
+    }
+}
+
+inline int hexValue(const char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/// Decodes a hex field front to back
+class HexReader
+{
+public:
+    explicit HexReader(const std::string_view hex)
+        : m_hex(hex)
+    {
+    }
+
+    bool bytes(void *out, const std::size_t size)
+    {
+        if (m_hex.size() < size * 2)
+        {
+            return false;
+        }
+        auto *bytes{static_cast<std::uint8_t *>(out)};
+        for (std::size_t i{0}; i < size; ++i)
+        {
+            const auto high{hexValue(m_hex[2 * i])};
+            const auto low{hexValue(m_hex[2 * i + 1])};
+            if (high < 0 || low < 0)
+            {
+                return false;
+            }
+            bytes[i] = static_cast<std::uint8_t>((high << 4) | low);
+        }
+        m_hex.remove_prefix(size * 2);
+        return true;
+    }
+
+    template<typename T>
+    bool le(T &value)
+    {
+        std::uint8_t raw[sizeof(T)]{};
+        if (!bytes(raw, sizeof(T)))
+        {
+            return false;
+        }
+        value = 0;
+        for (std::size_t i{sizeof(T)}; i-- > 0;)
+        {
+            value = static_cast<T>((value << 8) | raw[i]);
+        }
+        return true;
+    }
+
+    bool rest(std::string &out)
+    {
+        out.resize(m_hex.size() / 2);
+        return (m_hex.size() % 2) == 0 && bytes(out.data(), out.size());
+    }
+
+    [[nodiscard]] bool done() const
+    {
+        return m_hex.empty();
+    }
+
+private:
+    std::string_view m_hex;
+};
+
+/// Next space-separated field of @p line, consumed
+inline std::string_view nextField(std::string_view &line)
+{
+    const auto end{line.find(' ')};
+    const auto field{line.substr(0, end)};
+    line.remove_prefix(end == std::string_view::npos ? line.size() : end + 1);
+    return field;
+}
+
+inline bool parseUint(const std::string_view text, std::uint32_t &value)
+{
+    if (text.empty() || text.size() > 10)
+    {
+        return false;
+    }
+    std::uint64_t result{0};
+    for (const auto c: text)
+    {
+        if (c < '0' || c > '9')
+        {
+            return false;
+        }
+        result = result * 10 + static_cast<std::uint64_t>(c - '0');
+    }
+    value = static_cast<std::uint32_t>(result);
+    return result <= UINT32_MAX;
+}
+
+inline bool parsePayload(const char tag, HexReader hex, Event::Payload &data)
+{
+    switch (tag)
+    {
+        case '-': {
+            data = std::monostate{};
+            return hex.done();
+        }
+        case 'C': {
+            CardEvent card{};
+            if (!hex.le(card.timestampMs) || !hex.bytes(card.uid.data(), card.uid.size()))
+            {
+                return false;
+            }
+            data = card;
+            return hex.done();
+        }
+        case 'M': {
+            MqttEvent mqtt{};
+            std::uint8_t retain{0};
+            std::uint16_t topicLength{0};
+            std::string bytes;
+            if (!hex.le(retain) || !hex.le(topicLength) || !hex.rest(bytes) || bytes.size() < topicLength)
+            {
+                return false;
+            }
+            mqtt.retain = retain != 0;
+            mqtt.topic = bytes.substr(0, topicLength);
+            mqtt.payload = std::string_view{bytes}.substr(topicLength);
+            data = std::move(mqtt);
+            return true;
+        }
+        case 'F': {
+            FeedbackEvent feedback{};
+            if (!hex.bytes(&feedback.signal, 1) || !hex.le(feedback.repeatCount))
+            {
+                return false;
+            }
+            data = feedback;
+            return hex.done();
+        }
+        case 'P': {
+            PowerEvent power{};
+            if (!hex.le(power.durationMs) || !hex.bytes(&power.targetState, 1) || !hex.bytes(&power.previousState, 1) ||
+                !hex.bytes(&power.wakeupReason, 1))
+            {
+                return false;
+            }
+            data = power;
+            return hex.done();
+        }
+        default: {
+            return false;
+        }
+    }
+}
+} // namespace detail
+
+/// Append the journal line (with '\n') for @p event, taken at @p timeMs
+inline void appendEvent(std::string &out, const std::uint32_t timeMs, const Event &event)
+{
+    out += kEventEntry;
+    out += ' ';
+    out += std::to_string(timeMs);
+    out += ' ';
+    out += toString(event.type);
+    out += ' ';
+
+    if (const auto *card{event.get<CardEvent>()})
+    {
+        out += "C ";
+        detail::appendLe(out, card->timestampMs);
+        detail::appendHex(out, card->uid.data(), card->uid.size());
+    }
+    else if (const auto *mqtt{event.get<MqttEvent>()})
+    {
+        out += "M ";
+        detail::appendLe(out, static_cast<std::uint8_t>(mqtt->retain));
+        detail::appendLe(out, static_cast<std::uint16_t>(mqtt->topic.size()));
+        detail::appendHex(out, mqtt->topic.data(), mqtt->topic.size());
+        detail::appendHex(out, mqtt->payload.data(), mqtt->payload.size());
+    }
+    else if (const auto *feedback{event.get<FeedbackEvent>()})
+    {
+        out += "F ";
+        detail::appendLe(out, static_cast<std::uint8_t>(feedback->signal));
+        detail::appendLe(out, feedback->repeatCount);
+    }
+    else if (const auto *power{event.get<PowerEvent>()})
+    {
+        out += "P ";
+        detail::appendLe(out, power->durationMs);
+        detail::appendLe(out, static_cast<std::uint8_t>(power->targetState));
+        detail::appendLe(out, static_cast<std::uint8_t>(power->previousState));
+        detail::appendLe(out, static_cast<std::uint8_t>(power->wakeupReason));
+    }
+    else
+    {
+        out += '-';
+    }
+    out += '\n';
+}
+
+/**
+ * @brief Append the journal line (with '\n') for an inbound MQTT message
+ *
+ * @return false (nothing appended) if the topic is empty or contains a
+ *         space or line break, which the line format cannot carry
+ */
+inline bool appendInbound(std::string &out, const std::uint32_t timeMs, const std::string_view topic, const std::string_view payload)
+{
+    if (topic.empty() || topic.find_first_of(" \r\n") != std::string_view::npos)
+    {
+        return false;
+    }
+    out += kInboundEntry;
+    out += ' ';
+    out += std::to_string(timeMs);
+    out += ' ';
+    out.append(topic.data(), topic.size());
+    out += ' ';
+    detail::appendHex(out, payload.data(), payload.size());
+    out += '\n';
+    return true;
+}
+
+/**
+ * @brief Parse one journal line (without its '\n')
+ *
+ * @return false for blank, malformed or unknown-event lines
+ */
+inline bool parseLine(std::string_view line, Entry &entry)
+{
+    if (!line.empty() && line.back() == '\r')
+    {
+        line.remove_suffix(1);
+    }
+
+    const auto kind{detail::nextField(line)};
+    if (kind.size() != 1 || !detail::parseUint(detail::nextField(line), entry.timeMs))
+    {
+        return false;
+    }
+    entry.kind = kind[0];
+
+    if (entry.kind == kInboundEntry)
+    {
+        const auto topic{detail::nextField(line)};
+        entry.topic.assign(topic.data(), topic.size());
+        return !topic.empty() && detail::HexReader{line}.rest(entry.payload);
+    }
+    if (entry.kind != kEventEntry)
+    {
+        return false;
+    }
+
+    const auto name{detail::nextField(line)};
+    const auto tag{detail::nextField(line)};
+    if (tag.size() != 1)
+    {
+        return false;
+    }
+    for (std::size_t type{0}; type < static_cast<std::size_t>(EventType::_Count); ++type)
+    {
+        if (name == toString(static_cast<EventType>(type)))
+        {
+            entry.event = Event{};
+            entry.event.type = static_cast<EventType>(type);
+            return detail::parsePayload(tag[0], detail::HexReader{line}, entry.event.data);
+        }
+    }
+    return false;
+}
+
+struct ReplayStats
+{
+    std::uint32_t events{0};
+    std::uint32_t inbound{0};
+    std::uint32_t refused{0};   ///< Events the bus did not accept
+    std::uint32_t unrouted{0};  ///< Inbound messages no route matched
+    std::uint32_t malformed{0}; ///< Lines that did not parse
+    std::uint32_t firstMs{0};
+    std::uint32_t lastMs{0};
+};
+
+/**
+ * @class Replayer
+ * @brief Feeds journal lines back into a bus and router on a virtual clock
+ *
+ * The caller owns time: before each entry it is asked to advance its clock
+ * to the recorded millis() and run whatever the services would have run
+ * until then (scheduler tasks, dispatch, timers). With a virtual millis()
+ * that jump is instant, so hours of recorded traffic replay in seconds and
+ * every run sees the same sequence.
+ *
+ * @par Usage
+ * @code
+ * journal::Replayer replayer{bus, router};
+ * while (std::getline(file, line))
+ * {
+ *     replayer.replay(line, [&](std::uint32_t ms) { host.runUntil(ms); });
+ * }
+ * @endcode
+ */
+class Replayer
+{
+public:
+    Replayer(EventBus &bus, const TopicRouter &router)
+        : m_bus(bus)
+        , m_router(router)
+    {
+    }
+
+    /**
+     * @brief Inject one journal line
+     *
+     * @param line Journal line, without '\n'
+     * @param advanceTo Called with the entry's millis() before it is injected
+     * @return false if the line was malformed (skipped, counted)
+     */
+    template<typename AdvanceFn>
+    bool replay(const std::string_view line, AdvanceFn &&advanceTo)
+    {
+        if (line.empty())
+        {
+            return true;
+        }
+        if (!parseLine(line, m_entry))
+        {
+            ++m_stats.malformed;
+            return false;
+        }
+
+        if (m_stats.events + m_stats.inbound == 0)
+        {
+            m_stats.firstMs = m_entry.timeMs;
+        }
+        m_stats.lastMs = m_entry.timeMs;
+        advanceTo(m_entry.timeMs);
+
+        if (m_entry.kind == kInboundEntry)
+        {
+            ++m_stats.inbound;
+            TopicView topic;
+            if (!topic.assign(m_entry.topic) || m_router.route(topic, m_entry.payload) == 0)
+            {
+                ++m_stats.unrouted;
+            }
+            return true;
+        }
+
+        ++m_stats.events;
+        if (!m_bus.publish(std::move(m_entry.event)))
+        {
+            ++m_stats.refused;
+        }
+        return true;
+    }
+
+    [[nodiscard]] const ReplayStats &getStats() const
+    {
+        return m_stats;
+    }
+
+private:
+    EventBus &m_bus;
+    const TopicRouter &m_router;
+    Entry m_entry{};
+    ReplayStats m_stats{};
+};
+} // namespace isic::journal
+
+#endif // ISIC_CORE_EVENT_JOURNAL_HPP
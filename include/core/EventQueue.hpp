@@ -0,0 +1,431 @@
+#ifndef ISIC_CORE_EVENT_QUEUE_HPP
+#define ISIC_CORE_EVENT_QUEUE_HPP
+
+/**
+ * @file EventQueue.hpp
+ * @brief Shared fixed-size event pool with per-type intrusive FIFOs
+ *
+ * All pending events of every EventType live in one statically sized node
+ * pool. Each type keeps only a head/tail/count triple into that pool, so
+ * total capacity is global and set at build time instead of multiplying a
+ * per-type ring by the number of event types.
+ */
+
+#include "common/Types.hpp"
+#include "core/EventTraits.hpp"
+#include "platform/PlatformAtomic.hpp"
+#include "platform/PlatformMutex.hpp"
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+/// Total pending events across all types (override with -DISIC_EVENT_POOL_SIZE=N)
+#ifndef ISIC_EVENT_POOL_SIZE
+#define ISIC_EVENT_POOL_SIZE 32
+#endif
+
+namespace isic
+{
+
+/**
+ * @class EventQueue
+ * @brief Pool-backed multi-producer, single-consumer event queue
+ *
+ * @par Thread Safety
+ * - push(): Safe from any context including ISR
+ * - popFront()/release()/event(): Main loop only (single consumer)
+ *
+ * @par Memory Model
+ * Nodes are taken from a free list and linked into the FIFO of their type.
+ * The CriticalSection covers only index updates; the Event payload is moved
+ * into a claimed node before it is linked and reset after it is released,
+ * both outside the critical section.
+ *
+ * @par Publish Order
+ * Besides its type FIFO, every linked node is also threaded into one
+ * doubly linked list in link order. popOldest() takes its head, which is by
+ * construction also the head of its type FIFO, so global publish-order
+ * delivery is O(1) per event. Eviction unlinks from the middle in O(1).
+ *
+ * @par Overflow Policy
+ * Each type may hold at most EventTraits::capacity pending events. The last
+ * kCriticalReserve free nodes are kept for EventPriority::Critical types so
+ * that a flood of housekeeping events cannot lock out card scans. When a
+ * push hits either limit the type's OverflowPolicy decides; an evicted or
+ * replaced node is reused directly for the new event. Every lost event is
+ * counted per type (droppedCount()); BlockWithError refusals are counted
+ * separately (blockedCount()) because the publisher still holds the event.
+ *
+ * @par Coalescing
+ * A CoalesceLatest type whose pending slot is taken - by its own type or by
+ * its coalesceWith partner - steals that node for the new event without
+ * going through the free list. Counted in coalescedCount(), not as a drop.
+ */
+class EventQueue
+{
+public:
+    using Index = std::uint16_t;
+
+    static constexpr std::size_t kCapacity{ISIC_EVENT_POOL_SIZE};
+    static constexpr std::size_t kTypeCount{static_cast<std::size_t>(EventType::_Count)};
+    static constexpr Index kInvalidIndex{0xFFFF};
+
+    /// Free nodes only Critical-priority types may take
+    static constexpr std::size_t kCriticalReserve{4};
+
+    static_assert(kCapacity > kCriticalReserve && kCapacity < kInvalidIndex, "ISIC_EVENT_POOL_SIZE out of range");
+    static_assert(kTypeCount <= 32, "pending mask holds one bit per EventType");
+
+    /// Publish-side counters of one type since boot, updated under the CriticalSection
+    struct TypeCounters
+    {
+        std::uint32_t published{0}; ///< Accepted by push(), including events that later got coalesced
+        std::uint32_t dropped{0};
+        std::uint32_t blocked{0};
+        std::uint32_t coalesced{0};
+        std::uint16_t maxDepth{0}; ///< Highest pending count of the type
+    };
+
+    EventQueue()
+    {
+        for (std::size_t i{0}; i < kCapacity; ++i)
+        {
+            m_nodes[i].next = static_cast<Index>(i + 1 < kCapacity ? i + 1 : kInvalidIndex);
+        }
+        m_freeHead = 0;
+        m_freeCount = static_cast<Index>(kCapacity);
+    }
+
+    ~EventQueue() = default;
+
+    EventQueue(const EventQueue &) = delete;
+    EventQueue &operator=(const EventQueue &) = delete;
+    EventQueue(EventQueue &&) = delete;
+    EventQueue &operator=(EventQueue &&) = delete;
+
+    /**
+     * @brief Append an event to the FIFO of its type
+     *
+     * @param event Event to queue, type must be < EventType::_Count. Moved
+     *        from only when queued; left intact when rejected or blocked
+     * @return true if queued (possibly after evicting or replacing another
+     *         event of the same type), false if rejected or blocked
+     *
+     * @note ISR-safe
+     *
+     * @par Complexity
+     * O(1)
+     */
+    bool push(Event &&event)
+    {
+        const auto type{static_cast<std::size_t>(event.type)};
+        const auto &traits{kEventTraitsTable[type]};
+        Index index{kInvalidIndex};
+        {
+            LockGuard<CriticalSection> lock(m_lock);
+            const auto &queue{m_queues[type]};
+            const std::size_t reserve{traits.priority == EventPriority::Critical ? 0U : kCriticalReserve};
+
+            if (traits.overflow == OverflowPolicy::CoalesceLatest && traits.coalesceWith != EventType::None &&
+                m_queues[static_cast<std::size_t>(traits.coalesceWith)].tail != kInvalidIndex)
+            {
+                // Partner state is pending (e.g. Disconnected while Connected waits) - supersede it
+                index = unlinkBack(static_cast<std::size_t>(traits.coalesceWith));
+                ++m_counters[type].coalesced;
+            }
+            else if (queue.count < traits.capacity && m_freeCount > reserve)
+            {
+                index = m_freeHead;
+                m_freeHead = m_nodes[index].next;
+                --m_freeCount;
+            }
+            else
+            {
+                index = claimOnOverflow(type, traits.overflow);
+                if (index == kInvalidIndex)
+                {
+                    return false;
+                }
+            }
+        }
+
+        // Node is owned exclusively until linked - fill it without masking interrupts
+        m_nodes[index].event = std::move(event);
+
+        LockGuard<CriticalSection> lock(m_lock);
+        linkBack(type, index);
+
+        auto &counters{m_counters[type]};
+        ++counters.published;
+        if (m_queues[type].count > counters.maxDepth)
+        {
+            counters.maxDepth = m_queues[type].count;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Detach the oldest pending event of a type
+     *
+     * @param type Event type index (< kTypeCount)
+     * @return Node index, kInvalidIndex if nothing is pending
+     *
+     * @note The node stays valid until release()
+     */
+    [[nodiscard]] Index popFront(const std::size_t type)
+    {
+        LockGuard<CriticalSection> lock(m_lock);
+        if (m_queues[type].head == kInvalidIndex)
+        {
+            return kInvalidIndex;
+        }
+        return unlinkFront(type);
+    }
+
+    /**
+     * @brief Detach the oldest pending event of any type (publish order)
+     *
+     * @return Node index, kInvalidIndex if nothing is pending
+     *
+     * @note The node stays valid until release()
+     */
+    [[nodiscard]] Index popOldest()
+    {
+        LockGuard<CriticalSection> lock(m_lock);
+        if (m_publishHead == kInvalidIndex)
+        {
+            return kInvalidIndex;
+        }
+        return unlinkFront(m_nodes[m_publishHead].type);
+    }
+
+    /// Event stored in a node returned by popFront() or popOldest()
+    [[nodiscard]] Event &event(const Index index)
+    {
+        return m_nodes[index].event;
+    }
+
+    /// Return a popped node to the free list, releasing its payload first
+    void release(const Index index)
+    {
+        m_nodes[index].event = Event{};
+
+        LockGuard<CriticalSection> lock(m_lock);
+        m_nodes[index].next = m_freeHead;
+        m_freeHead = index;
+        ++m_freeCount;
+    }
+
+    /// Bit N set while EventType N has pending events (snapshot)
+    [[nodiscard]] std::uint32_t pendingMask() const
+    {
+        LockGuard<CriticalSection> lock(m_lock);
+        return m_pendingMask;
+    }
+
+    /// Pending events across all types (snapshot)
+    [[nodiscard]] std::size_t pendingCount() const
+    {
+        LockGuard<CriticalSection> lock(m_lock);
+        return m_pendingTotal;
+    }
+
+    /// Pending events of one type (snapshot)
+    [[nodiscard]] std::size_t pendingCount(const std::size_t type) const
+    {
+        LockGuard<CriticalSection> lock(m_lock);
+        return m_queues[type].count;
+    }
+
+    /// Publish-side counters of one type, consistent snapshot
+    [[nodiscard]] TypeCounters counters(const std::size_t type) const
+    {
+        LockGuard<CriticalSection> lock(m_lock);
+        return m_counters[type];
+    }
+
+    /// Events of a type lost to its overflow policy since boot
+    [[nodiscard]] std::uint32_t droppedCount(const std::size_t type) const
+    {
+        return counters(type).dropped;
+    }
+
+    /// Events of a type superseded by a newer one via CoalesceLatest since boot
+    [[nodiscard]] std::uint32_t coalescedCount(const std::size_t type) const
+    {
+        return counters(type).coalesced;
+    }
+
+    /// Publishes of a type refused by BlockWithError since boot
+    [[nodiscard]] std::uint32_t blockedCount(const std::size_t type) const
+    {
+        return counters(type).blocked;
+    }
+
+private:
+    struct Node
+    {
+        Event event;
+        Index next{kInvalidIndex};        ///< Type FIFO or free list
+        Index publishPrev{kInvalidIndex}; ///< Publish-order list
+        Index publishNext{kInvalidIndex};
+        std::uint8_t type{0};
+    };
+
+    struct TypeQueue
+    {
+        Index head{kInvalidIndex};
+        Index tail{kInvalidIndex};
+        std::uint16_t count{0};
+    };
+
+    /// Apply the overflow policy; returns a node to reuse or kInvalidIndex. Must be called with m_lock held
+    Index claimOnOverflow(const std::size_t type, const OverflowPolicy policy)
+    {
+        const auto &queue{m_queues[type]};
+        switch (policy)
+        {
+            case OverflowPolicy::DropOldest:
+                ++m_counters[type].dropped;
+                return queue.head != kInvalidIndex ? unlinkFront(type) : kInvalidIndex;
+
+            case OverflowPolicy::CoalesceLatest:
+                if (queue.tail == kInvalidIndex)
+                {
+                    // Nothing of ours to supersede - the pool itself is exhausted
+                    ++m_counters[type].dropped;
+                    return kInvalidIndex;
+                }
+                ++m_counters[type].coalesced;
+                return unlinkBack(type);
+
+            case OverflowPolicy::BlockWithError:
+                ++m_counters[type].blocked;
+                return kInvalidIndex;
+
+            case OverflowPolicy::RejectNewest:
+            default:
+                ++m_counters[type].dropped;
+                return kInvalidIndex;
+        }
+    }
+
+    /// Must be called with m_lock held
+    void linkBack(const std::size_t type, const Index index)
+    {
+        auto &queue{m_queues[type]};
+        auto &node{m_nodes[index]};
+        node.next = kInvalidIndex;
+        node.type = static_cast<std::uint8_t>(type);
+        if (queue.tail == kInvalidIndex)
+        {
+            queue.head = index;
+        }
+        else
+        {
+            m_nodes[queue.tail].next = index;
+        }
+        queue.tail = index;
+
+        node.publishPrev = m_publishTail;
+        node.publishNext = kInvalidIndex;
+        if (m_publishTail == kInvalidIndex)
+        {
+            m_publishHead = index;
+        }
+        else
+        {
+            m_nodes[m_publishTail].publishNext = index;
+        }
+        m_publishTail = index;
+
+        ++queue.count;
+        ++m_pendingTotal;
+        m_pendingMask |= (1U << type);
+    }
+
+    /// Must be called with m_lock held and the queue non-empty
+    Index unlinkFront(const std::size_t type)
+    {
+        auto &queue{m_queues[type]};
+        const auto index{queue.head};
+        queue.head = m_nodes[index].next;
+        if (queue.head == kInvalidIndex)
+        {
+            queue.tail = kInvalidIndex;
+        }
+        unlinkCommon(type, index);
+        return index;
+    }
+
+    /// Must be called with m_lock held and the queue non-empty. O(capacity) walk to the tail's predecessor
+    Index unlinkBack(const std::size_t type)
+    {
+        auto &queue{m_queues[type]};
+        const auto index{queue.tail};
+        if (queue.head == index)
+        {
+            queue.head = kInvalidIndex;
+            queue.tail = kInvalidIndex;
+        }
+        else
+        {
+            auto previous{queue.head};
+            while (m_nodes[previous].next != index)
+            {
+                previous = m_nodes[previous].next;
+            }
+            m_nodes[previous].next = kInvalidIndex;
+            queue.tail = previous;
+        }
+        unlinkCommon(type, index);
+        return index;
+    }
+
+    /// Publish-order unlink and bookkeeping shared by both ends. Must be called with m_lock held
+    void unlinkCommon(const std::size_t type, const Index index)
+    {
+        auto &queue{m_queues[type]};
+        const auto &node{m_nodes[index]};
+        if (queue.head == kInvalidIndex)
+        {
+            m_pendingMask &= ~(1U << type);
+        }
+
+        // Evictions remove from the middle of the publish-order list
+        if (node.publishPrev == kInvalidIndex)
+        {
+            m_publishHead = node.publishNext;
+        }
+        else
+        {
+            m_nodes[node.publishPrev].publishNext = node.publishNext;
+        }
+        if (node.publishNext == kInvalidIndex)
+        {
+            m_publishTail = node.publishPrev;
+        }
+        else
+        {
+            m_nodes[node.publishNext].publishPrev = node.publishPrev;
+        }
+
+        --queue.count;
+        --m_pendingTotal;
+    }
+
+    mutable CriticalSection m_lock;
+    std::array<Node, kCapacity> m_nodes{};
+    std::array<TypeQueue, kTypeCount> m_queues{};
+    std::array<TypeCounters, kTypeCount> m_counters{};
+    Index m_freeHead{kInvalidIndex};
+    Index m_freeCount{0};
+    Index m_publishHead{kInvalidIndex};
+    Index m_publishTail{kInvalidIndex};
+    std::uint16_t m_pendingTotal{0};
+    std::uint32_t m_pendingMask{0};
+};
+} // namespace isic
+
+#endif // ISIC_CORE_EVENT_QUEUE_HPP
@@ -0,0 +1,195 @@
+#ifndef ISIC_CORE_EVENT_TRAITS_HPP
+#define ISIC_CORE_EVENT_TRAITS_HPP
+
+/**
+ * @file EventTraits.hpp
+ * @brief Compile-time per-EventType dispatch properties
+ *
+ * Single place to tune how the EventBus treats each event type. Everything
+ * here is constexpr and folds into lookup masks at compile time.
+ */
+
+#include "common/Types.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace isic
+{
+/**
+ * @brief What EventQueue does when a type is at capacity (or the pool is empty)
+ */
+enum class OverflowPolicy : std::uint8_t
+{
+    DropOldest,     ///< Evict the oldest pending event of the type, queue the new one
+    RejectNewest,   ///< Drop the new event, keep what is queued
+    CoalesceLatest, ///< Replace the newest pending event of the type (or its coalescing partner) with the new one
+    BlockWithError, ///< Refuse the new event without touching it; publish() returns false so the caller can retry
+};
+
+/**
+ * @brief Dispatch properties of one EventType
+ */
+struct EventTraits
+{
+    EventPriority priority{EventPriority::Normal};
+    std::uint8_t capacity{4}; ///< Max pending events of this type in the shared pool
+    OverflowPolicy overflow{OverflowPolicy::DropOldest};
+    EventType coalesceWith{EventType::None}; ///< CoalesceLatest partner sharing the same pending slot
+};
+
+/**
+ * @brief Traits of an event type
+ *
+ * @param type Event type
+ * @return Traits used by EventBus for queueing and dispatch order
+ *
+ * @note Capacities are upper bounds inside the shared pool, not
+ *       reservations, so generous values cost no RAM
+ *
+ * @par Coalescing
+ * Idempotent state events use CoalesceLatest with capacity 1: a new event
+ * takes over the pending one instead of queueing behind it, so subscribers
+ * only see the latest state. Connected/Disconnected pairs are coalescing
+ * partners - a flapping link collapses to whichever came last, in the
+ * position of the newest publish.
+ */
+[[nodiscard]] constexpr EventTraits eventTraits(const EventType type)
+{
+    switch (type)
+    {
+        // A tap is never silently lost: a full queue hands the event back to Pn532Service to retry
+        case EventType::CardScanned:
+            return {EventPriority::Critical, 16, OverflowPolicy::BlockWithError};
+
+        // Only the most recent feedback matters to the user
+        case EventType::FeedbackRequest:
+            return {EventPriority::Critical, 4, OverflowPolicy::DropOldest};
+
+        case EventType::AttendanceRecorded:
+        case EventType::AttendanceError:
+            return {EventPriority::High, 8, OverflowPolicy::DropOldest};
+
+        case EventType::MqttMessage:
+            return {EventPriority::High, 8, OverflowPolicy::RejectNewest};
+
+        case EventType::CardRemoved:
+        case EventType::NfcReady:
+        case EventType::NfcError:
+        case EventType::SystemError:
+        case EventType::WakeupOccurred:
+            return {EventPriority::High, 4, OverflowPolicy::DropOldest};
+
+        // Attendance publishes ask for a receipt and are sent again if evicted
+        case EventType::MqttPublishRequest:
+            return {EventPriority::Normal, 8, OverflowPolicy::DropOldest};
+
+        // Delivery receipts: a lost one leaves the sender waiting for its retry timer
+        case EventType::MqttPublished:
+        case EventType::MqttPublishFailed:
+            return {EventPriority::Normal, 4, OverflowPolicy::RejectNewest};
+
+        // One-shot notifications: a second copy carries no information
+        case EventType::SystemReady:
+        case EventType::WifiApStarted:
+        case EventType::WifiApStopped:
+            return {EventPriority::Normal, 1, OverflowPolicy::DropOldest};
+
+        // Link state: only the latest transition of each link matters
+        case EventType::WifiConnected:
+            return {EventPriority::Normal, 1, OverflowPolicy::CoalesceLatest, EventType::WifiDisconnected};
+        case EventType::WifiDisconnected:
+            return {EventPriority::Normal, 1, OverflowPolicy::CoalesceLatest, EventType::WifiConnected};
+        case EventType::MqttConnected:
+            return {EventPriority::Normal, 1, OverflowPolicy::CoalesceLatest, EventType::MqttDisconnected};
+        case EventType::MqttDisconnected:
+            return {EventPriority::Normal, 1, OverflowPolicy::CoalesceLatest, EventType::MqttConnected};
+
+        // Carries the full new state, older pending copies are stale
+        case EventType::PowerStateChange:
+            return {EventPriority::Normal, 1, OverflowPolicy::CoalesceLatest};
+
+        // Subscribers re-read config / health on every notification
+        case EventType::ConfigChanged:
+        case EventType::HealthChanged:
+            return {EventPriority::Low, 1, OverflowPolicy::CoalesceLatest};
+
+        case EventType::ConfigError:
+            return {EventPriority::Low, 4, OverflowPolicy::DropOldest};
+
+        case EventType::None:
+            return {EventPriority::Low, 1, OverflowPolicy::RejectNewest};
+
+        default:
+            return {EventPriority::Normal, 4, OverflowPolicy::DropOldest};
+    }
+}
+
+namespace detail
+{
+constexpr std::array<EventTraits, static_cast<std::size_t>(EventType::_Count)> makeEventTraitsTable()
+{
+    std::array<EventTraits, static_cast<std::size_t>(EventType::_Count)> table{};
+    for (std::size_t type{0}; type < table.size(); ++type)
+    {
+        table[type] = eventTraits(static_cast<EventType>(type));
+    }
+    return table;
+}
+
+/// Bit N of element P is set when EventType N has priority P
+constexpr std::array<std::uint32_t, static_cast<std::size_t>(EventPriority::_Count)> makePriorityMasks()
+{
+    std::array<std::uint32_t, static_cast<std::size_t>(EventPriority::_Count)> masks{};
+    for (std::size_t type{0}; type < static_cast<std::size_t>(EventType::_Count); ++type)
+    {
+        const auto priority{eventTraits(static_cast<EventType>(type)).priority};
+        masks[static_cast<std::size_t>(priority)] |= (1U << type);
+    }
+    return masks;
+}
+
+constexpr bool allCapacitiesNonZero()
+{
+    for (const auto &traits: makeEventTraitsTable())
+    {
+        if (traits.capacity == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Partners must point at each other, both coalesce, and share a priority class
+constexpr bool coalescePartnersConsistent()
+{
+    for (std::size_t type{0}; type < static_cast<std::size_t>(EventType::_Count); ++type)
+    {
+        const auto traits{eventTraits(static_cast<EventType>(type))};
+        if (traits.coalesceWith == EventType::None)
+        {
+            continue;
+        }
+        const auto partner{eventTraits(traits.coalesceWith)};
+        if (traits.overflow != OverflowPolicy::CoalesceLatest || partner.overflow != OverflowPolicy::CoalesceLatest ||
+            partner.coalesceWith != static_cast<EventType>(type) || partner.priority != traits.priority)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace detail
+
+/// Traits indexed by EventType, resolved at compile time
+inline constexpr auto kEventTraitsTable{detail::makeEventTraitsTable()};
+
+/// Per-priority EventType bitmasks, highest priority first
+inline constexpr auto kEventPriorityMasks{detail::makePriorityMasks()};
+
+static_assert(detail::allCapacitiesNonZero(), "every EventType needs a queue capacity of at least 1");
+static_assert(detail::coalescePartnersConsistent(), "coalesceWith partners must be mutual CoalesceLatest types of equal priority");
+} // namespace isic
+
+#endif // ISIC_CORE_EVENT_TRAITS_HPP
@@ -5,8 +5,8 @@
  * @file IService.hpp
  * @brief Core service interfaces and base implementation
  *
- * Defines the common service lifecycle contract, metrics reporting interface,
- * and a shared base class for services.
+ * Defines the metrics reporting interface, the common service lifecycle
+ * contract, and a shared base class for services.
  */
 
 #include "common/Types.hpp"
@@ -15,16 +15,39 @@
 
 namespace isic
 {
+/**
+ * @brief Anything that reports metrics on the metrics MQTT topic
+ *
+ * @note Services get this through IService; core components (EventBus)
+ *       implement it directly and register with HealthService the same way
+ */
+class IMetricsSource
+{
+public:
+    virtual ~IMetricsSource() = default;
+
+    /**
+     * @brief Get the component name (used as the metrics JSON key)
+     */
+    [[nodiscard]] virtual const char *getName() const = 0;
+
+    /**
+     * @brief Serialize metrics into JSON object
+     * @param obj JSON object to populate with metrics
+     */
+    virtual void serializeMetrics(JsonObject &obj) const = 0;
+};
+
 /**
  * @brief Base interface for all services
  */
-class IService
+class IService : public IMetricsSource
 {
 public:
     /**
      * @brief Virtual destructor
      */
-    virtual ~IService() = default;
+    ~IService() override = default;
 
     /**
      * @brief Initialize the service
@@ -44,22 +67,11 @@ public:
      */
     virtual void end() = 0;
 
-    /**
-     * @brief Get the service name
-     */
-    [[nodiscard]] virtual const char *getName() const = 0;
-
     /**
      * @brief Get current service state
      */
     [[nodiscard]] virtual ServiceState getState() const = 0;
 
-    /**
-     * @brief Serialize service metrics into JSON object
-     * @param obj JSON object to populate with metrics
-     */
-    virtual void serializeMetrics(JsonObject &obj) const = 0;
-
     /**
      * @brief Check if service is running
      */
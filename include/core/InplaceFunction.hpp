@@ -0,0 +1,180 @@
+#ifndef ISIC_CORE_INPLACE_FUNCTION_HPP
+#define ISIC_CORE_INPLACE_FUNCTION_HPP
+
+/**
+ * @file InplaceFunction.hpp
+ * @brief Heap-free, fixed-capacity callable wrapper
+ *
+ * Drop-in replacement for std::function on the subscription path. The
+ * callable is always stored inside the object; a capture that does not fit
+ * is a compile error instead of a silent heap allocation.
+ */
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace isic
+{
+/// Default capture budget: `this` plus one pointer-sized field
+#ifndef ISIC_CALLBACK_CAPACITY
+#define ISIC_CALLBACK_CAPACITY (2 * sizeof(void *))
+#endif
+
+inline constexpr std::size_t kDefaultInplaceCapacity{ISIC_CALLBACK_CAPACITY};
+
+template<typename Signature, std::size_t Capacity = kDefaultInplaceCapacity>
+class InplaceFunction;
+
+/**
+ * @class InplaceFunction
+ * @brief Move-only type-erased callable with small-buffer storage only
+ *
+ * Layout is the capture buffer plus a single pointer to a per-callable-type
+ * operations table (kept in flash), i.e. Capacity + 4 bytes on ESP.
+ *
+ * @tparam R Return type
+ * @tparam Args Argument types
+ * @tparam Capacity Capture buffer size in bytes
+ *
+ * @par Usage
+ * @code
+ * InplaceFunction<void(int)> fn = [this](int x) { handle(x); };
+ * fn(42);
+ *
+ * // Does not compile: capture exceeds the buffer
+ * std::array<int, 8> big{};
+ * InplaceFunction<void()> bad = [big]() {};
+ * @endcode
+ */
+template<typename R, typename... Args, std::size_t Capacity>
+class InplaceFunction<R(Args...), Capacity>
+{
+public:
+    static constexpr std::size_t kCapacity{Capacity};
+    static constexpr std::size_t kAlignment{alignof(void *)};
+
+    InplaceFunction() noexcept = default;
+
+    InplaceFunction(std::nullptr_t) noexcept // NOLINT(google-explicit-constructor)
+    {
+    }
+
+    template<typename F,
+             typename Fn = std::decay_t<F>,
+             typename = std::enable_if_t<!std::is_same_v<Fn, InplaceFunction> && std::is_invocable_r_v<R, Fn &, Args...>>>
+    InplaceFunction(F &&callable) // NOLINT(google-explicit-constructor)
+    {
+        static_assert(sizeof(Fn) <= Capacity, "InplaceFunction: capture too large - capture less or raise the capacity");
+        static_assert(alignof(Fn) <= kAlignment, "InplaceFunction: capture alignment too strict");
+        static_assert(std::is_nothrow_move_constructible_v<Fn>, "InplaceFunction: callable must be nothrow movable");
+
+        if constexpr (std::is_pointer_v<Fn> || std::is_member_pointer_v<Fn>)
+        {
+            if (callable == nullptr)
+            {
+                return;
+            }
+        }
+
+        ::new (static_cast<void *>(m_storage)) Fn(std::forward<F>(callable));
+        m_ops = &kOpsFor<Fn>;
+    }
+
+    ~InplaceFunction()
+    {
+        reset();
+    }
+
+    InplaceFunction(const InplaceFunction &) = delete;
+    InplaceFunction &operator=(const InplaceFunction &) = delete;
+
+    InplaceFunction(InplaceFunction &&other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    InplaceFunction &operator=(InplaceFunction &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    InplaceFunction &operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    /// Invoke the stored callable (must not be empty)
+    R operator()(Args... args) const
+    {
+        return m_ops->invoke(const_cast<unsigned char *>(m_storage), std::forward<Args>(args)...);
+    }
+
+    [[nodiscard]] explicit operator bool() const noexcept
+    {
+        return m_ops != nullptr;
+    }
+
+    void reset() noexcept
+    {
+        if (m_ops)
+        {
+            m_ops->destroy(m_storage);
+            m_ops = nullptr;
+        }
+    }
+
+private:
+    struct Ops
+    {
+        R (*invoke)(void *storage, Args &&...args);
+        void (*move)(void *destination, void *source) noexcept;
+        void (*destroy)(void *storage) noexcept;
+    };
+
+    template<typename Fn>
+    static R invokeImpl(void *storage, Args &&...args)
+    {
+        return (*static_cast<Fn *>(storage))(std::forward<Args>(args)...);
+    }
+
+    template<typename Fn>
+    static void moveImpl(void *destination, void *source) noexcept
+    {
+        ::new (destination) Fn(std::move(*static_cast<Fn *>(source)));
+        static_cast<Fn *>(source)->~Fn();
+    }
+
+    template<typename Fn>
+    static void destroyImpl(void *storage) noexcept
+    {
+        static_cast<Fn *>(storage)->~Fn();
+    }
+
+    /// One constexpr table per callable type - lives in flash, not per instance
+    template<typename Fn>
+    static constexpr Ops kOpsFor{&invokeImpl<Fn>, &moveImpl<Fn>, &destroyImpl<Fn>};
+
+    void moveFrom(InplaceFunction &other) noexcept
+    {
+        if (other.m_ops)
+        {
+            other.m_ops->move(m_storage, other.m_storage);
+            m_ops = other.m_ops;
+            other.m_ops = nullptr;
+        }
+    }
+
+    alignas(kAlignment) unsigned char m_storage[Capacity]{};
+    const Ops *m_ops{nullptr};
+};
+} // namespace isic
+
+#endif // ISIC_CORE_INPLACE_FUNCTION_HPP
@@ -10,13 +10,12 @@
  * with ISR-safe publishing and deterministic memory usage.
  */
 
-#include "platform/PlatformMutex.hpp"
+#include "core/SlotList.hpp"
+#include "platform/PlatformAtomic.hpp"
 
-#include <algorithm>
-#include <functional>
 #include <tuple>
 #include <type_traits>
-#include <vector>
+#include <utility>
 
 namespace isic
 {
@@ -32,18 +31,39 @@ namespace isic
  * @tparam Args Event argument types (must be copyable for queue storage)
  *
  * @par Thread Safety
- * - publish(): Safe from any context including ISR
- * - connect()/disconnect(): Safe from any context
+ * - publish(): Lock-free, safe from any context including ISR
+ * - connect()/disconnect(): Safe from any context except ISR
  * - dispatch(): Must be called from main loop only
  *
  * @par Memory Model
- * - Fixed-size ring buffer for pending events (no dynamic allocation on publish)
- * - Subscriber list grows dynamically but pre-reserves capacity
+ * - Fixed-size lock-free ring buffer for pending events (no dynamic allocation on publish)
+ * - Subscribers live in a SlotList (grows dynamically, pre-reserves capacity)
+ * - Callbacks are InplaceFunction: captures live inside the slot, never on the heap
+ * - Dispatch iterates the subscriber list in place (no per-event allocation)
  * - Arguments stored by value (use lightweight types or std::ref)
  *
+ * @par Pending Queue
+ * Bounded multi-producer ring with a per-cell sequence number. Producers claim
+ * a cell by bumping the write index with a compare-and-swap (native atomics on
+ * ESP32, a few-cycle interrupt mask on ESP8266), then fill it outside of any
+ * critical section. The subscriber mutex is never touched on the publish path.
+ *
+ * @par Direct Connections
+ * Slots connected with ConnectionMode::Direct run inline inside publish()
+ * when it is called from the task that runs dispatch(), outside interrupts,
+ * and below ISIC_DIRECT_DEPTH_LIMIT nested direct deliveries. Anywhere else
+ * they are delivered from dispatch() like Queued slots.
+ *
+ * @par Re-entrant Subscription Changes
+ * Callbacks may connect or disconnect (including themselves) during
+ * dispatch; see SlotList for the exact semantics.
+ *
  * @par Overflow Policy
- * When the ring buffer is full, oldest events are dropped (FIFO eviction).
- * Monitor with pendingCount() to detect saturation.
+ * When the ring buffer is full, the oldest event is dropped (FIFO eviction).
+ * If the oldest cell is still being written by an interrupted producer, the
+ * new event is rejected instead. Monitor with pendingCount() to detect
+ * saturation; droppedCount() counts the evictions, so every accepted
+ * publish is either delivered, still pending or counted there.
  *
  * @par Usage Example
  * @code
@@ -54,7 +74,7 @@ namespace isic
  *     Serial.printf("Received: %d - %s\n", code, msg.c_str());
  * });
  *
- * // Publish from anywhere (ISR-safe)
+ * // Publish from anywhere (lock-free, ISR-safe)
  * onData.publish(42, "hello");
  *
  * // Dispatch from main loop
@@ -69,107 +89,32 @@ template<typename... Args>
 class Signal
 {
 public:
-    using Callback = std::function<void(Args...)>;
-    using Connection = std::size_t;
+    using Slots = SlotList<Args...>;
+    using Callback = typename Slots::Callback;
+    using Connection = typename Slots::Connection;
+    using ScopedConnection = typename Slots::ScopedConnection;
 
-    /**
-     * @class ScopedConnection
-     * @brief RAII wrapper for automatic signal disconnection
-     *
-     * Automatically disconnects from the signal when destroyed.
-     * Move-only to ensure single ownership of the connection.
-     *
-     * @par Usage
-     * Store as a class member to tie subscription lifetime to object lifetime:
-     * @code
-     * class MyHandler {
-     *     Signal<int>::ScopedConnection m_conn;
-     * public:
-     *     void subscribe(Signal<int>& sig) {
-     *         m_conn = sig.connectScoped([this](int x) { handle(x); });
-     *     }
-     * };  // Auto-disconnects when MyHandler is destroyed
-     * @endcode
-     */
-    class ScopedConnection
+    Signal()
     {
-    public:
-        ScopedConnection() = default;
-
-        ScopedConnection(Signal *signal, Connection id)
-            : m_signal(signal)
-            , m_id(id)
-        {
-        }
-
-        ~ScopedConnection()
-        {
-            disconnect();
-        }
-        // Non-copyable
-        ScopedConnection(const ScopedConnection &) = delete;
-        ScopedConnection &operator=(const ScopedConnection &) = delete;
-
-        ScopedConnection(ScopedConnection &&other) noexcept
-            : m_signal(other.m_signal)
-            , m_id(other.m_id)
-        {
-            other.m_signal = nullptr;
-            other.m_id = 0;
-        }
-
-        ScopedConnection &operator=(ScopedConnection &&other) noexcept
-        {
-            if (this != &other)
-            {
-                disconnect();
-                m_signal = other.m_signal;
-                m_id = other.m_id;
-                other.m_signal = nullptr;
-                other.m_id = 0;
-            }
-            return *this;
-        }
-
-        /// Manually disconnect before destruction
-        void disconnect()
-        {
-            if (m_signal && m_id != 0)
-            {
-                m_signal->disconnect(m_id);
-                m_signal = nullptr;
-                m_id = 0;
-            }
-        }
-
-    private:
-        Signal *m_signal{nullptr};
-        Connection m_id{0};
-    };
+        resetPendingQueue();
+    }
 
-    Signal() = default;
     ~Signal() = default;
 
     Signal(const Signal &) = delete;
     Signal &operator=(const Signal &) = delete;
 
     Signal(Signal &&other) noexcept
+        : m_slots(std::move(other.m_slots))
     {
-        LockGuard<Mutex> lock(other.m_mutex);
-        m_slots = std::move(other.m_slots);
-        m_nextId = other.m_nextId;
-        other.m_nextId = 0;
+        resetPendingQueue();
     }
 
     Signal &operator=(Signal &&other) noexcept
     {
         if (this != &other)
         {
-            UniqueLock<Mutex> lockThis(m_mutex);
-            UniqueLock<Mutex> lockOther(other.m_mutex);
             m_slots = std::move(other.m_slots);
-            m_nextId = other.m_nextId;
-            other.m_nextId = 0;
         }
         return *this;
     }
@@ -178,45 +123,30 @@ public:
      * @brief Register a callback to receive signal emissions
      *
      * @param callback Function to invoke when signal is dispatched
+     * @param mode Queued (default) or Direct (inline in publish() when safe)
      * @return Connection handle for manual disconnection, 0 if callback is null
      *
      * @note Prefer connectScoped() for automatic lifetime management
-     * @note Thread-safe: can be called from any context
-     *
-     * @par Complexity
-     * O(1) amortized (vector push_back)
+     * @note Thread-safe: can be called from any context except ISR
+     * @note Safe to call from within a callback (takes effect from the next event)
      */
-    [[nodiscard]] Connection connect(Callback callback)
+    [[nodiscard]] Connection connect(Callback callback, const ConnectionMode mode = ConnectionMode::Queued)
     {
-        if (!callback)
-        {
-            return 0;
-        }
-
-        LockGuard<Mutex> lock(m_mutex);
-
-        // Pre-allocate to avoid fragmentation on ESP8266
-        if (m_slots.empty())
-        {
-            m_slots.reserve(kInitialSlotCapacity);
-        }
-
-        Connection id = ++m_nextId;
-        m_slots.push_back({id, std::move(callback)});
-        return id;
+        return m_slots.connect(std::move(callback), mode);
     }
 
     /**
      * @brief Register a callback with RAII-based automatic cleanup
      *
      * @param callback Function to invoke when signal is dispatched
+     * @param mode Queued (default) or Direct
      * @return ScopedConnection that disconnects on destruction
      *
      * @note Store the returned ScopedConnection as a class member
      */
-    [[nodiscard]] ScopedConnection connectScoped(Callback callback)
+    [[nodiscard]] ScopedConnection connectScoped(Callback callback, const ConnectionMode mode = ConnectionMode::Queued)
     {
-        return ScopedConnection(this, connect(std::move(callback)));
+        return m_slots.connectScoped(std::move(callback), mode);
     }
 
     /**
@@ -224,21 +154,11 @@ public:
      *
      * @param id Connection handle from connect()
      *
-     * @note Thread-safe: can be called from any context
-     * @note Safe to call from within a callback
      * @note Idempotent: safe to call multiple times with same ID
      */
     void disconnect(Connection id)
     {
-        if (id == 0)
-        {
-            return;
-        }
-
-        LockGuard<Mutex> lock(m_mutex);
-        auto it = std::remove_if(m_slots.begin(), m_slots.end(),
-                                 [id](const Slot &slot) { return slot.id == id; });
-        m_slots.erase(it, m_slots.end());
+        m_slots.disconnect(id);
     }
 
     /**
@@ -246,20 +166,23 @@ public:
      */
     void clear()
     {
-        LockGuard<Mutex> lock(m_mutex);
         m_slots.clear();
     }
 
     /**
      * @brief Queue event arguments for asynchronous delivery
      *
-     * Copies arguments into the internal ring buffer. Subscribers are
+     * Copies arguments into the internal ring buffer. Queued subscribers are
      * NOT invoked immediately - events are delivered during dispatch().
+     * Direct subscribers run before this returns if the event was queued
+     * and the calling context allows it (see class docs).
      *
      * @param args Event arguments to publish
-     * @return true always (oldest event dropped if buffer full)
+     * @return true if queued, false if the ring was full and the oldest
+     *         cell could not be evicted (still being written by another producer)
      *
-     * @note ISR-safe: can be called from interrupt handlers
+     * @note Lock-free and ISR-safe: never takes the subscriber mutex (the
+     *       inline Direct path only runs on the dispatch task)
      * @note Events delivered in FIFO order
      * @warning Keep Args lightweight on ESP8266 ISR (no heap allocation)
      *
@@ -275,20 +198,21 @@ public:
         static_assert(sizeof...(TArgs) == sizeof...(Args), "Signal::publish argument count mismatch");
         static_assert((std::is_constructible_v<std::decay_t<Args>, TArgs &&> && ...), "Signal::publish argument type mismatch");
 
-        LockGuard<Mutex> lock(m_mutex);
-
-        // Ring buffer overflow: drop oldest event
-        if (m_pendingCount >= kMaxPendingEvents)
+        if (!canDeliverDirect())
         {
-            m_pendingRead = (m_pendingRead + 1) % kMaxPendingEvents;
-            --m_pendingCount;
+            return enqueue(PendingEvent{std::forward<TArgs>(args)...});
         }
 
-        // Store in ring buffer
-        m_pendingEvents[m_pendingWrite] = PendingEvent{std::forward<Args>(args)...};
-        m_pendingWrite = (m_pendingWrite + 1) % kMaxPendingEvents;
-        ++m_pendingCount;
+        // Queue first so a rejected event never reaches the Direct slots
+        PendingEvent event{std::forward<TArgs>(args)...};
+        event.deliveredDirect = true;
+        if (!enqueue(PendingEvent{std::as_const(event)}))
+        {
+            return false;
+        }
 
+        const detail::DirectDepthScope depth{m_directDepth};
+        std::apply([this](auto &...eventArgs) { m_slots.invokeDirect(eventArgs...); }, event.args);
         return true;
     }
 
@@ -318,30 +242,12 @@ public:
     std::size_t dispatch()
     {
         std::size_t dispatched{0};
+        PendingEvent event;
+        m_dispatchTaskId.store(currentTaskId(), std::memory_order_relaxed);
 
-        while (true)
+        // Invoke callbacks outside any lock (allows re-entrant publish)
+        while (tryPop(event))
         {
-            PendingEvent event;
-            bool hasEvent{false};
-
-            // Extract one event under lock
-            {
-                LockGuard<Mutex> lock(m_mutex);
-                if (m_pendingCount > 0)
-                {
-                    event = std::move(m_pendingEvents[m_pendingRead]);
-                    m_pendingRead = (m_pendingRead + 1) % kMaxPendingEvents;
-                    --m_pendingCount;
-                    hasEvent = true;
-                }
-            }
-
-            if (!hasEvent)
-            {
-                break;
-            }
-
-            // Invoke callbacks with mutex unlocked (allows re-entrant publish)
             invokeCallbacks(event);
             ++dispatched;
         }
@@ -349,38 +255,38 @@ public:
         return dispatched;
     }
 
-    /// Number of events awaiting dispatch
+    /// Number of events awaiting dispatch (snapshot, may race with publishers)
     [[nodiscard]] std::size_t pendingCount() const
     {
-        LockGuard<Mutex> lock(m_mutex);
-        return m_pendingCount;
+        const auto write{m_writePosition.load(std::memory_order_acquire)};
+        const auto read{m_readPosition.load(std::memory_order_acquire)};
+        return static_cast<std::size_t>(write - read);
+    }
+
+    /// Accepted events evicted by a later publish() before dispatch, since construction
+    [[nodiscard]] std::uint32_t droppedCount() const
+    {
+        return m_droppedCount.load(std::memory_order_relaxed);
     }
 
     /// Number of connected subscribers
     [[nodiscard]] std::size_t size() const
     {
-        LockGuard<Mutex> lock(m_mutex);
         return m_slots.size();
     }
 
     /// True if no subscribers connected
     [[nodiscard]] bool empty() const
     {
-        LockGuard<Mutex> lock(m_mutex);
         return m_slots.empty();
     }
 
 private:
-    struct Slot
-    {
-        Connection id;
-        Callback callback;
-    };
-
     /// Stores event arguments for deferred dispatch (values, not references)
     struct PendingEvent
     {
         std::tuple<std::decay_t<Args>...> args;
+        bool deliveredDirect{false}; ///< Direct slots already ran in publish()
 
         PendingEvent() = default;
 
@@ -391,45 +297,142 @@ private:
         }
     };
 
-    void invokeCallbacks(PendingEvent &event)
+    /// Ring cell: sequence == position when free, position + 1 when filled
+    struct Cell
+    {
+        std::atomic<std::uint32_t> sequence{0};
+        PendingEvent event;
+    };
+
+    /// Direct slots may run inline: on the dispatch task, outside ISRs, below the nesting limit
+    [[nodiscard]] bool canDeliverDirect() const
     {
-        std::vector<Slot> slotsCopy;
+        return m_slots.hasDirect() && m_directDepth < ISIC_DIRECT_DEPTH_LIMIT && !inInterruptContext() &&
+               currentTaskId() == m_dispatchTaskId.load(std::memory_order_relaxed);
+    }
+
+    bool enqueue(PendingEvent &&event)
+    {
+        // Bounded: one eviction attempt per claim failure, never spins on a stalled cell
+        for (std::size_t attempt{0}; attempt <= kMaxPendingEvents; ++attempt)
+        {
+            std::uint32_t position{0};
+            if (auto *cell = claimWriteCell(position))
+            {
+                cell->event = std::move(event);
+                cell->sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+
+            // Ring buffer overflow: drop oldest event
+            PendingEvent discarded;
+            if (!tryPop(discarded))
+            {
+                return false;
+            }
+            auto dropped{m_droppedCount.load(std::memory_order_relaxed)};
+            while (!atomicCompareExchange(m_droppedCount, dropped, dropped + 1))
+            {
+            }
+        }
+        return false;
+    }
+
+    void resetPendingQueue()
+    {
+        for (std::uint32_t i{0}; i < kMaxPendingEvents; ++i)
+        {
+            m_pendingEvents[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_writePosition.store(0, std::memory_order_relaxed);
+        m_readPosition.store(0, std::memory_order_relaxed);
+    }
 
-        // Copy subscriber list under lock
+    /// Claim the next free cell for writing, nullptr if the ring is full
+    Cell *claimWriteCell(std::uint32_t &position)
+    {
+        position = m_writePosition.load(std::memory_order_relaxed);
+        while (true)
         {
-            LockGuard<Mutex> lock(m_mutex);
-            if (m_slots.empty())
+            auto &cell{m_pendingEvents[position & kPendingMask]};
+            const auto sequence{cell.sequence.load(std::memory_order_acquire)};
+            const auto diff{static_cast<std::int32_t>(sequence - position)};
+
+            if (diff == 0)
+            {
+                if (atomicCompareExchange(m_writePosition, position, position + 1))
+                {
+                    return &cell;
+                }
+            }
+            else if (diff < 0)
             {
-                return;
+                return nullptr;
+            }
+            else
+            {
+                position = m_writePosition.load(std::memory_order_relaxed);
             }
-            slotsCopy = m_slots;
         }
+    }
 
-        // Invoke with mutex unlocked (allows re-entrant operations)
-        for (const auto &slot: slotsCopy)
+    /// Take the oldest filled cell, false if empty or oldest still being written
+    bool tryPop(PendingEvent &out)
+    {
+        auto position{m_readPosition.load(std::memory_order_relaxed)};
+        while (true)
         {
-            if (slot.callback)
+            auto &cell{m_pendingEvents[position & kPendingMask]};
+            const auto sequence{cell.sequence.load(std::memory_order_acquire)};
+            const auto diff{static_cast<std::int32_t>(sequence - (position + 1))};
+
+            if (diff == 0)
             {
-                std::apply(slot.callback, event.args);
+                if (atomicCompareExchange(m_readPosition, position, position + 1))
+                {
+                    out = std::move(cell.event);
+                    cell.sequence.store(position + kMaxPendingEvents, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
             }
+            else
+            {
+                position = m_readPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void invokeCallbacks(PendingEvent &event)
+    {
+        if (event.deliveredDirect)
+        {
+            std::apply([this](auto &...args) { m_slots.invokeQueued(args...); }, event.args);
+        }
+        else
+        {
+            std::apply([this](auto &...args) { m_slots.invoke(args...); }, event.args);
         }
     }
 
-    /// Ring buffer capacity - tuned for ESP8266 memory constraints
-    static constexpr std::size_t kMaxPendingEvents{8};
+    /// Ring buffer capacity - tuned for ESP8266 memory constraints (power of two)
+    static constexpr std::uint32_t kMaxPendingEvents{8};
+    static constexpr std::uint32_t kPendingMask{kMaxPendingEvents - 1};
+    static_assert((kMaxPendingEvents & kPendingMask) == 0, "kMaxPendingEvents must be a power of two");
 
-    /// Initial slot vector capacity to avoid early reallocations
-    static constexpr std::size_t kInitialSlotCapacity{8};
+    Slots m_slots;
 
-    mutable Mutex m_mutex;
-    std::vector<Slot> m_slots;
-    Connection m_nextId{0};
+    // Lock-free ring buffer for async event dispatch
+    Cell m_pendingEvents[kMaxPendingEvents];
+    std::atomic<std::uint32_t> m_writePosition{0};
+    std::atomic<std::uint32_t> m_readPosition{0};
+    std::atomic<std::uint32_t> m_droppedCount{0}; ///< Evictions by enqueue(), see droppedCount()
 
-    // Ring buffer for async event dispatch
-    PendingEvent m_pendingEvents[kMaxPendingEvents];
-    std::size_t m_pendingRead{0};
-    std::size_t m_pendingWrite{0};
-    std::size_t m_pendingCount{0};
+    std::atomic<std::uintptr_t> m_dispatchTaskId{0}; ///< currentTaskId() of the last dispatch(), 0 before the first
+    std::uint8_t m_directDepth{0};                   ///< Nested direct deliveries (dispatch task only)
 };
 } // namespace isic
 
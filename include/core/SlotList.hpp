@@ -0,0 +1,512 @@
+#ifndef ISIC_CORE_SLOT_LIST_HPP
+#define ISIC_CORE_SLOT_LIST_HPP
+
+/**
+ * @file SlotList.hpp
+ * @brief Subscriber list with re-entrant-safe connect/disconnect
+ *
+ * Holds the callbacks of one signal or event type. Queueing is left to the
+ * owner (Signal ring buffer, EventBus shared pool), so the same list can sit
+ * behind either without carrying a per-type event buffer.
+ *
+ * Each slot is Queued (run from the owner's dispatch loop) or Direct (run
+ * inline by the owner's publish() when that is safe, see Signal/EventBus).
+ */
+
+#include "core/InplaceFunction.hpp"
+#include "platform/PlatformMutex.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/// Max nesting of direct deliveries (a direct subscriber publishing to another direct subscriber, ...)
+#ifndef ISIC_DIRECT_DEPTH_LIMIT
+#define ISIC_DIRECT_DEPTH_LIMIT 4
+#endif
+
+namespace isic
+{
+/// When a subscriber runs relative to publish()
+enum class ConnectionMode : std::uint8_t
+{
+    Queued, ///< From the owner's dispatch loop (default)
+    Direct, ///< Inline in publish() when called from the dispatch task, queued otherwise
+};
+
+namespace detail
+{
+/// Counts nested direct deliveries; leaves the count balanced even if a callback throws
+struct DirectDepthScope
+{
+    std::uint8_t &depth;
+
+    explicit DirectDepthScope(std::uint8_t &counter)
+        : depth(counter)
+    {
+        ++depth;
+    }
+
+    ~DirectDepthScope()
+    {
+        --depth;
+    }
+
+    DirectDepthScope(const DirectDepthScope &) = delete;
+    DirectDepthScope &operator=(const DirectDepthScope &) = delete;
+};
+} // namespace detail
+
+/**
+ * @class SlotList
+ * @brief Thread-safe list of callbacks invoked synchronously by invoke()
+ *
+ * @tparam Args Callback argument types
+ *
+ * @par Thread Safety
+ * - connect()/disconnect()/clear(): Safe from any context except ISR
+ * - invoke(): Main loop only
+ *
+ * @par Re-entrant Subscription Changes
+ * While invoke() runs the slot vector is frozen: disconnect() only
+ * tombstones the slot and connect() stages the new slot aside. Both are
+ * folded into the vector once the outermost invoke() returns, so callbacks
+ * may freely connect or disconnect (including themselves). Slots connected
+ * during an invoke() first receive the next one. invoke() may also nest,
+ * e.g. a direct slot publishing to the same list.
+ */
+template<typename... Args>
+class SlotList
+{
+public:
+    using Callback = InplaceFunction<void(Args...)>;
+    using Connection = std::size_t;
+
+    /**
+     * @class ScopedConnection
+     * @brief RAII wrapper for automatic disconnection
+     *
+     * Automatically disconnects from the list when destroyed.
+     * Move-only to ensure single ownership of the connection.
+     *
+     * @par Usage
+     * Store as a class member to tie subscription lifetime to object lifetime:
+     * @code
+     * class MyHandler {
+     *     Signal<int>::ScopedConnection m_conn;
+     * public:
+     *     void subscribe(Signal<int>& sig) {
+     *         m_conn = sig.connectScoped([this](int x) { handle(x); });
+     *     }
+     * };  // Auto-disconnects when MyHandler is destroyed
+     * @endcode
+     */
+    class ScopedConnection
+    {
+    public:
+        ScopedConnection() = default;
+
+        ScopedConnection(SlotList *slots, Connection id)
+            : m_slots(slots)
+            , m_id(id)
+        {
+        }
+
+        ~ScopedConnection()
+        {
+            disconnect();
+        }
+        // Non-copyable
+        ScopedConnection(const ScopedConnection &) = delete;
+        ScopedConnection &operator=(const ScopedConnection &) = delete;
+
+        ScopedConnection(ScopedConnection &&other) noexcept
+            : m_slots(other.m_slots)
+            , m_id(other.m_id)
+        {
+            other.m_slots = nullptr;
+            other.m_id = 0;
+        }
+
+        ScopedConnection &operator=(ScopedConnection &&other) noexcept
+        {
+            if (this != &other)
+            {
+                disconnect();
+                m_slots = other.m_slots;
+                m_id = other.m_id;
+                other.m_slots = nullptr;
+                other.m_id = 0;
+            }
+            return *this;
+        }
+
+        /// Manually disconnect before destruction
+        void disconnect()
+        {
+            if (m_slots && m_id != 0)
+            {
+                m_slots->disconnect(m_id);
+                m_slots = nullptr;
+                m_id = 0;
+            }
+        }
+
+    private:
+        SlotList *m_slots{nullptr};
+        Connection m_id{0};
+    };
+
+    SlotList() = default;
+    ~SlotList() = default;
+
+    SlotList(const SlotList &) = delete;
+    SlotList &operator=(const SlotList &) = delete;
+
+    SlotList(SlotList &&other) noexcept
+    {
+        LockGuard<Mutex> lock(other.m_mutex);
+        m_slots = std::move(other.m_slots);
+        m_stagedSlots = std::move(other.m_stagedSlots);
+        m_tombstoneCount = other.m_tombstoneCount;
+        m_nextId = other.m_nextId;
+        other.m_tombstoneCount = 0;
+        m_directCount.store(other.m_directCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        other.m_directCount.store(0, std::memory_order_relaxed);
+        other.m_nextId = 0;
+    }
+
+    SlotList &operator=(SlotList &&other) noexcept
+    {
+        if (this != &other)
+        {
+            UniqueLock<Mutex> lockThis(m_mutex);
+            UniqueLock<Mutex> lockOther(other.m_mutex);
+            m_slots = std::move(other.m_slots);
+            m_stagedSlots = std::move(other.m_stagedSlots);
+            m_tombstoneCount = other.m_tombstoneCount;
+            m_nextId = other.m_nextId;
+            other.m_tombstoneCount = 0;
+            m_directCount.store(other.m_directCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            other.m_directCount.store(0, std::memory_order_relaxed);
+            other.m_nextId = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Register a callback
+     *
+     * @param callback Function to invoke
+     * @param mode Queued (default) or Direct, see invokeDirect()/invokeQueued()
+     * @return Connection handle for manual disconnection, 0 if callback is null
+     *
+     * @note Thread-safe: can be called from any context except ISR
+     * @note Safe to call from within a callback (takes effect from the next invoke)
+     *
+     * @par Complexity
+     * O(1) amortized (vector push_back)
+     */
+    [[nodiscard]] Connection connect(Callback callback, const ConnectionMode mode = ConnectionMode::Queued)
+    {
+        if (!callback)
+        {
+            return 0;
+        }
+
+        LockGuard<Mutex> lock(m_mutex);
+
+        // Pre-allocate to avoid fragmentation on ESP8266
+        if (m_slots.empty())
+        {
+            m_slots.reserve(kInitialSlotCapacity);
+        }
+
+        Connection id = ++m_nextId;
+        if (m_invokeDepth > 0)
+        {
+            // Slot vector is being iterated - growing it could move a running callback
+            m_stagedSlots.emplace_back(id, std::move(callback), mode);
+        }
+        else
+        {
+            m_slots.emplace_back(id, std::move(callback), mode);
+        }
+        if (mode == ConnectionMode::Direct)
+        {
+            m_directCount.store(m_directCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        return id;
+    }
+
+    /**
+     * @brief Register a callback with RAII-based automatic cleanup
+     *
+     * @param callback Function to invoke
+     * @param mode Queued (default) or Direct
+     * @return ScopedConnection that disconnects on destruction
+     */
+    [[nodiscard]] ScopedConnection connectScoped(Callback callback, const ConnectionMode mode = ConnectionMode::Queued)
+    {
+        return ScopedConnection(this, connect(std::move(callback), mode));
+    }
+
+    /**
+     * @brief Remove a subscription using its connection handle
+     *
+     * @param id Connection handle from connect()
+     *
+     * @note Thread-safe: can be called from any context except ISR
+     * @note Safe to call from within a callback (slot is skipped for the rest
+     *       of the invoke and released once it completes)
+     * @note Idempotent: safe to call multiple times with same ID
+     */
+    void disconnect(Connection id)
+    {
+        if (id == 0)
+        {
+            return;
+        }
+
+        LockGuard<Mutex> lock(m_mutex);
+        if (const auto *staged = findSlot(m_stagedSlots, id))
+        {
+            forgetSlot(*staged);
+            eraseSlot(m_stagedSlots, id);
+            return;
+        }
+
+        auto *slot = findSlot(m_slots, id);
+        if (slot == nullptr)
+        {
+            return;
+        }
+        forgetSlot(*slot);
+
+        if (m_invokeDepth == 0)
+        {
+            eraseSlot(m_slots, id);
+            return;
+        }
+
+        // Invoke in progress - tombstone only, the callback may be executing right now
+        slot->id.store(0, std::memory_order_release);
+        ++m_tombstoneCount;
+    }
+
+    /// Disconnect all subscribers
+    void clear()
+    {
+        LockGuard<Mutex> lock(m_mutex);
+        m_stagedSlots.clear();
+        m_directCount.store(0, std::memory_order_relaxed);
+
+        if (m_invokeDepth == 0)
+        {
+            m_slots.clear();
+            m_tombstoneCount = 0;
+            return;
+        }
+
+        for (auto &slot: m_slots)
+        {
+            if (slot.id.load(std::memory_order_relaxed) != 0)
+            {
+                slot.id.store(0, std::memory_order_release);
+                ++m_tombstoneCount;
+            }
+        }
+    }
+
+    /**
+     * @brief Call every connected callback with the given arguments
+     *
+     * @warning Main loop only (not ISR-safe)
+     *
+     * @par Complexity
+     * O(S) where S = subscriber count, no allocation
+     */
+    template<typename... TArgs>
+    void invoke(TArgs &&...args)
+    {
+        invokeMatching(kAnyMode, args...);
+    }
+
+    /// Call only the Direct callbacks (the owner's inline delivery)
+    template<typename... TArgs>
+    void invokeDirect(TArgs &&...args)
+    {
+        invokeMatching(ConnectionMode::Direct, args...);
+    }
+
+    /// Call only the Queued callbacks (Direct ones already ran at publish time)
+    template<typename... TArgs>
+    void invokeQueued(TArgs &&...args)
+    {
+        invokeMatching(ConnectionMode::Queued, args...);
+    }
+
+    /**
+     * @brief True if any Direct callback is connected
+     *
+     * @note Lock-free, safe from any context; a snapshot that may race with connect()
+     */
+    [[nodiscard]] bool hasDirect() const
+    {
+        return m_directCount.load(std::memory_order_relaxed) != 0;
+    }
+
+    /// Number of connected subscribers
+    [[nodiscard]] std::size_t size() const
+    {
+        LockGuard<Mutex> lock(m_mutex);
+        return m_slots.size() - m_tombstoneCount + m_stagedSlots.size();
+    }
+
+    /// True if no subscribers connected
+    [[nodiscard]] bool empty() const
+    {
+        return size() == 0;
+    }
+
+private:
+    /// Matches slots of either mode in invokeMatching()
+    static constexpr auto kAnyMode{static_cast<ConnectionMode>(0xFF)};
+
+    template<typename... TArgs>
+    void invokeMatching(const ConnectionMode mode, TArgs &&...args)
+    {
+        std::size_t slotCount{0};
+        {
+            LockGuard<Mutex> lock(m_mutex);
+            if (m_slots.empty())
+            {
+                return;
+            }
+            ++m_invokeDepth;
+            slotCount = m_slots.size();
+        }
+
+        // Leaves the frozen state even if a callback throws (ESP32 builds with exceptions)
+        const InvokeScope scope{*this};
+
+        // Iterate in place: the vector cannot reallocate while m_invokeDepth > 0
+        for (std::size_t i{0}; i < slotCount; ++i)
+        {
+            const auto &slot{m_slots[i]};
+            const bool modeMatches{mode == kAnyMode || slot.mode == mode};
+            if (modeMatches && slot.id.load(std::memory_order_acquire) != 0 && slot.callback)
+            {
+                slot.callback(args...);
+            }
+        }
+    }
+
+    /// Subscriber entry; id is atomic so invoke() can skip tombstones without the mutex
+    struct Slot
+    {
+        std::atomic<Connection> id{0};
+        Callback callback;
+        ConnectionMode mode{ConnectionMode::Queued};
+
+        Slot(const Connection slotId, Callback &&slotCallback, const ConnectionMode slotMode)
+            : id(slotId)
+            , callback(std::move(slotCallback))
+            , mode(slotMode)
+        {
+        }
+
+        // Only moved while no invoke is in progress (under m_mutex)
+        Slot(Slot &&other) noexcept
+            : id(other.id.load(std::memory_order_relaxed))
+            , callback(std::move(other.callback))
+            , mode(other.mode)
+        {
+        }
+
+        Slot &operator=(Slot &&other) noexcept
+        {
+            id.store(other.id.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            callback = std::move(other.callback);
+            mode = other.mode;
+            return *this;
+        }
+    };
+
+    /// Ends an invoke pass and folds deferred subscription changes back in
+    struct InvokeScope
+    {
+        SlotList &slots;
+
+        ~InvokeScope()
+        {
+            LockGuard<Mutex> lock(slots.m_mutex);
+            if (--slots.m_invokeDepth == 0)
+            {
+                slots.applyDeferredChanges();
+            }
+        }
+    };
+
+    /// Must be called with m_mutex held and no invoke in progress
+    void applyDeferredChanges()
+    {
+        if (m_tombstoneCount > 0)
+        {
+            eraseSlot(m_slots, 0);
+            m_tombstoneCount = 0;
+        }
+
+        if (!m_stagedSlots.empty())
+        {
+            for (auto &slot: m_stagedSlots)
+            {
+                m_slots.push_back(std::move(slot));
+            }
+            m_stagedSlots.clear();
+        }
+    }
+
+    static Slot *findSlot(std::vector<Slot> &slots, const Connection id)
+    {
+        for (auto &slot: slots)
+        {
+            if (slot.id.load(std::memory_order_relaxed) == id)
+            {
+                return &slot;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Must be called with m_mutex held, once per slot leaving the list
+    void forgetSlot(const Slot &slot)
+    {
+        if (slot.mode == ConnectionMode::Direct)
+        {
+            m_directCount.store(m_directCount.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+        }
+    }
+
+    static void eraseSlot(std::vector<Slot> &slots, const Connection id)
+    {
+        auto it = std::remove_if(slots.begin(), slots.end(),
+                                 [id](const Slot &slot) { return slot.id.load(std::memory_order_relaxed) == id; });
+        slots.erase(it, slots.end());
+    }
+
+    /// Initial slot vector capacity to avoid early reallocations
+    static constexpr std::size_t kInitialSlotCapacity{8};
+
+    mutable Mutex m_mutex;
+    std::vector<Slot> m_slots;
+    std::vector<Slot> m_stagedSlots; ///< Connected during invoke, merged afterwards
+    std::size_t m_tombstoneCount{0}; ///< Slots disconnected during invoke (id == 0)
+    std::atomic<std::uint16_t> m_directCount{0}; ///< Live Direct slots, read lock-free by publishers
+    std::uint8_t m_invokeDepth{0};
+    Connection m_nextId{0};
+};
+} // namespace isic
+
+#endif // ISIC_CORE_SLOT_LIST_HPP
@@ -0,0 +1,456 @@
+#ifndef ISIC_CORE_TIMER_WHEEL_HPP
+#define ISIC_CORE_TIMER_WHEEL_HPP
+
+/**
+ * @file TimerWheel.hpp
+ * @brief Hierarchical timing wheel for one-shot and periodic millisecond timers
+ *
+ * Four levels of 64 buckets with 1 ms, 64 ms, 4.1 s and 262 s granularity
+ * cover 4.6 hours; longer delays are re-filed on the top level. Insert and
+ * cancel are O(1), and a timer is cascaded at most once per level on its way
+ * to expiry. Occupancy bitmaps let advance() jump straight to the next busy
+ * bucket, so a wheel that was idle for minutes catches up in a handful of
+ * steps instead of one per millisecond.
+ */
+
+#include "core/InplaceFunction.hpp"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/// Timers that can be armed at once (override with -DISIC_TIMER_POOL_SIZE=N, max 255)
+#ifndef ISIC_TIMER_POOL_SIZE
+#define ISIC_TIMER_POOL_SIZE 16
+#endif
+
+namespace isic
+{
+struct TimerWheelMetrics
+{
+    std::uint32_t fired{0};     ///< Callback invocations since boot
+    std::uint32_t rejected{0};  ///< schedule() calls refused because the pool was empty
+    std::uint8_t active{0};     ///< Timers currently armed
+    std::uint8_t peakActive{0}; ///< High-water mark of active
+};
+
+/**
+ * @class TimerWheel
+ * @brief Fixed pool of timers filed into a 4-level hashed wheel
+ *
+ * The wheel has no clock of its own: callers pass millis() to schedule()
+ * and advance(). Callbacks run synchronously inside advance() and may
+ * schedule or cancel timers, including their own.
+ *
+ * @par Thread Safety
+ * Main loop only (no locking). Schedule from ISRs or other tasks by
+ * publishing an event and arming the timer from its subscriber.
+ *
+ * @par Periodic Timers
+ * The next deadline is the previous one plus the period, so a periodic
+ * timer does not drift with loop latency. If advance() ran so late that the
+ * next deadline has already passed, the missed periods are skipped rather
+ * than fired back to back.
+ */
+class TimerWheel
+{
+public:
+    using Callback = InplaceFunction<void()>;
+    using TimerId = std::uint32_t;
+
+    static constexpr TimerId kInvalidTimer{0};
+    static constexpr std::size_t kCapacity{ISIC_TIMER_POOL_SIZE};
+    static constexpr std::uint32_t kMaxDelayMs{static_cast<std::uint32_t>(std::numeric_limits<std::int32_t>::max())};
+    static constexpr std::uint32_t kNoDeadline{std::numeric_limits<std::uint32_t>::max()};
+
+    static_assert(kCapacity > 0 && kCapacity < 0xFF, "ISIC_TIMER_POOL_SIZE out of range");
+
+    TimerWheel()
+    {
+        m_heads.fill(kNone);
+        for (std::size_t i{0}; i < kCapacity; ++i)
+        {
+            m_nodes[i].next = static_cast<Index>(i + 1 < kCapacity ? i + 1 : kNone);
+        }
+    }
+
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+    TimerWheel(TimerWheel &&) = delete;
+    TimerWheel &operator=(TimerWheel &&) = delete;
+
+    /**
+     * @brief Arm a timer
+     *
+     * @param nowMs Current millis()
+     * @param delayMs Delay until the first expiry, clamped to kMaxDelayMs
+     * @param periodMs Re-arm interval after each expiry, 0 for one-shot
+     * @param callback Function to run on expiry
+     * @return Handle for cancel(), kInvalidTimer if the callback is empty or
+     *         the pool is exhausted
+     *
+     * @note advance(nowMs) has already consumed tick nowMs, so a zero delay
+     *       armed right after it fires on the following millisecond
+     *
+     * @par Complexity
+     * O(1)
+     */
+    [[nodiscard]] TimerId schedule(const std::uint32_t nowMs, const std::uint32_t delayMs, const std::uint32_t periodMs, Callback callback)
+    {
+        if (!callback || m_freeHead == kNone)
+        {
+            ++m_metrics.rejected;
+            return kInvalidTimer;
+        }
+
+        if (m_metrics.active == 0)
+        {
+            // Nothing filed: re-base the wheel instead of walking the idle gap
+            m_now = nowMs;
+        }
+
+        const auto index{m_freeHead};
+        auto &node{m_nodes[index]};
+        m_freeHead = node.next;
+
+        node.callback = std::move(callback);
+        node.deadline = nowMs + (delayMs < kMaxDelayMs ? delayMs : kMaxDelayMs);
+        node.periodMs = periodMs < kMaxDelayMs ? periodMs : kMaxDelayMs;
+        node.state = State::Armed;
+        file(index);
+
+        ++m_metrics.active;
+        if (m_metrics.active > m_metrics.peakActive)
+        {
+            m_metrics.peakActive = m_metrics.active;
+        }
+        return makeId(index, node.generation);
+    }
+
+    /**
+     * @brief Disarm a timer
+     *
+     * @param id Handle from schedule(); stale or invalid handles are ignored
+     * @return true if the timer was armed (or its callback is running)
+     *
+     * @note Safe from inside any timer callback, including the timer's own
+     */
+    bool cancel(const TimerId id)
+    {
+        auto *node{lookup(id)};
+        if (node == nullptr)
+        {
+            return false;
+        }
+
+        if (node->state == State::Armed)
+        {
+            unfile(static_cast<Index>(id & 0xFF));
+            release(static_cast<Index>(id & 0xFF));
+        }
+        else
+        {
+            // Detached for expiry or running: advance() releases it when it gets there
+            node->state = State::Cancelled;
+        }
+        return true;
+    }
+
+    /// True while @p id waits for its deadline (false once its callback has started)
+    [[nodiscard]] bool isArmed(const TimerId id) const
+    {
+        const auto *node{lookup(id)};
+        return node != nullptr && node->state == State::Armed;
+    }
+
+    /**
+     * @brief Run every timer whose deadline is at or before @p nowMs
+     *
+     * @param nowMs Current millis()
+     * @return Number of callbacks invoked
+     *
+     * @par Complexity
+     * O(E + B) where E = expired timers, B = busy buckets passed (cascades)
+     */
+    std::size_t advance(const std::uint32_t nowMs)
+    {
+        const auto firedBefore{m_metrics.fired};
+
+        while (m_metrics.active != 0)
+        {
+            const auto tick{nextBucketTick()};
+            if (static_cast<std::int32_t>(nowMs - tick) < 0)
+            {
+                break;
+            }
+            processTick(tick, nowMs);
+        }
+
+        // Skip the empty stretch up to now
+        if (static_cast<std::int32_t>(nowMs + 1 - m_now) > 0)
+        {
+            m_now = nowMs + 1;
+        }
+        return m_metrics.fired - firedBefore;
+    }
+
+    /**
+     * @brief Time until advance() next has work to do
+     *
+     * @param nowMs Current millis()
+     * @return 0 if due, kNoDeadline if no timer is armed
+     *
+     * @note A lower bound: for timers filed on an upper level this is the
+     *       cascade point, at which the wheel re-files them more precisely.
+     *       Sleeping for this long never oversleeps a deadline.
+     */
+    [[nodiscard]] std::uint32_t msUntilNext(const std::uint32_t nowMs) const
+    {
+        if (m_metrics.active == 0)
+        {
+            return kNoDeadline;
+        }
+        const auto remaining{static_cast<std::int32_t>(nextBucketTick() - nowMs)};
+        return remaining > 0 ? static_cast<std::uint32_t>(remaining) : 0;
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return m_metrics.active;
+    }
+
+    [[nodiscard]] const TimerWheelMetrics &getMetrics() const noexcept
+    {
+        return m_metrics;
+    }
+
+private:
+    using Index = std::uint8_t;
+    static constexpr Index kNone{0xFF};
+    static constexpr std::size_t kLevels{4};
+    static constexpr std::size_t kSlotBits{6};
+    static constexpr std::size_t kSlots{1U << kSlotBits};
+    static constexpr std::uint32_t kSlotMask{kSlots - 1};
+    /// Furthest a timer can be filed from m_now; longer delays are re-filed when their bucket comes up
+    static constexpr std::uint32_t kWheelSpan{(1U << (kSlotBits * kLevels)) - 1};
+
+    enum class State : std::uint8_t
+    {
+        Free,
+        Armed,     ///< Filed in a bucket
+        Expiring,  ///< Detached from its bucket by advance(), callback pending or running
+        Cancelled, ///< cancel() while Expiring, released once advance() reaches it
+    };
+
+    struct Node
+    {
+        Callback callback;
+        std::uint32_t deadline{0};
+        std::uint32_t periodMs{0};
+        std::uint16_t generation{1}; ///< Bumped on release so stale handles miss
+        Index next{kNone};
+        Index prev{kNone};
+        std::uint8_t bucket{0}; ///< level * kSlots + slot while Armed
+        State state{State::Free};
+    };
+
+    static constexpr TimerId makeId(const Index index, const std::uint16_t generation)
+    {
+        return (static_cast<TimerId>(generation) << 8) | index;
+    }
+
+    static constexpr std::uint32_t levelShift(const std::size_t level)
+    {
+        return static_cast<std::uint32_t>(level * kSlotBits);
+    }
+
+    [[nodiscard]] const Node *lookup(const TimerId id) const
+    {
+        const auto index{static_cast<Index>(id & 0xFF)};
+        if (id == kInvalidTimer || index >= kCapacity)
+        {
+            return nullptr;
+        }
+        const auto &node{m_nodes[index]};
+        const bool live{node.state != State::Free && makeId(index, node.generation) == id};
+        return live ? &node : nullptr;
+    }
+
+    [[nodiscard]] Node *lookup(const TimerId id)
+    {
+        return const_cast<Node *>(static_cast<const TimerWheel *>(this)->lookup(id));
+    }
+
+    /// File an Armed node into the bucket that comes up next at or before its deadline
+    void file(const Index index)
+    {
+        auto &node{m_nodes[index]};
+        const auto delta{static_cast<std::int32_t>(node.deadline - m_now)};
+        const auto span{delta > 0 ? static_cast<std::uint32_t>(delta) : 0U};
+        const auto when{m_now + (span < kWheelSpan ? span : kWheelSpan)};
+
+        std::size_t level{0};
+        while (level + 1 < kLevels && (span >> levelShift(level + 1)) != 0)
+        {
+            ++level;
+        }
+
+        const auto slot{(when >> levelShift(level)) & kSlotMask};
+        const auto bucket{static_cast<std::uint8_t>(level * kSlots + slot)};
+
+        node.bucket = bucket;
+        node.prev = kNone;
+        node.next = m_heads[bucket];
+        if (node.next != kNone)
+        {
+            m_nodes[node.next].prev = index;
+        }
+        m_heads[bucket] = index;
+        m_occupied[level] |= (std::uint64_t{1} << slot);
+    }
+
+    void unfile(const Index index)
+    {
+        auto &node{m_nodes[index]};
+        if (node.prev != kNone)
+        {
+            m_nodes[node.prev].next = node.next;
+        }
+        else
+        {
+            m_heads[node.bucket] = node.next;
+            if (node.next == kNone)
+            {
+                m_occupied[node.bucket / kSlots] &= ~(std::uint64_t{1} << (node.bucket % kSlots));
+            }
+        }
+        if (node.next != kNone)
+        {
+            m_nodes[node.next].prev = node.prev;
+        }
+    }
+
+    void release(const Index index)
+    {
+        auto &node{m_nodes[index]};
+        node.callback = Callback{};
+        node.state = State::Free;
+        node.generation = static_cast<std::uint16_t>(node.generation == 0xFFFF ? 1 : node.generation + 1);
+        node.prev = kNone;
+        node.next = m_freeHead;
+        m_freeHead = index;
+        --m_metrics.active;
+    }
+
+    /// Take a whole bucket off the wheel, returns its list head
+    Index detach(const std::size_t level, const std::uint32_t slot)
+    {
+        const auto bucket{level * kSlots + slot};
+        const auto head{m_heads[bucket]};
+        m_heads[bucket] = kNone;
+        m_occupied[level] &= ~(std::uint64_t{1} << slot);
+        return head;
+    }
+
+    /// Earliest tick at which a non-empty bucket is processed (requires active timers)
+    [[nodiscard]] std::uint32_t nextBucketTick() const
+    {
+        auto best{m_now + kWheelSpan};
+        for (std::size_t level{0}; level < kLevels; ++level)
+        {
+            const auto occupied{m_occupied[level]};
+            if (occupied == 0)
+            {
+                continue;
+            }
+
+            // First tick >= m_now on this level's grid, then the first busy slot from there
+            const auto granularityMask{(1U << levelShift(level)) - 1};
+            const auto start{(m_now + granularityMask) & ~granularityMask};
+            const auto startSlot{(start >> levelShift(level)) & kSlotMask};
+            const auto rotated{startSlot == 0 ? occupied : (occupied >> startSlot) | (occupied << (kSlots - startSlot))};
+            const auto distance{static_cast<std::uint32_t>(__builtin_ctzll(rotated))};
+            const auto tick{start + (distance << levelShift(level))};
+
+            if (static_cast<std::int32_t>(tick - best) < 0)
+            {
+                best = tick;
+            }
+        }
+        return best;
+    }
+
+    void processTick(const std::uint32_t tick, const std::uint32_t nowMs)
+    {
+        m_now = tick;
+
+        // Upper levels first: a cascade may drop timers into a lower bucket due at this same tick
+        for (std::size_t level{kLevels - 1}; level > 0; --level)
+        {
+            if ((tick & ((1U << levelShift(level)) - 1)) != 0)
+            {
+                continue;
+            }
+            auto index{detach(level, (tick >> levelShift(level)) & kSlotMask)};
+            while (index != kNone)
+            {
+                const auto next{m_nodes[index].next};
+                file(index);
+                index = next;
+            }
+        }
+
+        // Timers armed by the callbacks below are filed from the next tick on
+        m_now = tick + 1;
+        expire(detach(0, tick & kSlotMask), nowMs);
+    }
+
+    /// Run a detached bucket, then re-file periodic timers and release the rest
+    void expire(const Index head, const std::uint32_t nowMs)
+    {
+        // Mark the whole batch first: a callback may cancel a timer further down the list
+        for (auto index{head}; index != kNone; index = m_nodes[index].next)
+        {
+            m_nodes[index].state = State::Expiring;
+        }
+
+        auto index{head};
+        while (index != kNone)
+        {
+            auto &node{m_nodes[index]};
+            const auto next{node.next};
+
+            if (node.state == State::Expiring)
+            {
+                ++m_metrics.fired;
+                node.callback();
+            }
+
+            if (node.state == State::Expiring && node.periodMs != 0)
+            {
+                node.deadline += node.periodMs;
+                if (static_cast<std::int32_t>(node.deadline - nowMs) <= 0)
+                {
+                    node.deadline = nowMs + node.periodMs; // Late: skip the missed periods
+                }
+                node.state = State::Armed;
+                file(index);
+            }
+            else
+            {
+                release(index);
+            }
+            index = next;
+        }
+    }
+
+    std::array<Node, kCapacity> m_nodes{};
+    std::array<Index, kLevels * kSlots> m_heads{};
+    std::array<std::uint64_t, kLevels> m_occupied{};
+    std::uint32_t m_now{0}; ///< Next tick not yet processed
+    Index m_freeHead{0};
+    TimerWheelMetrics m_metrics{};
+};
+} // namespace isic
+
+#endif // ISIC_CORE_TIMER_WHEEL_HPP
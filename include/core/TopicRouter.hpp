@@ -0,0 +1,298 @@
+#ifndef ISIC_CORE_TOPIC_ROUTER_HPP
+#define ISIC_CORE_TOPIC_ROUTER_HPP
+
+/**
+ * @file TopicRouter.hpp
+ * @brief MQTT topic-filter trie for routing inbound messages
+ *
+ * Services register topic filters (relative to the device topic prefix,
+ * with MQTT '+' and '#' wildcards) once at construction. Each inbound topic
+ * is split into levels a single time and walked down the trie, so only the
+ * handlers whose filter matches run - no per-service string scans, and the
+ * cost depends on the topic depth, not on how many services listen.
+ */
+
+#include "core/InplaceFunction.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace isic
+{
+/**
+ * @brief Inbound topic split into levels, relative to the device prefix
+ *
+ * Views into the MQTT client's receive buffer: valid only for the duration
+ * of the handler call.
+ */
+class TopicView
+{
+public:
+    static constexpr std::size_t kMaxLevels{8};
+
+    TopicView() = default;
+
+    /**
+     * @brief Split @p topic on '/'
+     *
+     * @return false if the topic has more than kMaxLevels levels
+     */
+    bool assign(const std::string_view topic)
+    {
+        m_topic = topic;
+        m_count = 0;
+
+        std::size_t start{0};
+        while (true)
+        {
+            if (m_count == kMaxLevels)
+            {
+                return false;
+            }
+            const auto end{topic.find('/', start)};
+            m_levels[m_count++] = topic.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+            if (end == std::string_view::npos)
+            {
+                return true;
+            }
+            start = end + 1;
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return m_count;
+    }
+
+    /// Level @p index, empty view if out of range
+    [[nodiscard]] std::string_view operator[](const std::size_t index) const
+    {
+        return index < m_count ? m_levels[index] : std::string_view{};
+    }
+
+    /// Whole relative topic, e.g. "config/set/wifi"
+    [[nodiscard]] std::string_view str() const
+    {
+        return m_topic;
+    }
+
+private:
+    std::string_view m_topic{};
+    std::array<std::string_view, kMaxLevels> m_levels{};
+    std::size_t m_count{0};
+};
+
+/**
+ * @class TopicRouter
+ * @brief Routes inbound MQTT messages to the handlers of matching filters
+ *
+ * @par Filters
+ * Standard MQTT syntax relative to the device prefix: "health/request",
+ * "config/set/#" (also matches "config/set"), "ota/+/chunk". '#' must be
+ * the last level, wildcards must fill a whole level.
+ *
+ * @par Broker Subscriptions
+ * MqttService subscribes to every filter registered with
+ * Subscription::Broker on each connect. Subscription::Local routes only
+ * what arrives anyway, e.g. a "#" activity tap that must not subscribe the
+ * device to its own published topics.
+ *
+ * @par Thread Safety
+ * Register routes during construction/setup only. route() runs from
+ * MqttService::loop() (main loop); handlers run synchronously there, so keep
+ * them short and defer heavy work (e.g. via a flag or a bus event).
+ *
+ * @par Usage
+ * @code
+ * router.addRoute("config/set/#", [this](const TopicView &topic, std::string_view payload) {
+ *     applyConfig(topic[2], payload);  // "wifi" for config/set/wifi
+ * });
+ * @endcode
+ */
+class TopicRouter
+{
+public:
+    using Handler = InplaceFunction<void(const TopicView &, std::string_view)>;
+
+    enum class Subscription : std::uint8_t
+    {
+        Broker, ///< Subscribe to the filter on the broker (default)
+        Local,  ///< Only match messages received for other subscriptions
+    };
+
+    TopicRouter()
+    {
+        m_nodes.reserve(kInitialNodeCapacity);
+        m_nodes.emplace_back(); // Root, matches the empty prefix
+    }
+
+    TopicRouter(const TopicRouter &) = delete;
+    TopicRouter &operator=(const TopicRouter &) = delete;
+    TopicRouter(TopicRouter &&) = delete;
+    TopicRouter &operator=(TopicRouter &&) = delete;
+
+    /**
+     * @brief Register a handler for a topic filter
+     *
+     * @param filter Topic filter relative to the device prefix
+     * @param handler Called with the split topic and the payload bytes
+     * @param subscription Whether MqttService should subscribe to the filter
+     * @return false if the filter is malformed or the handler is empty
+     */
+    bool addRoute(const std::string_view filter, Handler handler, const Subscription subscription = Subscription::Broker)
+    {
+        TopicView levels;
+        if (!handler || filter.empty() || !levels.assign(filter))
+        {
+            return false;
+        }
+        if (m_routes.size() >= kNone || m_nodes.size() + levels.size() >= kNone)
+        {
+            return false;
+        }
+
+        std::size_t node{kRoot};
+        for (std::size_t i{0}; i < levels.size(); ++i)
+        {
+            const auto level{levels[i]};
+            const bool wildcardLevel{level == "+" || level == "#"};
+            const bool misplacedWildcard{level.find_first_of("+#") != std::string_view::npos && !wildcardLevel};
+            if (misplacedWildcard || (level == "#" && i + 1 != levels.size()))
+            {
+                return false;
+            }
+            node = findOrAddChild(node, level);
+        }
+
+        m_routes.push_back({std::string{filter}, std::move(handler), m_nodes[node].firstRoute, subscription});
+        m_nodes[node].firstRoute = static_cast<Index>(m_routes.size() - 1);
+        return true;
+    }
+
+    /**
+     * @brief Invoke every handler whose filter matches @p topic
+     *
+     * @param topic Split topic, relative to the device prefix
+     * @param payload Message bytes (not NUL-terminated)
+     * @return Number of handlers invoked
+     *
+     * @par Complexity
+     * O(L * B) where L = topic levels, B = children per trie node; independent
+     * of the total number of routes
+     */
+    std::size_t route(const TopicView &topic, const std::string_view payload) const
+    {
+        return topic.size() == 0 ? 0 : match(kRoot, topic, 0, payload);
+    }
+
+    /// Call @p fn(const std::string &filter) for every Subscription::Broker filter
+    template<typename Fn>
+    void forEachSubscription(Fn &&fn) const
+    {
+        for (const auto &route: m_routes)
+        {
+            if (route.subscription == Subscription::Broker)
+            {
+                fn(route.filter);
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t routeCount() const
+    {
+        return m_routes.size();
+    }
+
+private:
+    using Index = std::uint8_t;
+    static constexpr Index kNone{0xFF};
+    static constexpr std::size_t kRoot{0};
+    static constexpr std::size_t kInitialNodeCapacity{16};
+
+    /// Trie node: one topic level, children as a sibling chain, routes as a chain
+    struct Node
+    {
+        std::string level{};
+        Index firstChild{kNone};
+        Index nextSibling{kNone};
+        Index firstRoute{kNone};
+    };
+
+    struct Route
+    {
+        std::string filter;
+        Handler handler;
+        Index nextRoute{kNone};
+        Subscription subscription{Subscription::Broker};
+    };
+
+    std::size_t findOrAddChild(const std::size_t parent, const std::string_view level)
+    {
+        for (auto child{m_nodes[parent].firstChild}; child != kNone; child = m_nodes[child].nextSibling)
+        {
+            if (m_nodes[child].level == level)
+            {
+                return child;
+            }
+        }
+
+        m_nodes.push_back({std::string{level}, kNone, m_nodes[parent].firstChild, kNone});
+        const auto index{static_cast<Index>(m_nodes.size() - 1)};
+        m_nodes[parent].firstChild = index;
+        return index;
+    }
+
+    std::size_t match(const std::size_t node, const TopicView &topic, const std::size_t depth, const std::string_view payload) const
+    {
+        std::size_t invoked{0};
+
+        if (depth == topic.size())
+        {
+            // "a/#" also matches "a" itself
+            invoked += invokeRoutes(node, topic, payload);
+            for (auto child{m_nodes[node].firstChild}; child != kNone; child = m_nodes[child].nextSibling)
+            {
+                if (m_nodes[child].level == "#")
+                {
+                    invoked += invokeRoutes(child, topic, payload);
+                }
+            }
+            return invoked;
+        }
+
+        const auto level{topic[depth]};
+        for (auto child{m_nodes[node].firstChild}; child != kNone; child = m_nodes[child].nextSibling)
+        {
+            const auto &childLevel{m_nodes[child].level};
+            if (childLevel == "#")
+            {
+                invoked += invokeRoutes(child, topic, payload);
+            }
+            else if (childLevel == "+" || childLevel == level)
+            {
+                invoked += match(child, topic, depth + 1, payload);
+            }
+        }
+        return invoked;
+    }
+
+    std::size_t invokeRoutes(const std::size_t node, const TopicView &topic, const std::string_view payload) const
+    {
+        std::size_t invoked{0};
+        for (auto route{m_nodes[node].firstRoute}; route != kNone; route = m_routes[route].nextRoute)
+        {
+            m_routes[route].handler(topic, payload);
+            ++invoked;
+        }
+        return invoked;
+    }
+
+    std::vector<Node> m_nodes;
+    std::vector<Route> m_routes;
+};
+} // namespace isic
+
+#endif // ISIC_CORE_TOPIC_ROUTER_HPP
@@ -0,0 +1,196 @@
+#ifndef ISIC_CORE_TRACE_HPP
+#define ISIC_CORE_TRACE_HPP
+
+/**
+ * @file Trace.hpp
+ * @brief Compact binary timeline of EventBus traffic and scheduler tasks
+ *
+ * Records publish, dispatch-begin and dispatch-end of every event plus the
+ * begin/end of every App scheduler task into a fixed ring of 8-byte records,
+ * so the milliseconds between a card tap and its MQTT publish can be read
+ * off a timeline. Dumped over the serial inspector protocol (FS_CMD:TRACE)
+ * and converted to Chrome trace JSON by tools/trace_to_chrome.py.
+ *
+ * Only compiled with ISIC_ENABLE_TRACE. Without it the ISIC_TRACE_* macros
+ * expand to nothing: no code, no RAM, no clock reads.
+ */
+
+/// Records kept (power of two, 8 bytes each); the oldest are overwritten
+#ifndef ISIC_TRACE_CAPACITY
+#define ISIC_TRACE_CAPACITY 256
+#endif
+
+#ifdef ISIC_ENABLE_TRACE
+
+#include "platform/PlatformAtomic.hpp"
+
+#include <Arduino.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace isic::trace
+{
+enum class Phase : std::uint8_t
+{
+    Publish,
+    DispatchBegin,
+    DispatchEnd,
+    TaskBegin,
+    TaskEnd,
+};
+
+/// Context a record was taken in: the running App scheduler task, or an ISR
+enum class Source : std::uint8_t
+{
+    Unknown,
+    Isr,
+    EventBus,
+    Config,
+    WiFi,
+    Mqtt,
+    Pn532,
+    Feedback,
+    Ota,
+    Power,
+    _Count
+};
+
+inline constexpr const char *kSourceNames[]{"unknown", "isr", "event_bus", "config", "wifi", "mqtt", "pn532", "feedback", "ota", "power"};
+static_assert(sizeof(kSourceNames) / sizeof(kSourceNames[0]) == static_cast<std::size_t>(Source::_Count), "kSourceNames out of sync with Source");
+
+inline constexpr std::uint8_t kNoEventType{0xFF}; ///< eventType of task records
+inline constexpr std::uint8_t kFlagDirect{0x01};  ///< Delivered inline by publish() (Direct connection)
+inline constexpr std::uint8_t kFlagRefused{0x02}; ///< publish() refused by the type's OverflowPolicy
+
+/// One trace entry; dumped byte for byte (little-endian), so the layout is the wire format
+struct Record
+{
+    std::uint32_t timestampUs;
+    Phase phase;
+    std::uint8_t eventType;
+    Source source;
+    std::uint8_t flags;
+};
+static_assert(sizeof(Record) == 8, "Record layout is the trace dump format");
+
+/**
+ * @class Recorder
+ * @brief Lock-free ring of trace records
+ *
+ * @par Thread Safety
+ * record() claims its slot with one compare-exchange and is safe from any
+ * task or ISR. forEach() pauses recording while it walks the ring.
+ */
+class Recorder
+{
+public:
+    static constexpr std::size_t kCapacity{ISIC_TRACE_CAPACITY};
+    static_assert(kCapacity != 0 && (kCapacity & (kCapacity - 1)) == 0, "ISIC_TRACE_CAPACITY must be a power of two");
+
+    Recorder(const Recorder &) = delete;
+    Recorder &operator=(const Recorder &) = delete;
+
+    static Recorder &instance()
+    {
+        static Recorder recorder;
+        return recorder;
+    }
+
+    void record(const Phase phase, const std::uint8_t eventType, const std::uint8_t flags = 0)
+    {
+        if (!m_enabled.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        const Record entry{static_cast<std::uint32_t>(micros()), phase, eventType,
+                           inInterruptContext() ? Source::Isr : m_currentSource.load(std::memory_order_relaxed), flags};
+
+        auto head{m_head.load(std::memory_order_relaxed)};
+        while (!atomicCompareExchange(m_head, head, head + 1))
+        {
+        }
+        m_records[head & (kCapacity - 1)] = entry;
+    }
+
+    /// Mark @p source as running; returns the source to restore in leaveTask()
+    Source enterTask(const Source source)
+    {
+        const auto previous{m_currentSource.load(std::memory_order_relaxed)};
+        m_currentSource.store(source, std::memory_order_relaxed);
+        record(Phase::TaskBegin, kNoEventType);
+        return previous;
+    }
+
+    void leaveTask(const Source previous)
+    {
+        record(Phase::TaskEnd, kNoEventType);
+        m_currentSource.store(previous, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Call @p fn(const Record &) for every retained record, oldest first
+     *
+     * @return Total records taken since boot; more than kCapacity means the
+     *         oldest were overwritten
+     */
+    template<typename Fn>
+    std::uint32_t forEach(Fn &&fn)
+    {
+        m_enabled.store(false, std::memory_order_relaxed);
+        const auto total{m_head.load(std::memory_order_acquire)};
+        const auto retained{total < kCapacity ? total : static_cast<std::uint32_t>(kCapacity)};
+        for (auto index{total - retained}; index != total; ++index)
+        {
+            fn(m_records[index & (kCapacity - 1)]);
+        }
+        m_enabled.store(true, std::memory_order_relaxed);
+        return total;
+    }
+
+private:
+    Recorder() = default;
+
+    std::array<Record, kCapacity> m_records{};
+    std::atomic<std::uint32_t> m_head{0};
+    std::atomic<Source> m_currentSource{Source::Unknown};
+    std::atomic<bool> m_enabled{true};
+};
+
+/// Brackets a scheduler task callback with TaskBegin/TaskEnd
+class TaskScope
+{
+public:
+    explicit TaskScope(const Source source)
+        : m_previous{Recorder::instance().enterTask(source)}
+    {
+    }
+
+    ~TaskScope()
+    {
+        Recorder::instance().leaveTask(m_previous);
+    }
+
+    TaskScope(const TaskScope &) = delete;
+    TaskScope &operator=(const TaskScope &) = delete;
+
+private:
+    Source m_previous;
+};
+} // namespace isic::trace
+
+/// Record an event phase, e.g. ISIC_TRACE_EVENT(Publish, type, 0)
+#define ISIC_TRACE_EVENT(phase, type, flags) \
+    ::isic::trace::Recorder::instance().record(::isic::trace::Phase::phase, static_cast<std::uint8_t>(type), (flags))
+
+/// Trace the enclosing scope as scheduler task @p source, e.g. ISIC_TRACE_TASK(Mqtt)
+#define ISIC_TRACE_TASK(source) const ::isic::trace::TaskScope isicTraceTask_{::isic::trace::Source::source}
+
+#else
+
+#define ISIC_TRACE_EVENT(phase, type, flags) ((void) 0)
+#define ISIC_TRACE_TASK(source) ((void) 0)
+
+#endif // ISIC_ENABLE_TRACE
+#endif // ISIC_CORE_TRACE_HPP
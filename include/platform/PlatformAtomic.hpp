@@ -0,0 +1,181 @@
+#ifndef ISIC_PLATFORM_ATOMIC_HPP
+#define ISIC_PLATFORM_ATOMIC_HPP
+
+/**
+ * @file PlatformAtomic.hpp
+ * @brief ISR-safe atomic index operations and critical sections
+ *
+ * ESP32 has a native compare-and-swap instruction, so these helpers map
+ * directly onto std::atomic. ESP8266 (LX106) has none; there the
+ * read-modify-write is wrapped in an interrupt mask that covers only the
+ * compare and the store, never any user code.
+ *
+ * CriticalSection guards multi-word updates (e.g. linking a list node) that
+ * a single CAS cannot cover. It is usable from ISRs on both platforms.
+ *
+ * inInterruptContext()/currentTaskId() let callers decide whether it is safe
+ * to run user code inline (see EventBus direct connections).
+ */
+
+#include <atomic>
+#include <cstdint>
+
+// ============================================================================
+// ESP32 Implementation - Native Atomics
+// ============================================================================
+
+#if defined(ARDUINO_ARCH_ESP32) || defined(ISIC_PLATFORM_ESP32)
+
+#include <Arduino.h>
+
+namespace isic
+{
+/**
+ * @brief Atomically replace @p target with @p desired if it equals @p expected
+ *
+ * @param target Index to update
+ * @param expected Value the caller last observed; refreshed on failure
+ * @param desired Value to store on success
+ * @return true if the swap happened
+ *
+ * @note ISR-safe, never blocks
+ */
+inline bool atomicCompareExchange(std::atomic<std::uint32_t> &target, std::uint32_t &expected, const std::uint32_t desired)
+{
+    return target.compare_exchange_weak(expected, desired, std::memory_order_acq_rel, std::memory_order_relaxed);
+}
+
+/// True when called from an interrupt handler
+inline bool inInterruptContext()
+{
+    return xPortInIsrContext();
+}
+
+/// Opaque id of the calling task, never 0
+inline std::uintptr_t currentTaskId()
+{
+    return reinterpret_cast<std::uintptr_t>(xTaskGetCurrentTaskHandle());
+}
+
+/**
+ * @class CriticalSection
+ * @brief ISR-safe spinlock for a few instructions of shared-state update
+ *
+ * Masks interrupts on the calling core and spins against the other core.
+ * BasicLockable, so it works with LockGuard.
+ *
+ * @warning Never call user code or allocate while holding it
+ */
+class CriticalSection
+{
+public:
+    CriticalSection() = default;
+
+    CriticalSection(const CriticalSection &) = delete;
+    CriticalSection &operator=(const CriticalSection &) = delete;
+
+    void lock()
+    {
+        portENTER_CRITICAL_SAFE(&m_mux);
+    }
+
+    void unlock()
+    {
+        portEXIT_CRITICAL_SAFE(&m_mux);
+    }
+
+private:
+    portMUX_TYPE m_mux = portMUX_INITIALIZER_UNLOCKED;
+};
+} // namespace isic
+
+// ============================================================================
+// ESP8266 Implementation - Interrupt Mask Around Index Bump
+// ============================================================================
+
+#elif defined(ARDUINO_ARCH_ESP8266) || defined(ISIC_PLATFORM_ESP8266)
+
+#include <Arduino.h>
+
+namespace isic
+{
+/**
+ * @brief Atomically replace @p target with @p desired if it equals @p expected
+ *
+ * Single-core LX106 has no CAS instruction, so interrupts are masked for the
+ * compare and store only (a handful of cycles). The previous interrupt level
+ * is restored, so this is safe to nest inside an ISR.
+ *
+ * @param target Index to update
+ * @param expected Value the caller last observed; refreshed on failure
+ * @param desired Value to store on success
+ * @return true if the swap happened
+ */
+inline bool atomicCompareExchange(std::atomic<std::uint32_t> &target, std::uint32_t &expected, const std::uint32_t desired)
+{
+    const auto savedPs{xt_rsil(15)};
+    const auto current{target.load(std::memory_order_relaxed)};
+    const bool swapped{current == expected};
+    if (swapped)
+    {
+        target.store(desired, std::memory_order_relaxed);
+    }
+    else
+    {
+        expected = current;
+    }
+    xt_wsr_ps(savedPs);
+    return swapped;
+}
+
+/// True when called from an interrupt handler (or with interrupts masked): PS.INTLEVEL > 0
+inline bool inInterruptContext()
+{
+    std::uint32_t ps{0};
+    __asm__ __volatile__("rsr %0, ps" : "=a"(ps));
+    return (ps & 0x0F) != 0;
+}
+
+/// Opaque id of the calling task, never 0 (no RTOS tasks: everything runs in loop context)
+inline std::uintptr_t currentTaskId()
+{
+    return 1;
+}
+
+/**
+ * @class CriticalSection
+ * @brief ISR-safe interrupt mask for a few instructions of shared-state update
+ *
+ * Saves the interrupt level on lock() and restores it on unlock(), so it
+ * nests correctly inside an ISR. BasicLockable, so it works with LockGuard.
+ *
+ * @warning Never call user code or allocate while holding it
+ */
+class CriticalSection
+{
+public:
+    CriticalSection() = default;
+
+    CriticalSection(const CriticalSection &) = delete;
+    CriticalSection &operator=(const CriticalSection &) = delete;
+
+    void lock()
+    {
+        m_savedPs = xt_rsil(15);
+    }
+
+    void unlock()
+    {
+        xt_wsr_ps(m_savedPs);
+    }
+
+private:
+    std::uint32_t m_savedPs{0};
+};
+} // namespace isic
+
+#else
+#error "Unsupported platform: Define ARDUINO_ARCH_ESP32 or ARDUINO_ARCH_ESP8266"
+#endif
+
+#endif // ISIC_PLATFORM_ATOMIC_HPP
@@ -6,14 +6,23 @@
  * @brief Attendance recording and batching service
  *
  * Handles card scan processing, batching, and offline buffering before
- * publishing to the backend.
+ * publishing to the backend. Offline records go to a LittleFS journal
+ * (utils::AttendanceJournal) that survives reboots and sleep, and are only
+ * dropped from it once MqttService reports the publish went out; the RAM
+ * buffer of offlineBufferSize records is the fallback when the journal is
+ * disabled or cannot be opened.
+ *
+ * Online batches take the same receipt path: a batch is held until its
+ * MqttPublished comes back, and goes back to the front of the next batch if
+ * the publish fails, is evicted from the bus queue, or the link drops first.
  */
 
 #include "common/Config.hpp"
+#include "core/DebounceTable.hpp"
 #include "core/EventBus.hpp"
 #include "core/IService.hpp"
+#include "utils/AttendanceJournal.hpp"
 
-#include <array>
 #include <vector>
 
 namespace isic
@@ -44,9 +53,10 @@ public:
         return m_batch.size();
     }
 
+    /// Records waiting for the broker: journal size when it is in use, else the RAM buffer
     [[nodiscard]] std::size_t getOfflineBufferSize() const noexcept
     {
-        return m_offlineBatch.size();
+        return m_journalReady ? m_journal.size() : m_offlineBatch.size();
     }
 
     [[nodiscard]] bool isOfflineMode() const noexcept
@@ -59,19 +69,95 @@ public:
         obj["state"] = toString(getState());
         obj["cards_processed"] = m_metrics.cardsProcessed;
         obj["cards_debounced"] = m_metrics.cardsDebounced;
+        obj["debounce_entries"] = m_debounceTable.getMetrics().entries;
+        obj["debounce_evictions"] = m_debounceTable.getMetrics().evictions;
         obj["batches_sent"] = m_metrics.batchesSent;
+        obj["offline_records_sent"] = m_metrics.offlineRecordsSent;
+        obj["offline_drain_rps"] = m_metrics.offlineDrainRecordsPerSec;
+        obj["journal_records"] = m_journalReady ? m_journal.size() : 0;
+        obj["journal_dropped"] = m_journal.getMetrics().dropped;
+        obj["journal_corrupt"] = m_journal.getMetrics().corrupt + m_journal.getMetrics().recovered;
         obj["errors"] = m_metrics.errorCount;
     }
 
-private:
+    /**
+     * @brief Debounce check for a tap, remembering the card when it passes
+     *
+     * @return false if the same card was seen less than debounceIntervalMs ago
+     *
+     * @note O(1): AttendanceConfig::debounceCacheSize cards are remembered
+     *       whatever the crowd, see DebounceTable
+     */
     [[nodiscard]] bool shouldProcessCard(const CardUid &cardUid, std::uint32_t timestampMs) noexcept;
+
+    /**
+     * @brief Copy @p records into a pooled block, as the source of an attendance publish
+     *
+     * The block holds the records as they are in RAM (16 bytes each) plus the
+     * unix time and millis() of packing; writeBatchJson() or writeBatchPacked()
+     * turns it into the wire format while MqttService streams it to the socket.
+     *
+     * @param bootSequence Last sequence number taken before this boot: older
+     *        records have a timestampMs from another millis() epoch
+     *
+     * @return Empty if no buffer could be obtained
+     */
+    [[nodiscard]] static PayloadBuffer packBatch(const std::vector<AttendanceRecord> &records, std::uint32_t bootSequence = 0);
+
+    /**
+     * @brief PayloadWriter for packBatch() blocks: the JSON array of the records
+     *
+     * Formats a few records at a time into a 256-byte stack buffer and hands
+     * each fill to @p out, so no full copy of the JSON exists anywhere.
+     *
+     * @param out Null to only measure
+     * @return Bytes of JSON (written to @p out, if given)
+     */
+    static std::size_t writeBatchJson(std::string_view packed, Print *out);
+
+    /**
+     * @brief PayloadWriter for packBatch() blocks: AttendanceConfig::PayloadFormat::Packed
+     *
+     * Little-endian, varints are LEB128 (7 bits per byte, low group first):
+     *
+     *   u8      format version (1)
+     *   varint  record count
+     *   u64     unix time in ms when the batch was packed (the JSON "ts"), 0 if unknown
+     *   varint  sequence number of the first record
+     *   per record:
+     *     u8[7]   card UID as read (the JSON "uid" is these bytes reversed, in hex)
+     *     varint  zigzag(sequence - (previous sequence + 1)), 0 while numbering is contiguous
+     *     varint  age + 1: ms from the tap to the packing; 0 if taken before the last reboot
+     *
+     * About 10 bytes per record against 53 for JSON; tools/attendance_decode.py
+     * is the reference decoder.
+     */
+    static std::size_t writeBatchPacked(std::string_view packed, Print *out);
+
+private:
     void processCard(const CardEvent &card);
 
     void addToBatch(const AttendanceRecord &record);
     void flushBatch();
+    void armBatchFlush(std::uint32_t delayMs);
+
+    /**
+     * @brief Hand a packBatch() block to MqttService in the configured payload format
+     * @return false if the bus refused the request
+     */
+    bool publishBatch(const PayloadBuffer &packed, bool confirm);
 
     void addToOfflineBatch(const AttendanceRecord &record);
+    /// Publish the oldest offline records, at most one MQTT packet's worth; the rest follow one chunk per dispatch
     void flushOfflineBatch();
+    void armOfflineRetry();
+
+    void addToJournal(const AttendanceRecord &record);
+    void onChunkReceipt(const MqttEvent &mqtt, bool published);
+    void scheduleNextChunk();
+    void clearChunk();
+    /// Give up on the publish in flight: an online batch goes back to the front of m_batch, a backlog chunk is re-read
+    void releaseChunk();
 
     void flush();
 
@@ -85,21 +171,32 @@ private:
 
     // Current batch
     std::vector<AttendanceRecord> m_batch{};
-    std::uint32_t m_batchStartMs{0};
+    EventBus::TimerId m_batchFlushTimer{EventBus::kInvalidTimer};
     std::uint32_t m_sequenceNumber{0};
+    std::uint32_t m_bootSequence{0}; ///< m_sequenceNumber after begin(): records up to it come from an earlier boot
 
     // Offline buffer
     std::vector<AttendanceRecord> m_offlineBatch{};
-    std::uint32_t m_lastOfflineRetryMs{0};
-
-    // Debounce cache
-    struct DebounceEntry
-    {
-        CardUid uid{};
-        std::uint32_t lastSeenMs{0};
-    };
-    std::array<DebounceEntry, AttendanceConfig::Constants::kDebounceCacheSize> m_debounceCache{};
-    std::uint8_t m_debounceCacheIndex{0};
+    EventBus::TimerId m_offlineRetryTimer{EventBus::kInvalidTimer};
+
+    // Flash journal behind the offline path, opened by begin() when journalEnabled
+    utils::AttendanceJournal m_journal{};
+    bool m_journalReady{false};
+    EventBus::TimerId m_journalFlushTimer{EventBus::kInvalidTimer};
+
+    // Publish in flight, at most one: an offline chunk removed from the journal or RAM buffer when its MqttPublished
+    // comes back, or an online batch whose records exist nowhere else until then
+    std::vector<AttendanceRecord> m_chunkRecords{};
+    PayloadBuffer m_chunkPayload{};
+    std::uint32_t m_chunkFrames{0}; ///< Journal frames (corrupt ones included) or buffered records it covers
+    bool m_chunkFromBatch{false};   ///< The chunk is an online batch, m_chunkFrames is 0
+
+    // Current offline drain, for AttendanceMetrics::offlineDrainRecordsPerSec
+    std::uint32_t m_drainStartMs{0};
+    std::uint32_t m_drainRecords{0};
+
+    // Cards seen within debounceIntervalMs, sized by begin()
+    DebounceTable m_debounceTable{};
 
     // Event subscriptions
     std::vector<EventBus::ScopedConnection> m_eventConnections{};
@@ -11,7 +11,10 @@
 #include "common/Config.hpp"
 #include "core/EventBus.hpp"
 #include "core/IService.hpp"
+#include "core/TopicRouter.hpp"
 
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace isic
@@ -21,7 +24,7 @@ class ConfigService : public ServiceBase
     static constexpr auto *kConfigFile{"/config.json"};
 
 public:
-    explicit ConfigService(EventBus &bus);
+    ConfigService(EventBus &bus, TopicRouter &router);
     ~ConfigService() override;
 
     ConfigService(const ConfigService &) = delete;
@@ -101,21 +104,28 @@ public:
         return m_dirty;
     }
 
+    /// @p config in the /config.json format
+    [[nodiscard]] static std::string toJson(const Config &config);
+
+    /**
+     * @brief Apply the sections of a /config.json document to @p config
+     *
+     * @return true if the document is valid and changed at least one field
+     */
+    [[nodiscard]] static bool fromJson(std::string_view json, Config &config);
+
     void serializeMetrics(JsonObject &obj) const override
     {
         obj["state"] = toString(getState());
     }
 
 private:
-    void handleSetConfigMessage(const std::string &topic, const std::string &payload);
-    void handleGetConfigMessage(const std::string &topic);
+    void handleSetConfigMessage(std::string_view section, std::string_view payload);
+    void handleGetConfigMessage(std::string_view section);
 
     EventBus &m_bus;
     Config m_config{};
 
-    // Event connections
-    std::vector<EventBus::ScopedConnection> m_eventConnections{};
-
     // Dirty flag to indicate unsaved changes
     bool m_dirty{false};
 };
@@ -4,6 +4,7 @@
 #include "common/Config.hpp"
 #include "core/EventBus.hpp"
 #include "core/IService.hpp"
+#include "core/TopicRouter.hpp"
 
 #include <Arduino.h>
 #include <array>
@@ -14,7 +15,7 @@ namespace isic
 class HealthService : public ServiceBase
 {
 public:
-    HealthService(EventBus &bus, HealthConfig &config);
+    HealthService(EventBus &bus, TopicRouter &router, HealthConfig &config);
     ~HealthService() override = default;
 
     HealthService(const HealthService &) = delete;
@@ -28,8 +29,8 @@ public:
     void end() override;
 
     // Component registration (for health reporting)
-    void registerComponent(const IService *component);
-    void unregisterComponent(const IService *component);
+    void registerComponent(const IMetricsSource *component);
+    void unregisterComponent(const IMetricsSource *component);
 
     [[nodiscard]] const SystemHealth &getSystemHealth() const noexcept
     {
@@ -52,24 +53,29 @@ private:
 
     void updateSystemHealth();
 
+    void requestHealthPublish();
+    void requestMetricsPublish();
+    void armPublishTimers();
+    void cancelPublishTimers();
+
     // Dependencies
     EventBus &m_bus;
     HealthConfig &m_config;
 
     // Registered health reporters
-    std::vector<const IService *> m_components{};
+    std::vector<const IMetricsSource *> m_components{};
 
     // System health summary
     SystemHealth m_systemHealth{};
 
     // Timing
     std::uint32_t m_startTimeMs{0};
-    std::uint32_t m_lastHealthCheckMs{0};
-    std::uint32_t m_lastHealthPublishMs{0};
-    std::uint32_t m_lastMetricsPublishMs{0};
+    EventBus::TimerId m_healthCheckTimer{EventBus::kInvalidTimer};
+    EventBus::TimerId m_healthPublishTimer{EventBus::kInvalidTimer};
+    EventBus::TimerId m_metricsPublishTimer{EventBus::kInvalidTimer};
+    EventBus::TimerId m_healthRequestTimer{EventBus::kInvalidTimer};  ///< One-shot publish on the next dispatch
+    EventBus::TimerId m_metricsRequestTimer{EventBus::kInvalidTimer}; ///< One-shot publish on the next dispatch
     bool m_mqttConnected{false};
-    bool m_pendingHealthPublish{false};
-    bool m_pendingMetricsPublish{false};
 
     // Event subscriptions
     std::vector<EventBus::ScopedConnection> m_eventConnections{};
@@ -4,9 +4,11 @@
 #include "common/Config.hpp"
 #include "core/EventBus.hpp"
 #include "core/IService.hpp"
+#include "core/TopicRouter.hpp"
 #include "platform/PlatformWiFi.hpp"
 
 #include <PubSubClient.h>
+#include <string_view>
 #include <vector>
 
 namespace isic
@@ -14,7 +16,7 @@ namespace isic
 class MqttService : public ServiceBase
 {
 public:
-    MqttService(EventBus &bus, const MqttConfig &config, const DeviceConfig& deviceConfig);
+    MqttService(EventBus &bus, TopicRouter &router, const MqttConfig &config, const DeviceConfig& deviceConfig);
     ~MqttService() override;
 
     MqttService(const MqttService &) = delete;
@@ -50,12 +52,23 @@ public:
         obj["published"] = m_metrics.messagesPublished;
         obj["failed"] = m_metrics.messagesFailed;
         obj["received"] = m_metrics.messagesReceived;
+        obj["unrouted"] = m_metrics.messagesUnrouted;
         obj["reconnects"] = m_metrics.reconnectCount;
     }
 
     bool publish(const char *topicSuffix, const char *payload, bool retained = false);
+    bool publish(const char *topicSuffix, std::string_view payload, bool retained = false);
     bool publish(const std::string &topicSuffix, const std::string &payload, bool retained = false);
 
+    /**
+     * @brief Publish what @p writer makes of @p source, streamed to the socket
+     *
+     * beginPublish() sends the header with the measured length, the writer's
+     * output goes straight to the client, and PubSubClient's buffer never
+     * holds the payload, so it is not bounded by kMaxPayloadSizeBytes either.
+     */
+    bool publish(const char *topicSuffix, std::string_view source, PayloadWriter writer, bool retained = false);
+
     bool subscribe(const char *topicSuffix);
     bool unsubscribe(const char *topicSuffix);
 
@@ -68,12 +81,15 @@ private:
     void connect();
     void handleMessage(const char *topic, std::uint8_t *payload, unsigned int length);
     void rebuildTopicPrefix();
+    void subscribeRoutes();
+    [[nodiscard]] const char *fullTopic(const char *suffix);
 
     [[nodiscard]] std::uint32_t calculateBackoff() const noexcept;
 
     static void messageCallback(const char *topic, std::uint8_t *payload, unsigned int length);
 
     EventBus &m_bus;
+    TopicRouter &m_router;
     const MqttConfig &m_config;
     const DeviceConfig& m_deviceConfig;
 
@@ -81,6 +97,7 @@ private:
     PubSubClient m_mqttClient;
 
     std::string m_topicPrefix{};
+    std::string m_topicBuffer{}; ///< Reused for outgoing topics, grows once instead of allocating per publish
 
     MqttState m_mqttState{MqttState::Disconnected};
     MqttMetrics m_metrics{};
@@ -3,6 +3,7 @@
 
 #include "core/EventBus.hpp"
 #include "core/IService.hpp"
+#include "core/TopicRouter.hpp"
 #include "common/Config.hpp"
 #include "platform/PlatformOta.hpp"
 
@@ -17,7 +18,7 @@ namespace isic
 class OtaService : public ServiceBase
 {
 public:
-    OtaService(EventBus &bus, const OtaConfig &config);
+    OtaService(EventBus &bus, TopicRouter &router, const OtaConfig &config);
     ~OtaService() override = default;
 
     OtaService(const OtaService &) = delete;
@@ -10,6 +10,7 @@
 #include <atomic>
 #include <vector>
 #include <memory>
+#include <optional>
 
 namespace isic
 {
@@ -67,6 +68,8 @@ public:
         obj["reads_successful"] = m_metrics.successfulReads;
         obj["reads_failed"] = m_metrics.readErrors;
         obj["recoveries"] = m_metrics.recoveryAttempts;
+        obj["publish_retries"] = m_metrics.publishRetries;
+        obj["cards_lost"] = m_metrics.cardsLost;
     }
 
 private:
@@ -74,6 +77,7 @@ private:
     void handleCardDetected();
     void pollForCard();
     void publishCardEvent(const std::uint8_t* uid, std::uint8_t uidLength);
+    bool retryUnpublishedCard();
     void handlePowerStateChange(const PowerEvent &power);
     bool reinitializePn532();
     bool recoverIrqMode();
@@ -97,6 +101,7 @@ private:
     std::uint8_t m_lastCardUidLength{0};
     std::uint32_t m_lastCardReadMs{0};
     std::uint32_t m_lastPollMs{0};
+    std::optional<CardEvent> m_unpublishedCard{}; // CardScanned refused by the bus, retried next loop
     std::vector<EventBus::ScopedConnection> m_eventConnections{};
 
     std::atomic_bool m_irqTriggered{false};
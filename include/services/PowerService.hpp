@@ -4,6 +4,7 @@
 #include "common/Config.hpp"
 #include "core/EventBus.hpp"
 #include "core/IService.hpp"
+#include "core/TopicRouter.hpp"
 #include "platform/PlatformWiFi.hpp"
 
 namespace isic
@@ -50,7 +51,7 @@ public:
         NfcReady = (1 << 4), // Bit 4: NFC reader ready
     };
 
-    PowerService(EventBus &bus, const PowerConfig &config);
+    PowerService(EventBus &bus, TopicRouter &router, const PowerConfig &config);
     ~PowerService() override;
 
     PowerService(const PowerService &) = delete;
@@ -115,7 +116,7 @@ private:
     void handleMqttConnected(const Event &event);
     void handleMqttDisconnected(const Event &event);
     void handleCardScanned(const Event &event);
-    void handleMqttMessage(const Event &event);
+    void handleMqttMessage();
     void handleNfcReady(const Event &event);
 
     PowerState selectSmartSleepDepth();
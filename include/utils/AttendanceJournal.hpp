@@ -0,0 +1,644 @@
+#ifndef ISIC_UTILS_ATTENDANCE_JOURNAL_HPP
+#define ISIC_UTILS_ATTENDANCE_JOURNAL_HPP
+
+#include "common/Logger.hpp"
+#include "common/Types.hpp"
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace isic::utils
+{
+struct AttendanceJournalMetrics
+{
+    std::uint32_t appended{0};   ///< Records accepted since boot
+    std::uint32_t delivered{0};  ///< Records consumed after the broker took them
+    std::uint32_t dropped{0};    ///< Records lost to the size cap or a full filesystem
+    std::uint32_t corrupt{0};    ///< Frames skipped on a CRC mismatch
+    std::uint32_t recovered{0};  ///< Torn frames cut off at begin() (power lost mid-write)
+    std::uint32_t flashWrites{0};
+};
+
+/**
+ * @brief Append-only LittleFS queue of attendance records that survives reboots
+ *
+ * Records are stored as fixed 20-byte frames, each carrying a CRC32, in
+ * segment files of kRecordsPerSegment frames under kDirectory (1.seg,
+ * 2.seg, ...). New frames go to the highest segment; a cursor file names
+ * the oldest undelivered frame. Delivered segments are deleted whole, so
+ * nothing is ever rewritten in place.
+ *
+ * Appends are collected in RAM and written kWriteBatchRecords at a time,
+ * or when the owner calls flush() (AttendanceService does after
+ * kWriteBatchDelayMs and before sleep): one flash write per batch instead
+ * of per tap. A power cut loses at most the unwritten batch.
+ *
+ * @par Power loss
+ * A write cut short leaves a partial or CRC-failing frame at the end of the
+ * last segment; begin() cuts it off, and looks in the segments before for
+ * lastSequence() when nothing in the last one survived. A short write at
+ * runtime (a full flash) is cut off the same way; when there is no room to
+ * rewrite the segment, appends go on in a new one. The cursor is replaced
+ * by writing a new file and renaming it over the old one, which LittleFS
+ * does atomically, so it is either the old or the new position - at worst
+ * a chunk is delivered twice, never skipped.
+ *
+ * @par Delivery
+ * peek() reads the oldest frames without removing them; consume() drops
+ * them once the caller knows the broker has them. RAM use is the write
+ * batch plus whatever the caller peeks, independent of the journal size.
+ *
+ * Main loop only (no locking).
+ */
+class AttendanceJournal
+{
+public:
+    static constexpr auto *kDirectory{"/attendance"};
+    static constexpr std::uint32_t kRecordsPerSegment{512};
+    static constexpr std::size_t kWriteBatchRecords{16};
+    static constexpr std::uint32_t kWriteBatchDelayMs{1000};
+
+    AttendanceJournal() = default;
+
+    AttendanceJournal(const AttendanceJournal &) = delete;
+    AttendanceJournal &operator=(const AttendanceJournal &) = delete;
+    AttendanceJournal(AttendanceJournal &&) = delete;
+    AttendanceJournal &operator=(AttendanceJournal &&) = delete;
+
+    /**
+     * @brief Open the journal left by the previous boot, repairing a torn tail
+     *
+     * @param maxRecords Undelivered records kept before isFull() reports true
+     * @return false if the directory cannot be used; the journal stays closed
+     *
+     * @note Call once LittleFS is mounted
+     */
+    bool begin(const std::uint32_t maxRecords)
+    {
+        m_maxRecords = maxRecords;
+        m_pending.clear();
+        m_pending.reserve(kMaxPendingRecords);
+        m_open = false;
+        m_count = 0;
+        m_lastSequence = 0;
+        m_cursorDirty = false;
+
+        if (!LittleFS.exists(kDirectory) && !LittleFS.mkdir(kDirectory))
+        {
+            LOG_ERROR(kTag, "Cannot create %s", kDirectory);
+            return false;
+        }
+
+        // Segments on flash: lowest and highest number
+        std::uint32_t lowest{0};
+        std::uint32_t highest{0};
+        auto directory{LittleFS.open(kDirectory)};
+        for (auto file{directory.openNextFile()}; file; file = directory.openNextFile())
+        {
+            unsigned segment{0};
+            char suffix[5]{};
+            if (std::sscanf(baseName(file.name()), "%u.%4s", &segment, suffix) == 2 && std::strcmp(suffix, "seg") == 0 && segment != 0)
+            {
+                lowest = lowest == 0 ? segment : std::min<std::uint32_t>(lowest, segment);
+                highest = std::max<std::uint32_t>(highest, segment);
+            }
+        }
+
+        const auto cursor{readCursor()};
+        if (highest == 0)
+        {
+            // Empty journal: continue numbering after the cursor so a stale cursor never matches a new segment
+            m_firstSegment = m_lastSegment = cursor.segment + 1;
+            m_cursorIndex = 0;
+        }
+        else
+        {
+            m_firstSegment = lowest;
+            m_lastSegment = highest;
+            m_cursorIndex = 0;
+            if (cursor.segment >= lowest && cursor.segment <= highest)
+            {
+                // Segments below the cursor were delivered; their removal was cut short
+                for (; m_firstSegment < cursor.segment; ++m_firstSegment)
+                {
+                    LittleFS.remove(segmentPath(m_firstSegment).c_str());
+                }
+                m_cursorIndex = cursor.index;
+            }
+        }
+
+        if (!repairTail(m_lastSegmentFrames))
+        {
+            // Torn bytes stay at its end: appending behind them would misalign every later frame
+            ++m_lastSegment;
+            m_lastSegmentFrames = 0;
+        }
+
+        // A tail segment with nothing intact (a torn first frame): the newest record is in an earlier one
+        for (auto segment{m_lastSegment}; m_lastSequence == 0 && segment > m_firstSegment; --segment)
+        {
+            m_lastSequence = newestSequenceIn(segment - 1);
+        }
+
+        for (auto segment{m_firstSegment}; segment < m_lastSegment; ++segment)
+        {
+            m_count += framesIn(segment);
+        }
+        m_count += m_lastSegmentFrames;
+        m_count = m_count > m_cursorIndex ? m_count - m_cursorIndex : 0;
+
+        m_open = true;
+        LOG_INFO(kTag, "%u undelivered records in segments %u-%u%s", static_cast<unsigned>(m_count),
+                 static_cast<unsigned>(m_firstSegment), static_cast<unsigned>(m_lastSegment),
+                 m_metrics.recovered != 0 ? ", torn tail repaired" : "");
+        return true;
+    }
+
+    [[nodiscard]] bool isOpen() const noexcept
+    {
+        return m_open;
+    }
+
+    /// Undelivered records, written or still pending
+    [[nodiscard]] std::uint32_t size() const noexcept
+    {
+        return m_count + static_cast<std::uint32_t>(m_pending.size());
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    [[nodiscard]] bool isFull() const noexcept
+    {
+        return size() >= m_maxRecords;
+    }
+
+    /// Sequence number of the newest record found at begin() or appended since
+    [[nodiscard]] std::uint32_t lastSequence() const noexcept
+    {
+        return m_lastSequence;
+    }
+
+    [[nodiscard]] const AttendanceJournalMetrics &getMetrics() const noexcept
+    {
+        return m_metrics;
+    }
+
+    /// Queue @p record behind everything already in the journal; written once kWriteBatchRecords are pending
+    void append(const AttendanceRecord &record)
+    {
+        m_pending.push_back(record);
+        m_lastSequence = record.sequence;
+        ++m_metrics.appended;
+        if (m_pending.size() >= kWriteBatchRecords)
+        {
+            flush();
+        }
+    }
+
+    /**
+     * @brief Write the pending records to flash
+     *
+     * @return false if the filesystem refused them; they stay pending (up to
+     *         kMaxPendingRecords, then the newest are dropped)
+     */
+    bool flush()
+    {
+        if (!m_open)
+        {
+            return true;
+        }
+
+        // Drops by dropOldest() reach flash with the write batch, not one cursor write each
+        if (m_cursorDirty)
+        {
+            writeCursor();
+        }
+        if (m_pending.empty())
+        {
+            return true;
+        }
+
+        std::size_t written{0};
+        while (written < m_pending.size())
+        {
+            if (m_lastSegmentFrames >= kRecordsPerSegment)
+            {
+                ++m_lastSegment;
+                m_lastSegmentFrames = 0;
+            }
+
+            // One write per segment touched: frames of a batch are contiguous
+            const auto room{static_cast<std::size_t>(kRecordsPerSegment - m_lastSegmentFrames)};
+            const auto batch{std::min({room, m_pending.size() - written, kMaxPendingRecords})};
+            std::uint8_t buffer[kMaxPendingRecords * kFrameBytes];
+            std::size_t bytes{0};
+            for (std::size_t i{0}; i < batch; ++i)
+            {
+                encodeFrame(m_pending[written + i], buffer + bytes);
+                bytes += kFrameBytes;
+            }
+
+            const auto framesBefore{m_lastSegmentFrames};
+            auto file{LittleFS.open(segmentPath(m_lastSegment).c_str(), "a")};
+            const auto ok{file && file.write(buffer, bytes) == bytes};
+            if (file)
+            {
+                file.close();
+            }
+            if (!ok)
+            {
+                // A short write leaves a torn frame; the whole frames before it are on flash and no longer pending
+                std::uint32_t frames{0};
+                const auto aligned{repairTail(frames)};
+                const auto landed{frames > framesBefore ? frames - framesBefore : 0};
+                m_lastSegmentFrames = frames;
+                m_count += landed;
+                written += landed;
+                m_metrics.flashWrites += landed != 0 ? 1 : 0;
+                if (!aligned)
+                {
+                    // Could not cut the torn bytes off: the next append starts a new segment instead
+                    ++m_lastSegment;
+                    m_lastSegmentFrames = 0;
+                }
+                break;
+            }
+
+            ++m_metrics.flashWrites;
+            m_lastSegmentFrames += static_cast<std::uint32_t>(batch);
+            m_count += static_cast<std::uint32_t>(batch);
+            written += batch;
+        }
+
+        m_pending.erase(m_pending.begin(), m_pending.begin() + static_cast<std::ptrdiff_t>(written));
+        if (m_pending.size() > kMaxPendingRecords)
+        {
+            const auto excess{m_pending.size() - kMaxPendingRecords};
+            LOG_WARN(kTag, "Flash write failed, dropping %u records", static_cast<unsigned>(excess));
+            m_metrics.dropped += static_cast<std::uint32_t>(excess);
+            m_pending.resize(kMaxPendingRecords);
+        }
+        return m_pending.empty();
+    }
+
+    /**
+     * @brief Read up to @p maxRecords of the oldest records without removing them
+     *
+     * Writes pending records first, so the result is in append order.
+     *
+     * @param out Cleared, then filled with the records that passed their CRC
+     * @return Frames covered, corrupt ones included: pass it to consume()
+     */
+    std::uint32_t peek(std::vector<AttendanceRecord> &out, const std::uint32_t maxRecords)
+    {
+        out.clear();
+        flush();
+
+        std::uint32_t frames{0};
+        auto segment{m_firstSegment};
+        auto index{m_cursorIndex};
+        while (frames < maxRecords && frames < m_count && segment <= m_lastSegment)
+        {
+            auto file{LittleFS.open(segmentPath(segment).c_str(), "r")};
+            if (!file || !file.seek(index * kFrameBytes))
+            {
+                break;
+            }
+
+            std::uint8_t frame[kFrameBytes];
+            while (frames < maxRecords && frames < m_count && file.read(frame, kFrameBytes) == kFrameBytes)
+            {
+                ++frames;
+                ++index;
+                if (AttendanceRecord record{}; decodeFrame(frame, record))
+                {
+                    out.push_back(record);
+                }
+                else
+                {
+                    ++m_metrics.corrupt;
+                }
+            }
+            file.close();
+
+            ++segment;
+            index = 0;
+        }
+        return frames;
+    }
+
+    /**
+     * @brief Remove the @p frames oldest frames, e.g. after the broker took them
+     *
+     * Deletes segments that become fully delivered and persists the cursor.
+     */
+    void consume(const std::uint32_t frames)
+    {
+        m_metrics.delivered += frames;
+        advance(frames);
+    }
+
+    /**
+     * @brief Discard the oldest record to make room (DropOldest)
+     *
+     * The cursor is only moved in RAM and written by the next flush(), so a
+     * full journal costs one cursor write per write batch rather than per
+     * tap. A power cut before that brings the dropped records back: replayed,
+     * never lost.
+     */
+    void dropOldest()
+    {
+        if (m_count == 0)
+        {
+            // Nothing on flash yet: the oldest record is still pending
+            if (!m_pending.empty())
+            {
+                m_pending.erase(m_pending.begin());
+                ++m_metrics.dropped;
+            }
+            return;
+        }
+        ++m_metrics.dropped;
+        advance(1, false);
+    }
+
+    /// Discard every record (DropAll)
+    void clear()
+    {
+        m_metrics.dropped += size();
+        m_pending.clear();
+        advance(m_count);
+    }
+
+private:
+    static constexpr auto *kTag{"Journal"};
+    static constexpr auto *kCursorFile{"/attendance/cursor"};
+    static constexpr auto *kCursorTempFile{"/attendance/cursor.tmp"};
+    static constexpr std::size_t kFrameBytes{20};
+    static constexpr std::size_t kMaxPendingRecords{kWriteBatchRecords * 2};
+    static constexpr std::uint8_t kFrameMarker{0xA7};
+    static constexpr std::uint32_t kCursorMagic{0x41544A43}; // "ATJC"
+
+    struct Cursor
+    {
+        std::uint32_t magic{kCursorMagic};
+        std::uint32_t segment{0};
+        std::uint32_t index{0}; ///< Frames of segment already delivered
+        std::uint32_t crc{0};
+    };
+    static_assert(sizeof(Cursor) == 16, "Cursor layout changed");
+
+    static std::uint32_t crc32(const std::uint8_t *data, const std::size_t size)
+    {
+        std::uint32_t crc{0xFFFFFFFF};
+        for (std::size_t i{0}; i < size; ++i)
+        {
+            crc ^= data[i];
+            for (auto bit{0}; bit < 8; ++bit)
+            {
+                crc = (crc >> 1) ^ (0xEDB88320 & (0U - (crc & 1U)));
+            }
+        }
+        return ~crc;
+    }
+
+    /// sequence, timestampMs (LE), uid[7], marker, CRC32 of the first 16 bytes (LE)
+    static void encodeFrame(const AttendanceRecord &record, std::uint8_t *frame)
+    {
+        for (std::size_t i{0}; i < 4; ++i)
+        {
+            frame[i] = static_cast<std::uint8_t>(record.sequence >> (8 * i));
+            frame[4 + i] = static_cast<std::uint8_t>(record.timestampMs >> (8 * i));
+        }
+        std::memcpy(frame + 8, record.cardUid.data(), kCardUidMaxSize);
+        frame[15] = kFrameMarker;
+        const auto crc{crc32(frame, 16)};
+        for (std::size_t i{0}; i < 4; ++i)
+        {
+            frame[16 + i] = static_cast<std::uint8_t>(crc >> (8 * i));
+        }
+    }
+
+    static bool decodeFrame(const std::uint8_t *frame, AttendanceRecord &record)
+    {
+        std::uint32_t crc{0};
+        for (std::size_t i{0}; i < 4; ++i)
+        {
+            crc |= static_cast<std::uint32_t>(frame[16 + i]) << (8 * i);
+        }
+        if (frame[15] != kFrameMarker || crc != crc32(frame, 16))
+        {
+            return false;
+        }
+
+        record = {};
+        for (std::size_t i{0}; i < 4; ++i)
+        {
+            record.sequence |= static_cast<std::uint32_t>(frame[i]) << (8 * i);
+            record.timestampMs |= static_cast<std::uint32_t>(frame[4 + i]) << (8 * i);
+        }
+        std::memcpy(record.cardUid.data(), frame + 8, kCardUidMaxSize);
+        return true;
+    }
+
+    static const char *baseName(const char *path)
+    {
+        const auto *slash{std::strrchr(path, '/')};
+        return slash != nullptr ? slash + 1 : path;
+    }
+
+    static std::string segmentPath(const std::uint32_t segment)
+    {
+        char path[32];
+        std::snprintf(path, sizeof(path), "%s/%u.seg", kDirectory, static_cast<unsigned>(segment));
+        return path;
+    }
+
+    static std::uint32_t framesIn(const std::uint32_t segment)
+    {
+        auto file{LittleFS.open(segmentPath(segment).c_str(), "r")};
+        return file ? static_cast<std::uint32_t>(file.size() / kFrameBytes) : 0;
+    }
+
+    /// Sequence of the last intact frame of @p segment, 0 if it has none
+    static std::uint32_t newestSequenceIn(const std::uint32_t segment)
+    {
+        auto file{LittleFS.open(segmentPath(segment).c_str(), "r")};
+        if (!file)
+        {
+            return 0;
+        }
+
+        std::uint8_t frame[kFrameBytes];
+        AttendanceRecord record{};
+        for (auto index{static_cast<std::uint32_t>(file.size() / kFrameBytes)}; index > 0; --index)
+        {
+            if (file.seek((index - 1) * kFrameBytes) && file.read(frame, kFrameBytes) == kFrameBytes && decodeFrame(frame, record))
+            {
+                return record.sequence;
+            }
+        }
+        return 0;
+    }
+
+    static Cursor readCursor()
+    {
+        Cursor cursor{};
+        auto file{LittleFS.open(kCursorFile, "r")};
+        if (!file || file.read(reinterpret_cast<std::uint8_t *>(&cursor), sizeof(cursor)) != sizeof(cursor) ||
+            cursor.magic != kCursorMagic || cursor.crc != crc32(reinterpret_cast<const std::uint8_t *>(&cursor), 12))
+        {
+            return {};
+        }
+        return cursor;
+    }
+
+    void writeCursor()
+    {
+        m_cursorDirty = false;
+        Cursor cursor{kCursorMagic, m_firstSegment, m_cursorIndex, 0};
+        cursor.crc = crc32(reinterpret_cast<const std::uint8_t *>(&cursor), 12);
+
+        auto file{LittleFS.open(kCursorTempFile, "w")};
+        const auto ok{file && file.write(reinterpret_cast<const std::uint8_t *>(&cursor), sizeof(cursor)) == sizeof(cursor)};
+        if (file)
+        {
+            file.close();
+        }
+        if (!ok || !LittleFS.rename(kCursorTempFile, kCursorFile))
+        {
+            LOG_WARN(kTag, "Cursor write failed, records may be replayed twice");
+        }
+        ++m_metrics.flashWrites;
+    }
+
+    /**
+     * @brief Cut a torn or corrupt frame off the end of the last segment
+     *
+     * @param frames Set to the whole frames left in the last segment
+     * @return false if the segment could not be rewritten (a full flash) and
+     *         still ends in torn bytes; @p frames then counts every whole
+     *         frame in it, the corrupt ones too, as framesIn() does
+     */
+    bool repairTail(std::uint32_t &frames)
+    {
+        frames = 0;
+        const auto path{segmentPath(m_lastSegment)};
+        auto file{LittleFS.open(path.c_str(), "r")};
+        if (!file)
+        {
+            return true;
+        }
+
+        const auto size{file.size()};
+        frames = static_cast<std::uint32_t>(size / kFrameBytes);
+        auto keep{frames};
+        std::uint8_t frame[kFrameBytes];
+        AttendanceRecord record{};
+        while (keep > 0 && !(file.seek((keep - 1) * kFrameBytes) && file.read(frame, kFrameBytes) == kFrameBytes &&
+                             decodeFrame(frame, record)))
+        {
+            --keep;
+        }
+        if (keep > 0 && !m_open)
+        {
+            m_lastSequence = record.sequence;
+        }
+
+        if (keep == frames && size == frames * kFrameBytes)
+        {
+            file.close();
+            return true;
+        }
+
+        // LittleFS has no truncate: copy the intact frames and rename over the segment
+        const auto tempPath{path + ".tmp"};
+        auto copy{LittleFS.open(tempPath.c_str(), "w")};
+        auto ok{static_cast<bool>(copy)};
+        file.seek(0);
+        for (std::uint32_t i{0}; ok && i < keep; ++i)
+        {
+            ok = file.read(frame, kFrameBytes) == kFrameBytes && copy.write(frame, kFrameBytes) == kFrameBytes;
+        }
+        file.close();
+        if (copy)
+        {
+            copy.close();
+        }
+        if (!ok || !LittleFS.rename(tempPath.c_str(), path.c_str()))
+        {
+            LittleFS.remove(tempPath.c_str());
+            LOG_ERROR(kTag, "Segment %u: cannot cut its torn tail, continuing in a new segment",
+                      static_cast<unsigned>(m_lastSegment));
+            return false;
+        }
+
+        m_metrics.recovered += frames - keep + (size % kFrameBytes != 0 ? 1 : 0);
+        LOG_WARN(kTag, "Segment %u: cut %u bytes of torn frames", static_cast<unsigned>(m_lastSegment),
+                 static_cast<unsigned>(size - keep * kFrameBytes));
+        frames = keep;
+        return true;
+    }
+
+    /// Move the cursor @p frames on, deleting segments left behind; @p persist false defers the cursor write to flush()
+    void advance(std::uint32_t frames, const bool persist = true)
+    {
+        frames = std::min(frames, m_count);
+        m_count -= frames;
+        m_cursorIndex += frames;
+
+        while (m_firstSegment < m_lastSegment)
+        {
+            const auto inFirst{framesIn(m_firstSegment)};
+            if (m_cursorIndex < inFirst)
+            {
+                break;
+            }
+            LittleFS.remove(segmentPath(m_firstSegment).c_str());
+            m_cursorIndex -= inFirst;
+            ++m_firstSegment;
+        }
+
+        if (m_count == 0 && m_cursorIndex >= m_lastSegmentFrames)
+        {
+            // Everything delivered: start a fresh segment instead of appending behind delivered frames
+            LittleFS.remove(segmentPath(m_lastSegment).c_str());
+            m_firstSegment = m_lastSegment = m_lastSegment + 1;
+            m_lastSegmentFrames = 0;
+            m_cursorIndex = 0;
+        }
+
+        if (persist)
+        {
+            writeCursor();
+        }
+        else
+        {
+            m_cursorDirty = true;
+        }
+    }
+
+    std::vector<AttendanceRecord> m_pending{};
+    AttendanceJournalMetrics m_metrics{};
+    std::uint32_t m_maxRecords{0};
+    std::uint32_t m_count{0}; ///< Undelivered frames on flash
+    std::uint32_t m_firstSegment{1};
+    std::uint32_t m_lastSegment{1};
+    std::uint32_t m_lastSegmentFrames{0};
+    std::uint32_t m_cursorIndex{0};
+    std::uint32_t m_lastSequence{0};
+    bool m_cursorDirty{false}; ///< Cursor moved by dropOldest() since the last writeCursor()
+    bool m_open{false};
+};
+} // namespace isic::utils
+
+#endif // ISIC_UTILS_ATTENDANCE_JOURNAL_HPP
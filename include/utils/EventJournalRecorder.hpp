@@ -0,0 +1,204 @@
+#ifndef ISIC_UTILS_EVENT_JOURNAL_RECORDER_HPP
+#define ISIC_UTILS_EVENT_JOURNAL_RECORDER_HPP
+
+#ifdef ISIC_ENABLE_EVENT_JOURNAL
+
+#include "common/Logger.hpp"
+#include "core/EventBus.hpp"
+#include "core/EventJournal.hpp"
+#include "core/TopicRouter.hpp"
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/// Journal file size at which recording stops by itself
+#ifndef ISIC_EVENT_JOURNAL_MAX_BYTES
+#define ISIC_EVENT_JOURNAL_MAX_BYTES (256U * 1024U)
+#endif
+
+/// Start recording at boot instead of waiting for journal/start
+#ifndef ISIC_EVENT_JOURNAL_AUTOSTART
+#define ISIC_EVENT_JOURNAL_AUTOSTART 0
+#endif
+
+namespace isic::utils
+{
+
+/**
+ * @brief Records the services' external inputs to a LittleFS journal
+ *
+ * Captures the events that originate outside the service stack (card taps,
+ * NFC state, WiFi/MQTT connectivity, wakeups) and every inbound MQTT
+ * message, in the line format of core/EventJournal.hpp. Events the services
+ * produce themselves (attendance records, publish requests, feedback) are
+ * left out: a replay regenerates them.
+ *
+ * Entries are buffered in RAM and appended to the file every
+ * kFlushIntervalMs or once kFlushThresholdBytes are pending. Flash writes
+ * then happen inside dispatch(), so recording perturbs timing slightly.
+ *
+ * DEBUG NOTE: Only compiled when ISIC_ENABLE_EVENT_JOURNAL is defined.
+ *
+ * MQTT control (relative to the device prefix):
+ *   journal/start  - Truncate the journal and start recording
+ *   journal/stop   - Flush and stop
+ *
+ * Pull the journal with: esp_fs_inspector.py read /journal.log
+ */
+class EventJournalRecorder
+{
+public:
+    static constexpr auto *kJournalFile{"/journal.log"};
+    static constexpr auto *kStartTopic{"journal/start"};
+    static constexpr auto *kStopTopic{"journal/stop"};
+    static constexpr std::size_t kFlushThresholdBytes{768};
+    static constexpr std::uint32_t kFlushIntervalMs{5000};
+    static constexpr std::size_t kMaxFileBytes{ISIC_EVENT_JOURNAL_MAX_BYTES};
+
+    static constexpr EventType kRecordedTypes[]{
+        EventType::WifiConnected, EventType::WifiDisconnected, EventType::MqttConnected, EventType::MqttDisconnected,
+        EventType::MqttError,     EventType::NfcReady,         EventType::CardScanned,   EventType::CardRemoved,
+        EventType::NfcError,      EventType::WakeupOccurred,
+    };
+
+    EventJournalRecorder(EventBus &bus, TopicRouter &router)
+        : m_bus(bus)
+    {
+        m_eventConnections.reserve(std::size(kRecordedTypes));
+        for (const auto type: kRecordedTypes)
+        {
+            m_eventConnections.push_back(m_bus.subscribeScoped(type, [this](const Event &e) { record(e); }));
+        }
+
+        router.addRoute(kStartTopic, [this](const TopicView &, std::string_view) { start(); });
+        router.addRoute(kStopTopic, [this](const TopicView &, std::string_view) { stop(); });
+        // Local: record what arrives for the other routes without subscribing to the device's own topics
+        router.addRoute(
+                "#", [this](const TopicView &topic, const std::string_view payload) { recordInbound(topic, payload); },
+                TopicRouter::Subscription::Local);
+    }
+
+    ~EventJournalRecorder()
+    {
+        stop();
+    }
+
+    EventJournalRecorder(const EventJournalRecorder &) = delete;
+    EventJournalRecorder &operator=(const EventJournalRecorder &) = delete;
+    EventJournalRecorder(EventJournalRecorder &&) = delete;
+    EventJournalRecorder &operator=(EventJournalRecorder &&) = delete;
+
+    /// Call once LittleFS is mounted
+    void begin()
+    {
+        if constexpr (ISIC_EVENT_JOURNAL_AUTOSTART != 0)
+        {
+            start();
+        }
+    }
+
+    void start()
+    {
+        if (auto file{LittleFS.open(kJournalFile, "w")})
+        {
+            file.close();
+        }
+        else
+        {
+            LOG_ERROR(kTag, "Cannot create %s", kJournalFile);
+            return;
+        }
+
+        m_pending.clear();
+        m_pending.reserve(kFlushThresholdBytes + 128);
+        m_fileBytes = 0;
+        m_recording = true;
+        m_bus.cancelTimer(m_flushTimer);
+        m_flushTimer = m_bus.callEvery(kFlushIntervalMs, [this]() { flush(); });
+        LOG_INFO(kTag, "Recording to %s", kJournalFile);
+    }
+
+    void stop()
+    {
+        if (!m_recording)
+        {
+            return;
+        }
+        flush();
+        m_recording = false;
+        m_bus.cancelTimer(m_flushTimer);
+        LOG_INFO(kTag, "Stopped, %u bytes recorded", static_cast<unsigned>(m_fileBytes));
+    }
+
+    [[nodiscard]] bool isRecording() const
+    {
+        return m_recording;
+    }
+
+private:
+    static constexpr auto *kTag{"Journal"};
+
+    void record(const Event &event)
+    {
+        if (m_recording)
+        {
+            journal::appendEvent(m_pending, millis(), event);
+            flushIfFull();
+        }
+    }
+
+    void recordInbound(const TopicView &topic, const std::string_view payload)
+    {
+        // Control messages are not part of the workload
+        if (m_recording && topic[0] != "journal")
+        {
+            journal::appendInbound(m_pending, millis(), topic.str(), payload);
+            flushIfFull();
+        }
+    }
+
+    void flushIfFull()
+    {
+        if (m_pending.size() >= kFlushThresholdBytes)
+        {
+            flush();
+        }
+    }
+
+    void flush()
+    {
+        if (m_pending.empty())
+        {
+            return;
+        }
+
+        auto file{LittleFS.open(kJournalFile, "a")};
+        const auto written{file ? file.write(reinterpret_cast<const std::uint8_t *>(m_pending.data()), m_pending.size()) : 0};
+        if (file)
+        {
+            file.close();
+        }
+        m_fileBytes += written;
+        m_pending.clear();
+
+        if (written == 0 || m_fileBytes >= kMaxFileBytes)
+        {
+            LOG_WARN(kTag, "Stopping: %s", written == 0 ? "write failed" : "size limit reached");
+            stop();
+        }
+    }
+
+    EventBus &m_bus;
+    std::vector<EventBus::ScopedConnection> m_eventConnections{};
+    EventBus::TimerId m_flushTimer{EventBus::kInvalidTimer};
+    std::string m_pending{};
+    std::size_t m_fileBytes{0};
+    bool m_recording{false};
+};
+} // namespace isic::utils
+
+#endif // ISIC_ENABLE_EVENT_JOURNAL
+#endif // ISIC_UTILS_EVENT_JOURNAL_RECORDER_HPP
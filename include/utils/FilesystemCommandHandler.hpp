@@ -3,6 +3,9 @@
 
 #ifdef ISIC_ENABLE_FS_INSPECTOR
 
+#include "common/Types.hpp"
+#include "core/Trace.hpp"
+
 #include <Arduino.h>
 #include <LittleFS.h>
 
@@ -23,6 +26,7 @@ namespace isic::utils
  *   FS_CMD:LIST [path]      - List files in directory
  *   FS_CMD:READ <filepath>  - Read file contents
  *   FS_CMD:INFO             - Get filesystem info
+ *   FS_CMD:TRACE            - Dump the event trace ring (ISIC_ENABLE_TRACE builds)
  */
 class FilesystemCommandHandler
 {
@@ -34,6 +38,7 @@ public:
     static constexpr auto *COMMAND_INFO{"INFO"};
     static constexpr auto *COMMAND_LIST{"LIST"};
     static constexpr auto *COMMAND_READ{"READ"};
+    static constexpr auto *COMMAND_TRACE{"TRACE"};
 
     FilesystemCommandHandler() = default;
     ~FilesystemCommandHandler() = default;
@@ -99,6 +104,12 @@ private:
         {
             handleInfoCommand();
         }
+#ifdef ISIC_ENABLE_TRACE
+        else if (command.startsWith(COMMAND_TRACE))
+        {
+            handleTraceCommand();
+        }
+#endif
         else
         {
             sendResponse("ERROR: Unknown command");
@@ -258,6 +269,66 @@ private:
 
         endResponse();
     }
+
+#ifdef ISIC_ENABLE_TRACE
+    /**
+     * Trace dump, read by tools/trace_to_chrome.py:
+     *   EVENTS <name>,<name>,...   (index = EventType)
+     *   SOURCES <name>,<name>,...  (index = trace::Source)
+     *   R <hex>                    (up to kTraceRecordsPerLine records, oldest first)
+     *   TRACE <format> <record size> <records since boot>
+     */
+    void handleTraceCommand()
+    {
+        static constexpr std::size_t kTraceRecordsPerLine{32};
+        static constexpr auto *kHexDigits{"0123456789abcdef"};
+
+        String names;
+        for (std::size_t i{0}; i < static_cast<std::size_t>(EventType::_Count); ++i)
+        {
+            names += (i == 0 ? "" : ",");
+            names += toString(static_cast<EventType>(i));
+        }
+        sendResponse("EVENTS " + names);
+
+        names = "";
+        for (std::size_t i{0}; i < static_cast<std::size_t>(trace::Source::_Count); ++i)
+        {
+            names += (i == 0 ? "" : ",");
+            names += trace::kSourceNames[i];
+        }
+        sendResponse("SOURCES " + names);
+
+        String line;
+        line.reserve(2 + kTraceRecordsPerLine * sizeof(trace::Record) * 2);
+        std::size_t inLine{0};
+        const auto total{trace::Recorder::instance().forEach([&](const trace::Record &record) {
+            if (inLine == 0)
+            {
+                line = "R ";
+            }
+            const auto *bytes{reinterpret_cast<const std::uint8_t *>(&record)};
+            for (std::size_t i{0}; i < sizeof(trace::Record); ++i)
+            {
+                line += kHexDigits[bytes[i] >> 4];
+                line += kHexDigits[bytes[i] & 0x0F];
+            }
+            if (++inLine == kTraceRecordsPerLine)
+            {
+                sendResponse(line);
+                inLine = 0;
+            }
+        })};
+        if (inLine != 0)
+        {
+            sendResponse(line);
+        }
+
+        // Header last: the total is only known once the ring has been walked
+        sendResponse("TRACE 1 " + String(static_cast<unsigned>(sizeof(trace::Record))) + " " + String(total));
+        endResponse();
+    }
+#endif
 };
 } // namespace isic::utils
 
@@ -0,0 +1,581 @@
+/**
+ * @file FleetMain.cpp
+ * @brief Fleet simulator: many devices against one broker, seen from the backend
+ *
+ * Forks one process per virtual device - the firmware's services and the
+ * shim's filesystem and radio are process-wide singletons, so a process is
+ * the unit of isolation. Each device gets its own deviceId (fleet-000,
+ * fleet-001, ...), its own scan schedule and the full App, and all of them
+ * share one timeline: the same AP outage hits every device at once, which
+ * is what produces the reconnect storm and the burst of offline-buffer
+ * flushes afterwards.
+ *
+ * The parent is the backend. It subscribes to every device's topics and
+ * bins what arrives per second, so fan-in shows as aggregate msgs/sec and
+ * bytes/sec rather than per-device numbers.
+ *
+ * Usage:
+ *   isic_fleet [options]
+ *
+ *   --devices N           virtual devices (default 10)
+ *   --stagger MS          spread the boots over MS ms (default 0: all at once)
+ *   --device-log on|off   keep the devices' serial output (default off)
+ *
+ * plus the scenario options listed in Harness.hpp. --scans is per device;
+ * poisson and rush schedules differ between devices (seed + device index).
+ * The devices start scanning --stagger + 5000 ms after the first boot.
+ */
+
+#include "App.hpp"
+#include "Harness.hpp"
+#include "NativeHost.hpp"
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <PubSubClient.h>
+#include <WiFiClient.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+namespace harness = isic::native::harness;
+using harness::Scenario;
+
+/// Time the devices get to come up before the first scan
+constexpr std::uint32_t kSettleMs{5000};
+
+/// How long after the outage a traffic peak still counts as its flush burst
+constexpr std::uint32_t kFlushWindowMs{30000};
+
+struct FleetOptions
+{
+    std::uint16_t devices{10};
+    std::uint32_t staggerMs{0};
+    bool deviceLog{false};
+};
+
+/// What one device reports back to the parent when its run is over
+struct DeviceReport
+{
+    std::uint32_t device{0};
+    std::uint32_t scans{0};
+    std::uint32_t refused{0};
+    std::uint32_t published{0};
+    std::uint32_t failed{0};
+    std::uint32_t reconnects{0};
+    std::uint32_t batches{0};
+    std::uint32_t errors{0};
+    std::int32_t connectMs{-1};   ///< From boot to the first broker session, -1 if never
+    std::int32_t reconnectMs{-1}; ///< From the end of the outage back to the broker, -1 if never
+};
+
+/// Traffic seen by the backend in one second of the run
+struct Bin
+{
+    std::uint32_t messages{0};
+    std::uint64_t bytes{0};
+    std::uint32_t attendanceMessages{0};
+    std::uint64_t attendanceBytes{0};
+    std::uint32_t records{0};
+};
+
+struct Backend
+{
+    std::uint64_t originUs{0};
+    std::vector<Bin> bins{};
+    std::set<std::string> uids{};
+    std::uint32_t records{0};
+    std::uint32_t duplicates{0};
+};
+
+// PubSubClient takes a plain function pointer on non-ESP targets
+Backend *g_backend{nullptr};
+
+bool parseOptions(const int argc, char **argv, FleetOptions &fleet, Scenario &scenario)
+{
+    for (auto i{1}; i + 1 < argc; i += 2)
+    {
+        const std::string arg{argv[i]};
+        const std::string value{argv[i + 1]};
+
+        if (arg == "--devices")
+        {
+            const auto devices{std::strtoul(value.c_str(), nullptr, 10)};
+            fleet.devices = static_cast<std::uint16_t>(std::min(devices, 65535UL));
+            if (devices == 0)
+            {
+                return false;
+            }
+        }
+        else if (arg == "--stagger")
+        {
+            fleet.staggerMs = static_cast<std::uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        }
+        else if (arg == "--device-log")
+        {
+            fleet.deviceLog = value == "on";
+        }
+        else if (!harness::parseScenarioOption(arg, value, scenario))
+        {
+            return false;
+        }
+    }
+    return (argc % 2) == 1;
+}
+
+std::string deviceId(const std::uint32_t device)
+{
+    char id[16];
+    std::snprintf(id, sizeof(id), "fleet-%03u", device);
+    return id;
+}
+
+void sleepUntil(const std::uint64_t us)
+{
+    const auto now{isic::native::nowUs()};
+    if (us > now)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(us - now));
+    }
+}
+
+/**
+ * @brief One virtual device, run in a child process
+ *
+ * @param startUs Shared scenario time zero, on the clock inherited from the parent
+ */
+DeviceReport runDevice(const std::uint32_t device, const Scenario &scenario, const std::uint64_t bootUs,
+                       const std::uint64_t startUs)
+{
+    DeviceReport report{};
+    report.device = device;
+
+    sleepUntil(bootUs);
+    if (!harness::seedConfig(scenario, deviceId(device)))
+    {
+        return report;
+    }
+
+    auto app{std::make_unique<isic::App>()};
+    if (app->begin().failed())
+    {
+        return report;
+    }
+
+    const auto arrivals{harness::buildArrivals(scenario, device)};
+    const auto endMs{(arrivals.empty() ? 0 : arrivals.back()) + scenario.drainMs};
+    const auto outageEndMs{scenario.outageAtMs + scenario.outageForMs};
+    const auto elapsedMs{[startUs]() {
+        const auto now{isic::native::nowUs()};
+        return now > startUs ? static_cast<std::uint32_t>((now - startUs) / 1000) : 0U;
+    }};
+
+    auto &bus{app->getEventBus()};
+    const auto &mqtt{app->getMqttService()};
+    std::size_t next{0};
+    auto wasConnected{false};
+    while (isic::native::nowUs() < startUs || elapsedMs() < endMs)
+    {
+        const auto started{isic::native::nowUs() >= startUs};
+        const auto atMs{elapsedMs()};
+        if (scenario.outageForMs > 0 && started)
+        {
+            isic::native::setWiFiLinkUp(!scenario.inOutage(atMs));
+        }
+
+        while (started && next < arrivals.size() && arrivals[next] <= atMs)
+        {
+            const isic::CardEvent card{static_cast<std::uint32_t>(millis()), harness::syntheticUid(device, next++)};
+            ++report.scans;
+            if (!bus.publish(isic::Event{isic::EventType::CardScanned, card}))
+            {
+                ++report.refused;
+            }
+        }
+
+        app->loop();
+
+        const auto connected{mqtt.isConnected()};
+        if (connected && !wasConnected)
+        {
+            if (report.connectMs < 0)
+            {
+                report.connectMs = static_cast<std::int32_t>((isic::native::nowUs() - bootUs) / 1000);
+            }
+            else if (scenario.outageForMs > 0 && started && atMs >= outageEndMs && report.reconnectMs < 0)
+            {
+                report.reconnectMs = static_cast<std::int32_t>(atMs - outageEndMs);
+            }
+        }
+        wasConnected = connected;
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    const auto &mqttMetrics{mqtt.getMqttMetrics()};
+    const auto &attendanceMetrics{app->getAttendanceService().getMetrics()};
+    report.published = mqttMetrics.messagesPublished;
+    report.failed = mqttMetrics.messagesFailed;
+    report.reconnects = mqttMetrics.reconnectCount;
+    report.batches = attendanceMetrics.batchesSent;
+    report.errors = attendanceMetrics.errorCount;
+    return report;
+}
+
+/// One line per device, written in one call: well under PIPE_BUF, so lines from different devices never interleave
+void writeReport(const int fd, const DeviceReport &report)
+{
+    char line[192];
+    const auto length{std::snprintf(line, sizeof(line), "%u %u %u %u %u %u %u %u %d %d\n", report.device, report.scans,
+                                    report.refused, report.published, report.failed, report.reconnects,
+                                    report.batches, report.errors, report.connectMs, report.reconnectMs)};
+    if (length > 0 && ::write(fd, line, static_cast<std::size_t>(length)) < 0)
+    {
+        std::perror("write");
+    }
+}
+
+std::vector<DeviceReport> parseReports(const std::string &text)
+{
+    std::vector<DeviceReport> reports;
+    std::size_t begin{0};
+    for (auto end{text.find('\n')}; end != std::string::npos; begin = end + 1, end = text.find('\n', begin))
+    {
+        DeviceReport report{};
+        if (std::sscanf(text.c_str() + begin, "%u %u %u %u %u %u %u %u %d %d", &report.device, &report.scans,
+                        &report.refused, &report.published, &report.failed, &report.reconnects, &report.batches,
+                        &report.errors, &report.connectMs, &report.reconnectMs) == 10)
+        {
+            reports.push_back(report);
+        }
+    }
+    return reports;
+}
+
+void onMessage(char *topic, std::uint8_t *payload, const unsigned int length)
+{
+    const auto now{isic::native::nowUs()};
+    auto &bins{g_backend->bins};
+    const auto second{static_cast<std::size_t>((now - g_backend->originUs) / 1'000'000ULL)};
+    if (second >= bins.size())
+    {
+        bins.resize(second + 1);
+    }
+    auto &bin{bins[second]};
+    ++bin.messages;
+    bin.bytes += length;
+
+    const auto topicLength{std::strlen(topic)};
+    constexpr std::string_view kSuffix{"/attendance"};
+    if (topicLength < kSuffix.size() || kSuffix != std::string_view{topic + topicLength - kSuffix.size()})
+    {
+        return;
+    }
+    ++bin.attendanceMessages;
+    bin.attendanceBytes += length;
+
+    JsonDocument doc;
+    if (deserializeJson(doc, payload, length))
+    {
+        return;
+    }
+    for (const auto record: doc.as<JsonArrayConst>())
+    {
+        ++bin.records;
+        ++g_backend->records;
+        if (!g_backend->uids.insert(record["uid"].as<std::string>()).second)
+        {
+            ++g_backend->duplicates;
+        }
+    }
+}
+
+struct Peak
+{
+    double messages{0.0};
+    double bytes{0.0};
+    std::size_t second{0};
+};
+
+Peak peakOf(const std::vector<Bin> &bins, const std::size_t from, const std::size_t to)
+{
+    Peak peak{};
+    for (auto second{from}; second < std::min(to, bins.size()); ++second)
+    {
+        if (bins[second].messages > peak.messages)
+        {
+            peak = {static_cast<double>(bins[second].messages), static_cast<double>(bins[second].bytes), second};
+        }
+    }
+    return peak;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    FleetOptions fleet{};
+    Scenario scenario{};
+    if (!parseOptions(argc, argv, fleet, scenario))
+    {
+        std::fprintf(stderr, "Usage: %s [--devices N] [--stagger MS] [--scans N] [--over MS] [--outage-at MS] ...\n"
+                             "See the comments at the top of native/FleetMain.cpp and native/Harness.hpp.\n", argv[0]);
+        return 2;
+    }
+
+    // The backend subscribes before any device boots, so the boot traffic is in the timeline too
+    Backend backend{};
+    g_backend = &backend;
+    isic::native::HostClient subscriberSocket;
+    PubSubClient subscriber{subscriberSocket};
+    subscriber.setServer(scenario.brokerHost.c_str(), scenario.brokerPort);
+    subscriber.setBufferSize(isic::MqttConfig::Constants::kMaxPayloadSizeBytes + 256);
+    subscriber.setCallback(onMessage);
+    const auto topic{isic::MqttConfig{}.baseTopic + "/+/#"};
+    const auto clientId{"fleet-backend-" + std::to_string(::getpid())};
+    if (!subscriber.connect(clientId.c_str()) || !subscriber.subscribe(topic.c_str()))
+    {
+        std::fprintf(stderr, "Cannot subscribe at %s:%u\n", scenario.brokerHost.c_str(), scenario.brokerPort);
+        return 1;
+    }
+
+    int reportPipe[2];
+    if (::pipe(reportPipe) != 0)
+    {
+        std::perror("pipe");
+        return 1;
+    }
+    ::fcntl(reportPipe[0], F_SETFL, O_NONBLOCK);
+
+    std::printf("Fleet of %u devices, %u scans each over %u ms (%s), batching %s, batch %u, offline buffer %u",
+                fleet.devices, scenario.scans, scenario.overMs, harness::toString(scenario.shape),
+                scenario.attendance.batchingEnabled ? "on" : "off", scenario.attendance.batchMaxSize,
+                scenario.attendance.offlineBufferSize);
+    if (scenario.outageForMs > 0)
+    {
+        std::printf(", AP outage %u-%u ms", scenario.outageAtMs, scenario.outageAtMs + scenario.outageForMs);
+    }
+    std::printf("\n");
+    std::fflush(stdout);
+
+    // Children inherit the shim's clock epoch, so these are the same instants in every process
+    backend.originUs = isic::native::nowUs();
+    const auto startUs{backend.originUs + (fleet.staggerMs + kSettleMs) * 1000ULL};
+
+    std::vector<pid_t> children;
+    for (std::uint32_t device{0}; device < fleet.devices; ++device)
+    {
+        const auto pid{::fork()};
+        if (pid < 0)
+        {
+            std::perror("fork");
+            break;
+        }
+        if (pid == 0)
+        {
+            // The backend's session stays the parent's: drop only this process's copy of the socket
+            ::close(reportPipe[0]);
+            subscriberSocket.stop();
+            if (!fleet.deviceLog)
+            {
+                std::freopen("/dev/null", "w", stdout);
+            }
+            const auto bootUs{backend.originUs + fleet.staggerMs * 1000ULL * device / fleet.devices};
+            writeReport(reportPipe[1], runDevice(device, scenario, bootUs, startUs));
+            std::fflush(stdout);
+            ::_exit(0);
+        }
+        children.push_back(pid);
+    }
+    ::close(reportPipe[1]);
+
+    std::string reportText;
+    const auto drainReports{[&reportText, fd = reportPipe[0]]() {
+        char buffer[4096];
+        for (auto n{::read(fd, buffer, sizeof(buffer))}; n > 0; n = ::read(fd, buffer, sizeof(buffer)))
+        {
+            reportText.append(buffer, static_cast<std::size_t>(n));
+        }
+    }};
+
+    auto running{children.size()};
+    while (running > 0)
+    {
+        subscriber.loop();
+        drainReports();
+        for (int status{0}; ::waitpid(-1, &status, WNOHANG) > 0;)
+        {
+            --running;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    // Whatever was still in flight when the last device stopped
+    const auto tailUs{isic::native::nowUs()};
+    while (isic::native::nowUs() - tailUs < 1'000'000ULL)
+    {
+        subscriber.loop();
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    drainReports();
+    ::close(reportPipe[0]);
+    subscriber.disconnect();
+
+    const auto reports{parseReports(reportText)};
+    std::uint64_t scans{0};
+    std::uint32_t refused{0};
+    std::uint32_t published{0};
+    std::uint32_t failed{0};
+    std::uint32_t reconnects{0};
+    std::uint32_t batches{0};
+    std::uint32_t errors{0};
+    std::uint32_t connected{0};
+    std::vector<std::uint64_t> connectUs;
+    std::vector<std::uint64_t> reconnectUs;
+    for (const auto &report: reports)
+    {
+        scans += report.scans;
+        refused += report.refused;
+        published += report.published;
+        failed += report.failed;
+        reconnects += report.reconnects;
+        batches += report.batches;
+        errors += report.errors;
+        if (report.connectMs >= 0)
+        {
+            ++connected;
+            connectUs.push_back(static_cast<std::uint64_t>(report.connectMs) * 1000ULL);
+        }
+        if (report.reconnectMs >= 0)
+        {
+            reconnectUs.push_back(static_cast<std::uint64_t>(report.reconnectMs) * 1000ULL);
+        }
+    }
+    std::sort(connectUs.begin(), connectUs.end());
+    std::sort(reconnectUs.begin(), reconnectUs.end());
+
+    const auto &bins{backend.bins};
+    Bin total{};
+    std::size_t firstActive{bins.size()};
+    std::size_t lastActive{0};
+    for (std::size_t second{0}; second < bins.size(); ++second)
+    {
+        total.messages += bins[second].messages;
+        total.bytes += bins[second].bytes;
+        total.attendanceMessages += bins[second].attendanceMessages;
+        total.attendanceBytes += bins[second].attendanceBytes;
+        if (bins[second].messages > 0)
+        {
+            firstActive = std::min(firstActive, second);
+            lastActive = second;
+        }
+    }
+    const auto activeSeconds{firstActive <= lastActive ? static_cast<double>(lastActive - firstActive + 1) : 1.0};
+    const auto delivered{backend.uids.size()};
+    const auto lossPercent{scans ? 100.0 * static_cast<double>(scans - std::min<std::uint64_t>(delivered, scans)) /
+                                           static_cast<double>(scans)
+                                 : 0.0};
+    const auto overall{peakOf(bins, 0, bins.size())};
+
+    std::printf("\n%zu/%u devices reported, %u reached the broker; boot to first session ms: p50 %.0f  max %.0f\n",
+                reports.size(), fleet.devices, connected, harness::percentileMs(connectUs, 50),
+                harness::percentileMs(connectUs, 100));
+    std::printf("Injected %llu scans, refused by the bus %u; backend saw %zu distinct records "
+                "(%u duplicates), lost %.2f%%\n",
+                static_cast<unsigned long long>(scans), refused, delivered, backend.duplicates, lossPercent);
+    std::printf("Devices published %u messages (%u attendance batches), %u failed, %u reconnects, %u errors\n",
+                published, batches, failed, reconnects, errors);
+    std::printf("Backend ingress over %.0f s: %u messages (%u attendance), %llu bytes\n", activeSeconds,
+                total.messages, total.attendanceMessages, static_cast<unsigned long long>(total.bytes));
+    std::printf("  mean %.1f msgs/s  %.0f bytes/s   peak %.0f msgs/s  %.0f bytes/s at t=%zu s\n",
+                total.messages / activeSeconds, static_cast<double>(total.bytes) / activeSeconds, overall.messages,
+                overall.bytes, overall.second);
+
+    Peak flush{};
+    if (scenario.outageForMs > 0)
+    {
+        const auto outageEndSecond{static_cast<std::size_t>(
+                (startUs - backend.originUs) / 1'000'000ULL + (scenario.outageAtMs + scenario.outageForMs) / 1000)};
+        flush = peakOf(bins, outageEndSecond, outageEndSecond + kFlushWindowMs / 1000);
+        std::printf("After the outage: %zu/%u devices back, reconnect ms p50 %.0f  max %.0f; "
+                    "flush peak %.0f msgs/s  %.0f bytes/s at t=%zu s\n",
+                    reconnectUs.size(), connected, harness::percentileMs(reconnectUs, 50),
+                    harness::percentileMs(reconnectUs, 100), flush.messages, flush.bytes, flush.second);
+    }
+
+    if (!scenario.jsonPath.empty())
+    {
+        JsonDocument doc;
+        doc["firmware_version"] = FIRMWARE_VERSION;
+        doc["devices"] = fleet.devices;
+        doc["stagger_ms"] = fleet.staggerMs;
+        doc["scans_per_device"] = scenario.scans;
+        doc["over_ms"] = scenario.overMs;
+        doc["shape"] = harness::toString(scenario.shape);
+        doc["batching"] = scenario.attendance.batchingEnabled;
+        doc["batch_max"] = scenario.attendance.batchMaxSize;
+        doc["batch_flush_ms"] = scenario.attendance.batchFlushIntervalMs;
+        doc["offline_buffer"] = scenario.attendance.offlineBufferSize;
+        doc["outage_at_ms"] = scenario.outageAtMs;
+        doc["outage_for_ms"] = scenario.outageForMs;
+        doc["scan_start_s"] = (startUs - backend.originUs) / 1e6;
+        doc["connected"] = connected;
+        doc["injected"] = scans;
+        doc["refused"] = refused;
+        doc["delivered"] = delivered;
+        doc["records_received"] = backend.records;
+        doc["duplicates"] = backend.duplicates;
+        doc["loss_percent"] = lossPercent;
+        doc["published"] = published;
+        doc["failed"] = failed;
+        doc["reconnects"] = reconnects;
+        doc["batches"] = batches;
+        doc["errors"] = errors;
+        doc["messages"] = total.messages;
+        doc["bytes"] = total.bytes;
+        doc["mean_msgs_per_s"] = total.messages / activeSeconds;
+        doc["mean_bytes_per_s"] = static_cast<double>(total.bytes) / activeSeconds;
+        doc["peak_msgs_per_s"] = overall.messages;
+        doc["peak_bytes_per_s"] = overall.bytes;
+        doc["connect_p50_ms"] = harness::percentileMs(connectUs, 50);
+        doc["connect_max_ms"] = harness::percentileMs(connectUs, 100);
+        if (scenario.outageForMs > 0)
+        {
+            doc["reconnected"] = reconnectUs.size();
+            doc["reconnect_p50_ms"] = harness::percentileMs(reconnectUs, 50);
+            doc["reconnect_max_ms"] = harness::percentileMs(reconnectUs, 100);
+            doc["flush_peak_msgs_per_s"] = flush.messages;
+            doc["flush_peak_bytes_per_s"] = flush.bytes;
+        }
+
+        auto timeline{doc["timeline"].to<JsonArray>()};
+        for (const auto &bin: bins)
+        {
+            auto second{timeline.add<JsonObject>()};
+            second["messages"] = bin.messages;
+            second["bytes"] = bin.bytes;
+            second["attendance_messages"] = bin.attendanceMessages;
+            second["attendance_bytes"] = bin.attendanceBytes;
+            second["records"] = bin.records;
+        }
+
+        std::string json;
+        serializeJsonPretty(doc, json);
+        if (auto *file{std::fopen(scenario.jsonPath.c_str(), "w")})
+        {
+            std::fputs(json.c_str(), file);
+            std::fclose(file);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include "Harness.hpp"
+
+#include "services/ConfigService.hpp"
+
+#include <LittleFS.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+namespace isic::native::harness
+{
+const char *toString(const ArrivalShape shape)
+{
+    switch (shape)
+    {
+        case ArrivalShape::Uniform:
+            return "uniform";
+        case ArrivalShape::Poisson:
+            return "poisson";
+        case ArrivalShape::Rush:
+            return "rush";
+    }
+    return "?";
+}
+
+bool parseScenarioOption(const std::string &option, const std::string &value, Scenario &scenario)
+{
+    const auto number{static_cast<std::uint32_t>(std::strtoul(value.c_str(), nullptr, 10))};
+
+    if (option == "--broker")
+    {
+        const auto colon{value.rfind(':')};
+        scenario.brokerHost = value.substr(0, colon);
+        if (colon != std::string::npos)
+        {
+            scenario.brokerPort = static_cast<std::uint16_t>(std::strtoul(value.c_str() + colon + 1, nullptr, 10));
+        }
+        return !scenario.brokerHost.empty();
+    }
+    if (option == "--shape")
+    {
+        for (const auto shape: {ArrivalShape::Uniform, ArrivalShape::Poisson, ArrivalShape::Rush})
+        {
+            if (value == toString(shape))
+            {
+                scenario.shape = shape;
+                return true;
+            }
+        }
+        return false;
+    }
+    if (option == "--batching")
+    {
+        scenario.attendance.batchingEnabled = value == "on";
+        return value == "on" || value == "off";
+    }
+    if (option == "--scans")
+    {
+        scenario.scans = number;
+        return number > 0;
+    }
+
+    struct NumberOption
+    {
+        const char *name;
+        std::uint32_t *target;
+    };
+    const NumberOption numbers[]{
+            {"--over", &scenario.overMs},
+            {"--min-gap", &scenario.minGapMs},
+            {"--seed", &scenario.seed},
+            {"--batch-flush", &scenario.attendance.batchFlushIntervalMs},
+            {"--offline-flush", &scenario.attendance.offlineBufferFlushIntervalMs},
+            {"--outage-at", &scenario.outageAtMs},
+            {"--outage-for", &scenario.outageForMs},
+            {"--drain", &scenario.drainMs},
+    };
+    for (const auto &[name, target]: numbers)
+    {
+        if (option == name)
+        {
+            *target = number;
+            return true;
+        }
+    }
+
+    if (option == "--batch-max")
+    {
+        scenario.attendance.batchMaxSize = static_cast<std::uint8_t>(number);
+        return number > 0 && number <= 255;
+    }
+    if (option == "--offline-buffer")
+    {
+        scenario.attendance.offlineBufferSize = static_cast<std::uint16_t>(number);
+        return number <= 65535;
+    }
+    if (option == "--json")
+    {
+        scenario.jsonPath = value;
+        return true;
+    }
+    return false;
+}
+
+std::vector<std::uint32_t> buildArrivals(const Scenario &scenario, const std::uint32_t seedOffset)
+{
+    std::mt19937 random{scenario.seed + seedOffset};
+    std::uniform_real_distribution<double> unit{0.0, 1.0};
+    const auto span{static_cast<double>(scenario.overMs)};
+    const auto tau{span / 4};
+
+    std::vector<double> times;
+    times.reserve(scenario.scans);
+    for (std::uint32_t i{0}; i < scenario.scans; ++i)
+    {
+        switch (scenario.shape)
+        {
+            case ArrivalShape::Uniform:
+                times.push_back(span * i / scenario.scans);
+                break;
+            case ArrivalShape::Poisson:
+                // N uniform points: a Poisson process conditioned on its count
+                times.push_back(span * unit(random));
+                break;
+            case ArrivalShape::Rush:
+                times.push_back(-tau * std::log(1.0 - unit(random) * (1.0 - std::exp(-span / tau))));
+                break;
+        }
+    }
+    std::sort(times.begin(), times.end());
+
+    std::vector<std::uint32_t> arrivals;
+    arrivals.reserve(times.size());
+    for (const auto time: times)
+    {
+        const auto atMs{static_cast<std::uint32_t>(time)};
+        arrivals.push_back(arrivals.empty() ? atMs : std::max(atMs, arrivals.back() + scenario.minGapMs));
+    }
+    return arrivals;
+}
+
+CardUid syntheticUid(const std::uint16_t device, const std::uint32_t scan)
+{
+    return {0x04,
+            static_cast<std::uint8_t>(scan),
+            static_cast<std::uint8_t>(scan >> 8),
+            static_cast<std::uint8_t>(scan >> 16),
+            static_cast<std::uint8_t>(device),
+            static_cast<std::uint8_t>(device >> 8),
+            0x30};
+}
+
+bool seedConfig(const Scenario &scenario, const std::string &deviceId)
+{
+    Config config{};
+    config.wifi.stationSsid = "isic-native";
+    config.wifi.stationPassword = "native";
+    config.mqtt.brokerAddress = scenario.brokerHost;
+    config.mqtt.port = scenario.brokerPort;
+    config.device.deviceId = deviceId;
+    config.attendance = scenario.attendance;
+
+    LittleFS.begin(true);
+    auto file{LittleFS.open("/config.json", "w")};
+    const auto json{ConfigService::toJson(config)};
+    return file && file.write(reinterpret_cast<const std::uint8_t *>(json.data()), json.size()) == json.size();
+}
+
+double percentileMs(const std::vector<std::uint64_t> &sortedUs, const double percentile)
+{
+    if (sortedUs.empty())
+    {
+        return 0.0;
+    }
+    const auto rank{static_cast<std::size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sortedUs.size())))};
+    return static_cast<double>(sortedUs[std::max<std::size_t>(rank, 1) - 1]) / 1000.0;
+}
+} // namespace isic::native::harness
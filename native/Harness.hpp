@@ -0,0 +1,89 @@
+#ifndef ISIC_NATIVE_HARNESS_HPP
+#define ISIC_NATIVE_HARNESS_HPP
+
+/**
+ * @file Harness.hpp
+ * @brief Scenario pieces shared by the native load tools (isic_load, isic_fleet)
+ *
+ * A scenario is a broker, a scan schedule, the AttendanceConfig under test
+ * and an optional access point outage. Scenario options common to the tools:
+ *
+ *   --broker HOST[:PORT]  broker to use (default 127.0.0.1:1883)
+ *   --scans N             scans per device (default 300)
+ *   --over MS             spread over MS ms (default 300000)
+ *   --shape S             uniform | poisson | rush (default uniform);
+ *                         rush front-loads arrivals like a lecture start
+ *   --min-gap MS          fastest one reader can read cards (default 200)
+ *   --seed N              random seed for poisson / rush (default 1)
+ *   --batching on|off     AttendanceConfig::batchingEnabled (default on)
+ *   --batch-max N         AttendanceConfig::batchMaxSize
+ *   --batch-flush MS      AttendanceConfig::batchFlushIntervalMs
+ *   --offline-buffer N    AttendanceConfig::offlineBufferSize
+ *   --offline-flush MS    AttendanceConfig::offlineBufferFlushIntervalMs
+ *   --outage-at MS        take the access point away MS ms into the run...
+ *   --outage-for MS       ...for MS ms (default 0: stays online)
+ *   --drain MS            keep running at most MS ms after the last scan (default 20000)
+ *   --json FILE           also write the results as JSON
+ */
+
+#include "common/Config.hpp"
+#include "common/Types.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace isic::native::harness
+{
+enum class ArrivalShape : std::uint8_t
+{
+    Uniform,
+    Poisson,
+    Rush, ///< Truncated exponential, a quarter of the window as time constant
+};
+
+struct Scenario
+{
+    std::string brokerHost{"127.0.0.1"};
+    std::uint16_t brokerPort{1883};
+    std::uint32_t scans{300};
+    std::uint32_t overMs{300000};
+    ArrivalShape shape{ArrivalShape::Uniform};
+    std::uint32_t minGapMs{200};
+    std::uint32_t seed{1};
+    AttendanceConfig attendance{};
+    std::uint32_t outageAtMs{0};
+    std::uint32_t outageForMs{0};
+    std::uint32_t drainMs{20000};
+    std::string jsonPath{};
+
+    /// Is the access point out of range @p elapsedMs into the run?
+    [[nodiscard]] bool inOutage(const std::uint32_t elapsedMs) const
+    {
+        return outageForMs > 0 && elapsedMs >= outageAtMs && elapsedMs - outageAtMs < outageForMs;
+    }
+};
+
+[[nodiscard]] const char *toString(ArrivalShape shape);
+
+/**
+ * @brief Apply one "--option value" pair from the list in the file comment
+ *
+ * @return false if @p option is not a scenario option or @p value is invalid
+ */
+[[nodiscard]] bool parseScenarioOption(const std::string &option, const std::string &value, Scenario &scenario);
+
+/// Scan offsets in ms from the start of the run, sorted, at least minGapMs apart
+[[nodiscard]] std::vector<std::uint32_t> buildArrivals(const Scenario &scenario, std::uint32_t seedOffset = 0);
+
+/// UID unique per (device, scan): nothing is debounced and every record maps back to its scan
+[[nodiscard]] CardUid syntheticUid(std::uint16_t device, std::uint32_t scan);
+
+/// Write a /config.json that points the App at the scenario's broker, for LittleFS.begin() to find
+[[nodiscard]] bool seedConfig(const Scenario &scenario, const std::string &deviceId);
+
+/// Nearest-rank percentile of sorted microsecond samples, in ms
+[[nodiscard]] double percentileMs(const std::vector<std::uint64_t> &sortedUs, double percentile);
+} // namespace isic::native::harness
+
+#endif // ISIC_NATIVE_HARNESS_HPP
@@ -0,0 +1,191 @@
+/**
+ * @file HostMain.cpp
+ * @brief Entry point of the native build: the Arduino core's job on a workstation
+ *
+ * Calls src/main.cpp's setup() once and loop() until told to stop, and plays
+ * the hardware through NativeHost.hpp.
+ *
+ * Usage:
+ *   isic_native [--virtual-clock] [--run-for MS] [--fs DIR] [--nfc-irq-pin N]
+ *
+ *   --virtual-clock  millis() advances 1 ms per loop() pass instead of with
+ *                    the wall clock: runs as fast as the host allows and is
+ *                    repeatable
+ *   --run-for MS     exit after MS milliseconds of (firmware) time
+ *   --fs DIR         load LittleFS from DIR at start, write it back at exit
+ *                    (put a config.json there to point MQTT at a local broker)
+ *   --nfc-irq-pin N  GPIO of the simulated PN532 IRQ line (default 27)
+ *
+ * stdin lines starting with SIM: drive the simulation, the rest go to Serial
+ * (so esp_fs_inspector.py commands work over a pipe):
+ *   SIM:TAP <uid hex>      present a card, e.g. SIM:TAP 04a1b2c3
+ *   SIM:WIFI UP|DOWN       bring the access point in or out of range
+ *   SIM:QUIT               leave the loop and exit
+ */
+
+#include "NativeHost.hpp"
+
+#include <Arduino.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+void setup();
+void loop();
+
+namespace
+{
+volatile std::sig_atomic_t g_stopRequested{0};
+std::string g_fsDir{};
+
+void onSignal(int)
+{
+    g_stopRequested = 1;
+}
+
+void saveFilesystem()
+{
+    if (!g_fsDir.empty())
+    {
+        isic::native::exportFilesystem(g_fsDir);
+    }
+}
+
+bool parseHex(const std::string &text, std::vector<std::uint8_t> &bytes)
+{
+    if (text.empty() || text.size() % 2 != 0)
+    {
+        return false;
+    }
+    for (std::size_t i{0}; i < text.size(); i += 2)
+    {
+        char *end{nullptr};
+        const auto pair{text.substr(i, 2)};
+        bytes.push_back(static_cast<std::uint8_t>(std::strtoul(pair.c_str(), &end, 16)));
+        if (*end != '\0')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void handleSimCommand(const std::string &command)
+{
+    if (command.rfind("TAP ", 0) == 0)
+    {
+        std::vector<std::uint8_t> uid;
+        if (parseHex(command.substr(4), uid))
+        {
+            isic::native::presentCard(uid.data(), uid.size());
+            return;
+        }
+    }
+    else if (command == "WIFI UP" || command == "WIFI DOWN")
+    {
+        isic::native::setWiFiLinkUp(command == "WIFI UP");
+        return;
+    }
+    else if (command == "QUIT")
+    {
+        g_stopRequested = 1;
+        return;
+    }
+    std::fprintf(stderr, "[native] unknown command: SIM:%s\n", command.c_str());
+}
+
+/// Move complete stdin lines to Serial or the simulation; never blocks
+void pumpStdin(std::string &pending)
+{
+    char buf[256];
+    for (auto n{::read(STDIN_FILENO, buf, sizeof(buf))}; n > 0; n = ::read(STDIN_FILENO, buf, sizeof(buf)))
+    {
+        pending.append(buf, static_cast<std::size_t>(n));
+    }
+
+    for (auto newline{pending.find('\n')}; newline != std::string::npos; newline = pending.find('\n'))
+    {
+        auto line{pending.substr(0, newline + 1)};
+        pending.erase(0, newline + 1);
+        if (line.rfind("SIM:", 0) == 0)
+        {
+            line.erase(line.find_last_not_of("\r\n") + 1);
+            handleSimCommand(line.substr(4));
+        }
+        else
+        {
+            Serial.feed(line);
+        }
+    }
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    auto runForMs{0UL};
+    for (auto i{1}; i < argc; ++i)
+    {
+        const std::string arg{argv[i]};
+        const auto hasValue{i + 1 < argc};
+        if (arg == "--virtual-clock")
+        {
+            isic::native::setClockMode(isic::native::ClockMode::Virtual);
+        }
+        else if (arg == "--run-for" && hasValue)
+        {
+            runForMs = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--fs" && hasValue)
+        {
+            g_fsDir = argv[++i];
+        }
+        else if (arg == "--nfc-irq-pin" && hasValue)
+        {
+            isic::native::setNfcIrqPin(static_cast<std::uint8_t>(std::strtoul(argv[++i], nullptr, 10)));
+        }
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--virtual-clock] [--run-for MS] [--fs DIR] [--nfc-irq-pin N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (!g_fsDir.empty())
+    {
+        std::fprintf(stderr, "[native] loaded %zu files from %s\n", isic::native::importFilesystem(g_fsDir), g_fsDir.c_str());
+    }
+    // Also runs on ESP.restart() and deep sleep, which exit()
+    std::atexit(saveFilesystem);
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    ::fcntl(STDIN_FILENO, F_SETFL, ::fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+
+    const auto virtualClock{isic::native::getClockMode() == isic::native::ClockMode::Virtual};
+    const auto startMs{millis()};
+    std::string stdinPending;
+
+    setup();
+    while (g_stopRequested == 0 && (runForMs == 0 || millis() - startMs < runForMs))
+    {
+        pumpStdin(stdinPending);
+        loop();
+        if (virtualClock)
+        {
+            isic::native::advanceClockMs(1);
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    Serial.flush();
+    return 0;
+}
@@ -0,0 +1,289 @@
+/**
+ * @file LoadMain.cpp
+ * @brief Scan-to-broker latency harness for the native build
+ *
+ * Runs the full App against a real broker, injects synthetic CardScanned
+ * events on a schedule and subscribes to the device's attendance topic on a
+ * separate connection. Every scan gets its own UID, so each record that
+ * arrives is matched to the moment it was scanned.
+ *
+ * Usage:
+ *   isic_load [options]
+ *
+ * Takes the scenario options listed in Harness.hpp; --scans is the number
+ * of scans to inject into this one device.
+ *
+ * Runs on the wall clock: the broker keeps real time, so latencies are the
+ * host's. Use them to compare configurations, not to predict the device.
+ */
+
+#include "App.hpp"
+#include "Harness.hpp"
+#include "NativeHost.hpp"
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <PubSubClient.h>
+#include <WiFiClient.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+namespace harness = isic::native::harness;
+using harness::Scenario;
+
+struct Scan
+{
+    std::uint32_t atMs{0}; ///< Offset from the start of the run
+    isic::CardUid uid{};
+    std::uint64_t injectedUs{0};
+    std::uint64_t deliveredUs{0};
+};
+
+struct Results
+{
+    std::uint32_t messages{0};
+    std::uint32_t records{0};
+    std::uint32_t duplicates{0};
+    std::uint32_t unknown{0};
+    std::uint64_t payloadBytes{0};
+};
+
+// PubSubClient takes a plain function pointer on non-ESP targets
+std::map<std::string, Scan *> *g_scansByUid{nullptr};
+Results *g_results{nullptr};
+
+std::uint64_t nowUs()
+{
+    return isic::native::nowUs();
+}
+
+bool parseOptions(const int argc, char **argv, Scenario &scenario)
+{
+    for (auto i{1}; i + 1 < argc; i += 2)
+    {
+        if (!harness::parseScenarioOption(argv[i], argv[i + 1], scenario))
+        {
+            return false;
+        }
+    }
+    return (argc % 2) == 1;
+}
+
+std::vector<Scan> buildSchedule(const Scenario &scenario)
+{
+    const auto arrivals{harness::buildArrivals(scenario)};
+    std::vector<Scan> schedule(arrivals.size());
+    for (std::uint32_t i{0}; i < arrivals.size(); ++i)
+    {
+        schedule[i].atMs = arrivals[i];
+        schedule[i].uid = harness::syntheticUid(0, i);
+    }
+    return schedule;
+}
+
+void onAttendance(char * /*topic*/, std::uint8_t *payload, const unsigned int length)
+{
+    const auto arrivedUs{nowUs()};
+    ++g_results->messages;
+    g_results->payloadBytes += length;
+
+    JsonDocument doc;
+    if (deserializeJson(doc, payload, length))
+    {
+        return;
+    }
+    for (const auto record: doc.as<JsonArrayConst>())
+    {
+        ++g_results->records;
+        const auto it{g_scansByUid->find(record["uid"].as<std::string>())};
+        if (it == g_scansByUid->end())
+        {
+            ++g_results->unknown;
+        }
+        else if (it->second->deliveredUs != 0)
+        {
+            ++g_results->duplicates;
+        }
+        else
+        {
+            it->second->deliveredUs = arrivedUs;
+        }
+    }
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Scenario scenario{};
+    if (!parseOptions(argc, argv, scenario))
+    {
+        std::fprintf(stderr, "Usage: %s [--scans N] [--over MS] [--shape uniform|poisson|rush] [--batching on|off] ...\n"
+                             "See the comment at the top of native/Harness.hpp for every option.\n", argv[0]);
+        return 2;
+    }
+
+    const std::string deviceId{"load-" + std::to_string(::getpid())};
+    if (!harness::seedConfig(scenario, deviceId))
+    {
+        std::fprintf(stderr, "Cannot write /config.json\n");
+        return 1;
+    }
+
+    auto schedule{buildSchedule(scenario)};
+    std::map<std::string, Scan *> scansByUid;
+    for (auto &scan: schedule)
+    {
+        scansByUid[isic::cardUidToString(scan.uid)] = &scan;
+    }
+    Results results{};
+    g_scansByUid = &scansByUid;
+    g_results = &results;
+
+    Serial.begin(115200);
+    auto app{std::make_unique<isic::App>()};
+    if (const auto status{app->begin()}; status.failed())
+    {
+        std::fprintf(stderr, "App init failed: %s\n", status.message ? status.message : "unknown");
+        return 1;
+    }
+
+    // The subscriber is the backend: outside the simulated AP, unaffected by the outage
+    isic::native::HostClient subscriberSocket;
+    PubSubClient subscriber{subscriberSocket};
+    subscriber.setServer(scenario.brokerHost.c_str(), scenario.brokerPort);
+    subscriber.setBufferSize(isic::MqttConfig::Constants::kMaxPayloadSizeBytes + 256);
+    subscriber.setCallback(onAttendance);
+    const auto topic{app->getMqttService().getTopicPrefix() + "attendance"};
+    if (!subscriber.connect((deviceId + "-sub").c_str()) || !subscriber.subscribe(topic.c_str()))
+    {
+        std::fprintf(stderr, "Cannot subscribe at %s:%u\n", scenario.brokerHost.c_str(), scenario.brokerPort);
+        return 1;
+    }
+
+    const auto step{[&app, &subscriber]() {
+        app->loop();
+        subscriber.loop();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }};
+
+    // Start only once the device is online, so the first scans do not measure the boot
+    const auto bootUs{nowUs()};
+    while (!app->getMqttService().isConnected())
+    {
+        if (nowUs() - bootUs > 15'000'000)
+        {
+            std::fprintf(stderr, "Device did not reach the broker within 15 s\n");
+            return 1;
+        }
+        step();
+    }
+
+    std::printf("Injecting %u scans over %u ms (%s), batching %s, batch %u, offline buffer %u",
+                scenario.scans, scenario.overMs, harness::toString(scenario.shape),
+                scenario.attendance.batchingEnabled ? "on" : "off", scenario.attendance.batchMaxSize, scenario.attendance.offlineBufferSize);
+    if (scenario.outageForMs > 0)
+    {
+        std::printf(", AP outage %u-%u ms", scenario.outageAtMs, scenario.outageAtMs + scenario.outageForMs);
+    }
+    std::printf("\n");
+
+    auto &bus{app->getEventBus()};
+    const auto startUs{nowUs()};
+    const auto elapsedMs{[startUs]() { return static_cast<std::uint32_t>((nowUs() - startUs) / 1000); }};
+    std::size_t next{0};
+    std::uint32_t refused{0};
+    while (next < schedule.size())
+    {
+        const auto atMs{elapsedMs()};
+        if (scenario.outageForMs > 0)
+        {
+            isic::native::setWiFiLinkUp(!scenario.inOutage(atMs));
+        }
+        while (next < schedule.size() && schedule[next].atMs <= atMs)
+        {
+            auto &scan{schedule[next++]};
+            scan.injectedUs = nowUs();
+            if (!bus.publish(isic::Event{isic::EventType::CardScanned, isic::CardEvent{static_cast<std::uint32_t>(millis()), scan.uid}}))
+            {
+                ++refused;
+            }
+        }
+        step();
+    }
+    isic::native::setWiFiLinkUp(true);
+
+    const auto drainStartUs{nowUs()};
+    while (results.records - results.duplicates - results.unknown < schedule.size() &&
+           nowUs() - drainStartUs < scenario.drainMs * 1000ULL)
+    {
+        step();
+    }
+
+    std::vector<std::uint64_t> latenciesUs;
+    for (const auto &scan: schedule)
+    {
+        if (scan.deliveredUs != 0)
+        {
+            latenciesUs.push_back(scan.deliveredUs - scan.injectedUs);
+        }
+    }
+    std::sort(latenciesUs.begin(), latenciesUs.end());
+    const auto lost{schedule.size() - latenciesUs.size()};
+    const auto lossPercent{100.0 * static_cast<double>(lost) / static_cast<double>(schedule.size())};
+
+    std::printf("\nDelivered %zu/%zu scans in %u messages (%llu payload bytes), lost %zu (%.2f%%), "
+                "duplicates %u, refused by the bus %u\n",
+                latenciesUs.size(), schedule.size(), results.messages,
+                static_cast<unsigned long long>(results.payloadBytes), lost, lossPercent, results.duplicates, refused);
+    std::printf("Scan-to-broker latency ms: p50 %.1f  p95 %.1f  p99 %.1f  max %.1f\n",
+                harness::percentileMs(latenciesUs, 50), harness::percentileMs(latenciesUs, 95),
+                harness::percentileMs(latenciesUs, 99), harness::percentileMs(latenciesUs, 100));
+
+    if (!scenario.jsonPath.empty())
+    {
+        JsonDocument doc;
+        doc["firmware_version"] = FIRMWARE_VERSION;
+        doc["scans"] = scenario.scans;
+        doc["over_ms"] = scenario.overMs;
+        doc["shape"] = harness::toString(scenario.shape);
+        doc["batching"] = scenario.attendance.batchingEnabled;
+        doc["batch_max"] = scenario.attendance.batchMaxSize;
+        doc["batch_flush_ms"] = scenario.attendance.batchFlushIntervalMs;
+        doc["offline_buffer"] = scenario.attendance.offlineBufferSize;
+        doc["outage_at_ms"] = scenario.outageAtMs;
+        doc["outage_for_ms"] = scenario.outageForMs;
+        doc["delivered"] = latenciesUs.size();
+        doc["lost"] = lost;
+        doc["loss_percent"] = lossPercent;
+        doc["duplicates"] = results.duplicates;
+        doc["refused"] = refused;
+        doc["messages"] = results.messages;
+        doc["payload_bytes"] = results.payloadBytes;
+        doc["p50_ms"] = harness::percentileMs(latenciesUs, 50);
+        doc["p95_ms"] = harness::percentileMs(latenciesUs, 95);
+        doc["p99_ms"] = harness::percentileMs(latenciesUs, 99);
+        doc["max_ms"] = harness::percentileMs(latenciesUs, 100);
+
+        std::string json;
+        serializeJsonPretty(doc, json);
+        if (auto *file{std::fopen(scenario.jsonPath.c_str(), "w")})
+        {
+            std::fputs(json.c_str(), file);
+            std::fclose(file);
+        }
+    }
+
+    subscriber.disconnect();
+    return 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file ReplayMain.cpp
+ * @brief Replays an event journal through the full App on a virtual clock
+ *
+ * Builds the same App as the firmware, then feeds a journal recorded by
+ * utils/EventJournalRecorder.hpp into its bus and topic router with
+ * journal::Replayer. Between entries the App's loop() runs in 1 ms steps of
+ * virtual time, so scheduler tasks, dispatch and bus timers fire as they
+ * did on the device; an hour of traffic replays in seconds.
+ *
+ * Usage:
+ *   isic_replay JOURNAL [--fs DIR] [--drain MS]
+ *
+ *   --fs DIR    seed LittleFS from DIR. Leave WiFi unconfigured there:
+ *               connectivity then comes only from the journal's events
+ *   --drain MS  keep running MS ms past the last entry (default 5000)
+ *
+ * Lines that are not journal entries (esp_fs_inspector.py banners) are
+ * counted as malformed and skipped.
+ */
+
+#include "App.hpp"
+#include "NativeHost.hpp"
+#include "core/EventJournal.hpp"
+
+#include <Arduino.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s JOURNAL [--fs DIR] [--drain MS]\n", argv[0]);
+        return 2;
+    }
+
+    std::uint32_t drainMs{5000};
+    for (auto i{2}; i + 1 < argc; i += 2)
+    {
+        const std::string arg{argv[i]};
+        if (arg == "--fs")
+        {
+            isic::native::importFilesystem(argv[i + 1]);
+        }
+        else if (arg == "--drain")
+        {
+            drainMs = static_cast<std::uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        }
+    }
+
+    std::ifstream journal{argv[1]};
+    if (!journal)
+    {
+        std::fprintf(stderr, "Cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    isic::native::setClockMode(isic::native::ClockMode::Virtual);
+    Serial.begin(115200);
+
+    auto app{std::make_unique<isic::App>()};
+    if (const auto status{app->begin()}; status.failed())
+    {
+        std::fprintf(stderr, "App init failed: %s\n", status.message ? status.message : "unknown");
+        return 1;
+    }
+
+    const auto runUntil{[&app](const std::uint32_t ms) {
+        while (static_cast<std::int32_t>(millis() - ms) < 0)
+        {
+            app->loop();
+            isic::native::advanceClockMs(1);
+        }
+    }};
+
+    const auto wallStart{std::chrono::steady_clock::now()};
+    isic::journal::Replayer replayer{app->getEventBus(), app->getTopicRouter()};
+    std::string line;
+    while (std::getline(journal, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        replayer.replay(line, runUntil);
+    }
+    runUntil(millis() + drainMs);
+    const auto wallMs{std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - wallStart).count()};
+
+    const auto &stats{replayer.getStats()};
+    std::printf("\nReplayed %u events and %u inbound messages (%u ms of device time) in %lld ms\n", stats.events,
+                stats.inbound, stats.lastMs - stats.firstMs, static_cast<long long>(wallMs));
+    std::printf("  refused by the bus: %u\n  unrouted messages:  %u\n  malformed lines:    %u\n", stats.refused,
+                stats.unrouted, stats.malformed);
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+namespace
+{
+std::atomic<std::uint64_t> g_allocationCount{0};
+std::atomic<std::uint64_t> g_allocationBytes{0};
+
+void record(const std::size_t bytes)
+{
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocationBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+} // namespace
+
+#if defined(__GLIBC__)
+// glibc lets the executable interpose these; the real allocator stays underneath
+extern "C"
+{
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *pointer, std::size_t size);
+void __libc_free(void *pointer);
+
+void *malloc(const std::size_t size)
+{
+    record(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(const std::size_t count, const std::size_t size)
+{
+    record(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, const std::size_t size)
+{
+    record(size);
+    return __libc_realloc(pointer, size);
+}
+
+void free(void *pointer)
+{
+    __libc_free(pointer);
+}
+}
+#endif
+
+namespace isic::bench
+{
+bool allocationCountingEnabled()
+{
+#if defined(__GLIBC__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+AllocationStats allocationStats()
+{
+    return {g_allocationCount.load(std::memory_order_relaxed), g_allocationBytes.load(std::memory_order_relaxed)};
+}
+} // namespace isic::bench
@@ -0,0 +1,63 @@
+#ifndef ISIC_NATIVE_BENCH_ALLOCATION_COUNTER_HPP
+#define ISIC_NATIVE_BENCH_ALLOCATION_COUNTER_HPP
+
+/**
+ * @file AllocationCounter.hpp
+ * @brief Heap allocation counting for the host benchmarks
+ *
+ * Counts every malloc/calloc/realloc in the process, so allocations made by
+ * operator new and by ArduinoJson's default allocator both show up. Only
+ * available on glibc, where malloc can be interposed; elsewhere the counters
+ * stay at zero and allocationCountingEnabled() is false.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace isic::bench
+{
+struct AllocationStats
+{
+    std::uint64_t count{0};
+    std::uint64_t bytes{0};
+};
+
+[[nodiscard]] bool allocationCountingEnabled();
+[[nodiscard]] AllocationStats allocationStats();
+
+/**
+ * @brief Reports allocs/op and alloc_bytes/op for one benchmark run
+ *
+ * Construct right before the `for (auto _ : state)` loop; the counters are
+ * written when it goes out of scope. Setup done inside the loop under
+ * PauseTiming() is counted too, so keep that allocation free.
+ */
+class AllocationScope
+{
+public:
+    explicit AllocationScope(benchmark::State &state)
+        : m_state(state)
+        , m_start(allocationStats())
+    {
+    }
+
+    ~AllocationScope()
+    {
+        const auto end{allocationStats()};
+        m_state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(end.count - m_start.count),
+                                                           benchmark::Counter::kAvgIterations);
+        m_state.counters["alloc_bytes/op"] = benchmark::Counter(static_cast<double>(end.bytes - m_start.bytes),
+                                                                benchmark::Counter::kAvgIterations);
+    }
+
+    AllocationScope(const AllocationScope &) = delete;
+    AllocationScope &operator=(const AllocationScope &) = delete;
+
+private:
+    benchmark::State &m_state;
+    AllocationStats m_start;
+};
+} // namespace isic::bench
+
+#endif // ISIC_NATIVE_BENCH_ALLOCATION_COUNTER_HPP
@@ -0,0 +1,29 @@
+/**
+ * @file BenchMain.cpp
+ * @brief Entry point of isic_bench, the host micro-benchmarks
+ *
+ * Google Benchmark's own main(), plus the firmware version in the context
+ * block so JSON results from different builds can be told apart:
+ *
+ *   isic_bench --benchmark_out=bench-1.0.3.json --benchmark_out_format=json
+ *   python3 tools/bench_compare.py bench-1.0.2.json bench-1.0.3.json
+ */
+
+#include "AllocationCounter.hpp"
+
+#include <benchmark/benchmark.h>
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    benchmark::AddCustomContext("firmware_version", FIRMWARE_VERSION);
+    benchmark::AddCustomContext("allocation_counting", isic::bench::allocationCountingEnabled() ? "malloc" : "off");
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
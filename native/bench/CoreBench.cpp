@@ -0,0 +1,198 @@
+/**
+ * @file CoreBench.cpp
+ * @brief Signal and EventBus delivery cost
+ */
+
+#include "AllocationCounter.hpp"
+
+#include "core/DebounceTable.hpp"
+#include "core/EventBus.hpp"
+#include "core/Signal.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <vector>
+
+namespace isic::bench
+{
+namespace
+{
+// ============================================================================
+// Signal
+// ============================================================================
+
+/// One publish() + dispatch() round trip to Arg(0) queued subscribers
+void BM_Signal_PublishDispatch(benchmark::State &state)
+{
+    Signal<std::uint32_t> signal;
+    std::vector<Signal<std::uint32_t>::ScopedConnection> connections;
+    std::uint32_t sink{0};
+    for (auto i{0}; i < state.range(0); ++i)
+    {
+        connections.push_back(signal.connectScoped([&sink](const std::uint32_t value) { sink += value; }));
+    }
+
+    const AllocationScope allocations{state};
+    std::uint32_t value{0};
+    for (auto _: state)
+    {
+        signal.publish(++value);
+        signal.dispatch();
+    }
+    benchmark::DoNotOptimize(sink);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Signal_PublishDispatch)->RangeMultiplier(2)->Range(1, 32);
+
+/// publish() alone, slots run inline; the ring is drained every 8 events outside the timing
+void BM_Signal_PublishDirect(benchmark::State &state)
+{
+    Signal<std::uint32_t> signal;
+    std::vector<Signal<std::uint32_t>::ScopedConnection> connections;
+    std::uint32_t sink{0};
+    for (auto i{0}; i < state.range(0); ++i)
+    {
+        connections.push_back(
+                signal.connectScoped([&sink](const std::uint32_t value) { sink += value; }, ConnectionMode::Direct));
+    }
+    signal.dispatch(); // Makes this thread the dispatch task, which Direct delivery requires
+
+    const AllocationScope allocations{state};
+    std::uint32_t value{0};
+    for (auto _: state)
+    {
+        signal.publish(++value);
+        if ((value & 7U) == 0)
+        {
+            state.PauseTiming();
+            signal.dispatch();
+            state.ResumeTiming();
+        }
+    }
+    benchmark::DoNotOptimize(sink);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Signal_PublishDirect)->RangeMultiplier(2)->Range(1, 32);
+
+// ============================================================================
+// EventBus
+// ============================================================================
+
+/// The traffic of one tap while online, in publish order
+std::array<Event, 8> tapTraffic()
+{
+    return {
+            Event{EventType::CardScanned, CardEvent{1000, {0x04, 0xA1, 0xB2, 0xC3}}},
+            Event{EventType::AttendanceRecorded},
+            Event{EventType::FeedbackRequest, FeedbackEvent{}},
+            Event{EventType::MqttPublishRequest, MqttEvent{"attendance", "[{\"uid\":\"C3B2A104\",\"seq\":1}]", false}},
+            Event{EventType::HealthChanged},
+            Event{EventType::PowerStateChange, PowerEvent{}},
+            Event{EventType::CardRemoved},
+            Event{EventType::NfcReady},
+    };
+}
+
+/// Publish one tap's worth of mixed events, then dispatch them all
+void BM_EventBus_DispatchMixed(benchmark::State &state)
+{
+    EventBus bus;
+    std::vector<EventBus::ScopedConnection> connections;
+    std::uint32_t delivered{0};
+    const auto traffic{tapTraffic()};
+    for (const auto &event: traffic)
+    {
+        for (auto i{0}; i < state.range(0); ++i)
+        {
+            connections.push_back(bus.subscribeScoped(event.type, [&delivered](const Event &) { ++delivered; }));
+        }
+    }
+
+    const AllocationScope allocations{state};
+    for (auto _: state)
+    {
+        for (const auto &event: traffic)
+        {
+            bus.publish(Event{event});
+        }
+        bus.dispatch();
+    }
+    benchmark::DoNotOptimize(delivered);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(traffic.size()));
+    state.counters["delivered/op"] =
+            benchmark::Counter(static_cast<double>(delivered), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_EventBus_DispatchMixed)->Arg(1)->Arg(2)->Arg(4);
+
+/// A payload-free event through one Direct subscriber, as AttendanceRecorded reaches FeedbackService
+void BM_EventBus_PublishDirect(benchmark::State &state)
+{
+    EventBus bus;
+    std::uint32_t delivered{0};
+    const auto connection{bus.subscribeScoped(
+            EventType::AttendanceRecorded, [&delivered](const Event &) { ++delivered; }, ConnectionMode::Direct)};
+    bus.dispatch();
+
+    const AllocationScope allocations{state};
+    for (auto _: state)
+    {
+        bus.publish(EventType::AttendanceRecorded);
+        bus.dispatch();
+    }
+    benchmark::DoNotOptimize(delivered);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EventBus_PublishDirect);
+
+// ============================================================================
+// DebounceTable
+// ============================================================================
+
+/**
+ * A steady stream of new cards, one every 50 ms, against a 60 s window:
+ * about 1200 cards are live and older ones expire as fast as new ones
+ * arrive. Arg(0) is the capacity; below 1200 the table runs full and
+ * evicts (evictions/op), above it the lazy sweep keeps up on its own.
+ */
+void BM_DebounceTable_Churn(benchmark::State &state)
+{
+    DebounceTable table;
+    table.reset(static_cast<std::size_t>(state.range(0)));
+
+    const AllocationScope allocations{state};
+    std::uint32_t card{0};
+    std::uint32_t nowMs{1};
+    for (auto _: state)
+    {
+        ++card;
+        const CardUid uid{0x04, static_cast<std::uint8_t>(card), static_cast<std::uint8_t>(card >> 8),
+                          static_cast<std::uint8_t>(card >> 16), static_cast<std::uint8_t>(card >> 24), 0xE5, 0xF6};
+        benchmark::DoNotOptimize(table.admit(uid, nowMs += 50, 60000));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["evictions/op"] = benchmark::Counter(static_cast<double>(table.getMetrics().evictions),
+                                                        benchmark::Counter::kAvgIterations);
+    state.counters["peak_entries"] = table.getMetrics().peakEntries;
+}
+BENCHMARK(BM_DebounceTable_Churn)->Arg(256)->Arg(2048);
+
+// ============================================================================
+// Types
+// ============================================================================
+
+void BM_CardUidToString(benchmark::State &state)
+{
+    const CardUid uid{0x04, 0xA1, 0xB2, 0xC3, 0xD4, 0xE5, 0xF6};
+
+    const AllocationScope allocations{state};
+    for (auto _: state)
+    {
+        auto text{cardUidToString(uid)};
+        benchmark::DoNotOptimize(text);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CardUidToString);
+} // namespace
+} // namespace isic::bench
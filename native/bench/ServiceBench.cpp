@@ -0,0 +1,236 @@
+/**
+ * @file ServiceBench.cpp
+ * @brief Per-tap and per-publish work inside the services
+ */
+
+#include "AllocationCounter.hpp"
+
+#include "services/AttendanceService.hpp"
+#include "services/ConfigService.hpp"
+#include "services/MqttService.hpp"
+
+#include <ArduinoJson.h>
+#include <Print.h>
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace isic::bench
+{
+namespace
+{
+CardUid cardUid(const std::uint32_t student)
+{
+    return {0x04, static_cast<std::uint8_t>(student), static_cast<std::uint8_t>(student >> 8),
+            static_cast<std::uint8_t>(student >> 16), 0xD4, 0xE5, 0xF6};
+}
+
+// ============================================================================
+// AttendanceService
+// ============================================================================
+
+/**
+ * Arg(0) students tap in turn, 50 ms apart, all inside the debounce window:
+ * every tap after the first round should be debounced. With the table sized
+ * for the largest crowd, debounced/op stays at 1 and a tap probes about one
+ * slot at every size; what growth remains is the table outgrowing the cache.
+ */
+void BM_Attendance_ShouldProcessCard(benchmark::State &state)
+{
+    EventBus bus;
+    AttendanceConfig config{};
+    config.debounceIntervalMs = 3600000;
+    config.debounceCacheSize = DebounceTable::kMaxCapacity;
+    AttendanceService service{bus, config};
+    (void) service.begin();
+
+    const auto students{static_cast<std::uint32_t>(state.range(0))};
+    std::vector<CardUid> uids;
+    for (std::uint32_t i{0}; i < students; ++i)
+    {
+        uids.push_back(cardUid(i));
+    }
+    std::uint32_t nowMs{1};
+    for (const auto &uid: uids)
+    {
+        (void) service.shouldProcessCard(uid, nowMs += 50);
+    }
+
+    const AllocationScope allocations{state};
+    std::uint32_t next{0};
+    std::uint64_t debounced{0};
+    for (auto _: state)
+    {
+        debounced += service.shouldProcessCard(uids[next], nowMs += 50) ? 0 : 1;
+        next = next + 1 == students ? 0 : next + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["debounced/op"] = benchmark::Counter(static_cast<double>(debounced), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_Attendance_ShouldProcessCard)->Arg(1)->Arg(8)->Arg(9)->Arg(64)->Arg(512)->Arg(2048);
+
+std::vector<AttendanceRecord> attendanceRecords(const std::int64_t count)
+{
+    std::vector<AttendanceRecord> records;
+    for (std::uint32_t i{0}; i < static_cast<std::uint32_t>(count); ++i)
+    {
+        records.push_back({.timestampMs = 1000 + i, .sequence = i + 1, .cardUid = cardUid(i)});
+    }
+    return records;
+}
+
+/// Stands in for the MQTT client: counts what reaches the socket, keeps none of it
+class CountingPrint : public Print
+{
+public:
+    std::size_t write(const std::uint8_t /*c*/) override
+    {
+        ++m_bytes;
+        ++m_writes;
+        return 1;
+    }
+
+    std::size_t write(const std::uint8_t * /*buffer*/, const std::size_t size) override
+    {
+        m_bytes += size;
+        ++m_writes;
+        return size;
+    }
+
+    std::size_t m_bytes{0};
+    std::size_t m_writes{0};
+};
+
+/**
+ * The batch path before streaming, for reference: a JsonDocument, its JSON in
+ * a pooled block, then PubSubClient::publish() copying that into its own
+ * buffer. copied_bytes/record counts the bytes written to buffers on the way
+ * to the socket (the document tree shows in alloc_bytes/op instead).
+ */
+void BM_Attendance_JsonDocumentBatch(benchmark::State &state)
+{
+    const auto records{attendanceRecords(state.range(0))};
+    static char clientBuffer[MqttConfig::Constants::kMaxPayloadSizeBytes];
+
+    const AllocationScope allocations{state};
+    std::size_t bytes{0};
+    for (auto _: state)
+    {
+        JsonDocument doc;
+        const auto array{doc.to<JsonArray>()};
+        for (const auto &record: records)
+        {
+            const auto object{array.add<JsonObject>()};
+            object["uid"] = cardUidToString(record.cardUid);
+            object["ts"] = std::uint64_t{1712345678901};
+            object["seq"] = record.sequence;
+        }
+        const auto payload{serializeJsonPayload(doc)};
+        bytes = payload.length();
+        std::memcpy(clientBuffer, payload.data(), std::min(bytes, sizeof(clientBuffer)));
+        benchmark::DoNotOptimize(clientBuffer);
+    }
+    const auto count{static_cast<double>(state.range(0))};
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["payload_bytes/record"] = static_cast<double>(bytes) / count;
+    state.counters["copied_bytes/record"] = static_cast<double>(2 * bytes) / count;
+}
+BENCHMARK(BM_Attendance_JsonDocumentBatch)->Arg(1)->Arg(5)->Arg(20)->Arg(100);
+
+/**
+ * The batch path now: packBatch() copies the records into a pooled block and
+ * a PayloadWriter formats them through its stack scratch into the client,
+ * once to measure and once to write. copied_bytes/record counts the packed
+ * records plus the scratch fills, the same buffers-before-the-socket measure
+ * as above; payload_bytes/record is what goes on air for each format.
+ */
+void BM_Attendance_StreamBatch(benchmark::State &state, const PayloadWriter writer)
+{
+    const auto records{attendanceRecords(state.range(0))};
+
+    const AllocationScope allocations{state};
+    std::size_t packedBytes{0};
+    CountingPrint socket;
+    for (auto _: state)
+    {
+        socket = CountingPrint{};
+        const auto packed{AttendanceService::packBatch(records)};
+        packedBytes = packed.size();
+        const auto length{writer(packed.view(), nullptr)};
+        benchmark::DoNotOptimize(length);
+        writer(packed.view(), &socket);
+    }
+    const auto count{static_cast<double>(state.range(0))};
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["payload_bytes/record"] = static_cast<double>(socket.m_bytes) / count;
+    state.counters["copied_bytes/record"] = static_cast<double>(packedBytes + socket.m_bytes) / count;
+    state.counters["writes/record"] = static_cast<double>(socket.m_writes) / count;
+}
+BENCHMARK_CAPTURE(BM_Attendance_StreamBatch, json, &AttendanceService::writeBatchJson)->Arg(1)->Arg(5)->Arg(20)->Arg(100);
+BENCHMARK_CAPTURE(BM_Attendance_StreamBatch, packed, &AttendanceService::writeBatchPacked)->Arg(1)->Arg(5)->Arg(20)->Arg(100);
+
+// ============================================================================
+// ConfigService
+// ============================================================================
+
+void BM_Config_ToJson(benchmark::State &state)
+{
+    const Config config{};
+
+    const AllocationScope allocations{state};
+    std::size_t bytes{0};
+    for (auto _: state)
+    {
+        const auto json{ConfigService::toJson(config)};
+        bytes = json.size();
+        benchmark::DoNotOptimize(json.data());
+    }
+    state.counters["json_bytes"] = static_cast<double>(bytes);
+}
+BENCHMARK(BM_Config_ToJson);
+
+void BM_Config_FromJson(benchmark::State &state)
+{
+    Config changed{};
+    changed.mqtt.brokerAddress = "192.168.0.10";
+    changed.device.deviceId = "reader-01";
+    const auto json{ConfigService::toJson(changed)};
+
+    const AllocationScope allocations{state};
+    for (auto _: state)
+    {
+        // Every field is applied onto defaults, as on a boot from /config.json
+        Config config{};
+        benchmark::DoNotOptimize(ConfigService::fromJson(json, config));
+    }
+}
+BENCHMARK(BM_Config_FromJson);
+
+// ============================================================================
+// MqttService
+// ============================================================================
+
+void BM_Mqtt_BuildTopic(benchmark::State &state)
+{
+    EventBus bus;
+    TopicRouter router;
+    MqttConfig mqttConfig{};
+    mqttConfig.baseTopic = "isic/attendance";
+    DeviceConfig deviceConfig{};
+    deviceConfig.deviceId = "reader-01";
+    MqttService service{bus, router, mqttConfig, deviceConfig};
+    (void) service.begin();
+
+    const AllocationScope allocations{state};
+    for (auto _: state)
+    {
+        const auto topic{service.buildTopic("attendance")};
+        benchmark::DoNotOptimize(topic.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Mqtt_BuildTopic);
+} // namespace
+} // namespace isic::bench
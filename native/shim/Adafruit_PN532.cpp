@@ -0,0 +1,127 @@
+#include "Adafruit_PN532.h"
+#include "Arduino.h"
+#include "NativeHost.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+namespace
+{
+constexpr std::uint32_t kFirmwareVersion{0x32010607}; // PN532, v1.6
+constexpr std::size_t kMaxUidLength{7};
+
+struct Reader
+{
+    std::deque<std::vector<std::uint8_t>> cards{};
+    std::uint8_t irqPin{27}; // Pn532Config::kDefaultIrqPin on ESP32
+    bool detectionPending{false};
+};
+
+Reader &reader()
+{
+    static Reader instance;
+    return instance;
+}
+
+int irqLevel()
+{
+    return reader().detectionPending && !reader().cards.empty() ? LOW : HIGH;
+}
+
+bool takeCard(std::uint8_t *uid, std::uint8_t *uidLength)
+{
+    if (reader().cards.empty())
+    {
+        return false;
+    }
+    const auto &card{reader().cards.front()};
+    *uidLength = static_cast<std::uint8_t>(card.size());
+    std::copy(card.begin(), card.end(), uid);
+    reader().cards.pop_front();
+    return true;
+}
+} // namespace
+
+namespace isic::native
+{
+void presentCard(const std::uint8_t *uid, const std::size_t length)
+{
+    reader().cards.emplace_back(uid, uid + std::min(length, kMaxUidLength));
+}
+
+std::size_t pendingCards()
+{
+    return reader().cards.size();
+}
+
+void setNfcIrqPin(const std::uint8_t pin)
+{
+    setPinSource(reader().irqPin, nullptr);
+    reader().irqPin = pin;
+    setPinSource(pin, irqLevel);
+}
+} // namespace isic::native
+
+Adafruit_PN532::Adafruit_PN532(const std::uint8_t clk, const std::uint8_t miso, const std::uint8_t mosi,
+                               const std::uint8_t ss)
+{
+    (void) clk;
+    (void) miso;
+    (void) mosi;
+    (void) ss;
+    isic::native::setPinSource(reader().irqPin, irqLevel);
+}
+
+bool Adafruit_PN532::begin()
+{
+    return true;
+}
+
+void Adafruit_PN532::wakeup()
+{
+}
+
+std::uint32_t Adafruit_PN532::getFirmwareVersion()
+{
+    return kFirmwareVersion;
+}
+
+bool Adafruit_PN532::SAMConfig()
+{
+    return true;
+}
+
+bool Adafruit_PN532::sendCommandCheckAck(std::uint8_t *cmd, const std::uint8_t cmdlen, const std::uint16_t timeout)
+{
+    (void) cmd;
+    (void) cmdlen;
+    (void) timeout;
+    return true;
+}
+
+bool Adafruit_PN532::startPassiveTargetIDDetection(const std::uint8_t cardbaudrate)
+{
+    (void) cardbaudrate;
+    reader().detectionPending = true;
+    return !reader().cards.empty();
+}
+
+bool Adafruit_PN532::readDetectedPassiveTargetID(std::uint8_t *uid, std::uint8_t *uidLength)
+{
+    reader().detectionPending = false;
+    return takeCard(uid, uidLength);
+}
+
+bool Adafruit_PN532::readPassiveTargetID(const std::uint8_t cardbaudrate, std::uint8_t *uid, std::uint8_t *uidLength,
+                                         const std::uint16_t timeout)
+{
+    (void) cardbaudrate;
+    if (takeCard(uid, uidLength))
+    {
+        return true;
+    }
+    // The real reader blocks for the whole timeout when the field is empty
+    delay(timeout);
+    return false;
+}
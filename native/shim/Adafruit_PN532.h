@@ -0,0 +1,31 @@
+#ifndef ISIC_NATIVE_ADAFRUIT_PN532_H
+#define ISIC_NATIVE_ADAFRUIT_PN532_H
+
+#include <cstdint>
+
+#define PN532_MIFARE_ISO14443A (0x00)
+
+/**
+ * Simulated PN532 with a v1.6 firmware. Cards come from
+ * isic::native::presentCard(); each is read exactly once. While a detection
+ * started by startPassiveTargetIDDetection() is pending, the reader pulls
+ * the IRQ pin (isic::native::setNfcIrqPin) LOW as soon as a card arrives.
+ */
+class Adafruit_PN532
+{
+public:
+    Adafruit_PN532(std::uint8_t clk, std::uint8_t miso, std::uint8_t mosi, std::uint8_t ss);
+
+    bool begin();
+    void wakeup();
+    std::uint32_t getFirmwareVersion();
+    bool SAMConfig();
+    bool sendCommandCheckAck(std::uint8_t *cmd, std::uint8_t cmdlen, std::uint16_t timeout = 100);
+
+    bool startPassiveTargetIDDetection(std::uint8_t cardbaudrate);
+    bool readDetectedPassiveTargetID(std::uint8_t *uid, std::uint8_t *uidLength);
+    bool readPassiveTargetID(std::uint8_t cardbaudrate, std::uint8_t *uid, std::uint8_t *uidLength,
+                             std::uint16_t timeout = 0);
+};
+
+#endif // ISIC_NATIVE_ADAFRUIT_PN532_H
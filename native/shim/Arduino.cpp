@@ -0,0 +1,319 @@
+#include "Arduino.h"
+#include "NativeHost.hpp"
+#include "esp_sleep.h"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+HardwareSerial Serial;
+EspClass ESP;
+
+namespace
+{
+// ============================================================================
+// Clock
+// ============================================================================
+
+struct Clock
+{
+    isic::native::ClockMode mode{isic::native::ClockMode::RealTime};
+    std::chrono::steady_clock::time_point epoch{std::chrono::steady_clock::now()};
+    std::uint64_t virtualUs{0};
+};
+
+Clock &hostClock()
+{
+    static Clock instance;
+    return instance;
+}
+
+std::uint64_t realUs()
+{
+    const auto elapsed{std::chrono::steady_clock::now() - hostClock().epoch};
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+struct Pin
+{
+    std::uint8_t mode{INPUT};
+    int level{LOW};
+    std::function<int()> source{};
+};
+
+std::array<Pin, 64> &pins()
+{
+    static std::array<Pin, 64> instance;
+    return instance;
+}
+
+std::mt19937 &randomEngine()
+{
+    static std::mt19937 engine{std::random_device{}()};
+    return engine;
+}
+
+#if defined(__GLIBC__)
+std::size_t allocatedBytes()
+{
+#if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33)
+    return mallinfo2().uordblks;
+#else
+    return static_cast<std::size_t>(mallinfo().uordblks);
+#endif
+}
+
+// Taken before main(): only what the firmware allocates counts against its heap
+const std::size_t kAllocatedAtStart{allocatedBytes()};
+#endif
+} // namespace
+
+// ============================================================================
+// NativeHost.hpp
+// ============================================================================
+
+namespace isic::native
+{
+void setClockMode(const ClockMode mode)
+{
+    if (mode == hostClock().mode)
+    {
+        return;
+    }
+    if (mode == ClockMode::Virtual)
+    {
+        hostClock().virtualUs = realUs();
+    }
+    else
+    {
+        hostClock().epoch = std::chrono::steady_clock::now() - std::chrono::microseconds(hostClock().virtualUs);
+    }
+    hostClock().mode = mode;
+}
+
+ClockMode getClockMode()
+{
+    return hostClock().mode;
+}
+
+std::uint64_t nowUs()
+{
+    return hostClock().mode == ClockMode::Virtual ? hostClock().virtualUs : realUs();
+}
+
+void advanceClockUs(const std::uint64_t us)
+{
+    if (hostClock().mode == ClockMode::Virtual)
+    {
+        hostClock().virtualUs += us;
+    }
+}
+
+int pinLevel(const std::uint8_t pin)
+{
+    return pin < pins().size() ? digitalRead(pin) : LOW;
+}
+
+void setPinSource(const std::uint8_t pin, std::function<int()> source)
+{
+    if (pin < pins().size())
+    {
+        pins()[pin].source = std::move(source);
+    }
+}
+} // namespace isic::native
+
+// ============================================================================
+// Time
+// ============================================================================
+
+unsigned long millis()
+{
+    return static_cast<unsigned long>(static_cast<std::uint32_t>(isic::native::nowUs() / 1000ULL));
+}
+
+unsigned long micros()
+{
+    return static_cast<unsigned long>(static_cast<std::uint32_t>(isic::native::nowUs()));
+}
+
+void delay(const std::uint32_t ms)
+{
+    if (isic::native::getClockMode() == isic::native::ClockMode::Virtual)
+    {
+        isic::native::advanceClockMs(ms);
+    }
+    else
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+}
+
+void delayMicroseconds(const std::uint32_t us)
+{
+    if (isic::native::getClockMode() == isic::native::ClockMode::Virtual)
+    {
+        isic::native::advanceClockUs(us);
+    }
+    else
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+}
+
+void yield()
+{
+    std::this_thread::yield();
+}
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+void pinMode(const std::uint8_t pin, const std::uint8_t mode)
+{
+    if (pin < pins().size())
+    {
+        pins()[pin].mode = mode;
+        if (mode == INPUT_PULLUP)
+        {
+            pins()[pin].level = HIGH;
+        }
+    }
+}
+
+void digitalWrite(const std::uint8_t pin, const std::uint8_t level)
+{
+    if (pin < pins().size())
+    {
+        pins()[pin].level = level ? HIGH : LOW;
+    }
+}
+
+int digitalRead(const std::uint8_t pin)
+{
+    if (pin >= pins().size())
+    {
+        return LOW;
+    }
+    const auto &state{pins()[pin]};
+    return state.source ? state.source() : state.level;
+}
+
+// Pins are polled on the host; the firmware's IRQ handlers never fire
+void attachInterrupt(const std::uint8_t, void (*)(), const int)
+{
+}
+
+void detachInterrupt(const std::uint8_t)
+{
+}
+
+void tone(const std::uint8_t pin, const unsigned int frequency, const unsigned long durationMs)
+{
+    (void) durationMs;
+    digitalWrite(pin, frequency != 0 ? HIGH : LOW);
+}
+
+void noTone(const std::uint8_t pin)
+{
+    digitalWrite(pin, LOW);
+}
+
+// ============================================================================
+// Math
+// ============================================================================
+
+long random(const long max)
+{
+    return random(0, max);
+}
+
+long random(const long min, const long max)
+{
+    if (max <= min)
+    {
+        return min;
+    }
+    return std::uniform_int_distribution<long>{min, max - 1}(randomEngine());
+}
+
+void randomSeed(const unsigned long seed)
+{
+    randomEngine().seed(static_cast<std::mt19937::result_type>(seed));
+}
+
+// ============================================================================
+// Serial
+// ============================================================================
+
+std::size_t HardwareSerial::write(const std::uint8_t c)
+{
+    return std::fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+std::size_t HardwareSerial::write(const std::uint8_t *buffer, const std::size_t size)
+{
+    return std::fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush()
+{
+    std::fflush(stdout);
+}
+
+// ============================================================================
+// ESP
+// ============================================================================
+
+std::uint32_t EspClass::getHeapSize()
+{
+    return kHeapSize;
+}
+
+std::uint32_t EspClass::getFreeHeap()
+{
+#if defined(__GLIBC__)
+    const auto allocated{allocatedBytes()};
+    const auto used{allocated > kAllocatedAtStart ? allocated - kAllocatedAtStart : 0};
+    return used < kHeapSize ? static_cast<std::uint32_t>(kHeapSize - used) : 0;
+#else
+    return kHeapSize;
+#endif
+}
+
+std::uint32_t EspClass::getMinFreeHeap()
+{
+    static auto lowest{getFreeHeap()};
+    lowest = std::min(lowest, getFreeHeap());
+    return lowest;
+}
+
+std::uint32_t EspClass::getMaxAllocHeap()
+{
+    return getFreeHeap();
+}
+
+void EspClass::restart()
+{
+    std::fflush(stdout);
+    std::fprintf(stderr, "[native] ESP.restart()\n");
+    std::exit(isic::native::kRestartExitCode);
+}
+
+void esp_deep_sleep_start()
+{
+    std::fflush(stdout);
+    std::fprintf(stderr, "[native] esp_deep_sleep_start()\n");
+    std::exit(isic::native::kDeepSleepExitCode);
+}
@@ -0,0 +1,121 @@
+#ifndef ISIC_NATIVE_ARDUINO_H
+#define ISIC_NATIVE_ARDUINO_H
+
+/**
+ * @file Arduino.h
+ * @brief ESP32 Arduino core, as far as the firmware uses it, for a Linux host
+ *
+ * Time comes from the clock selected in NativeHost.hpp, GPIOs are an array
+ * of levels, Serial is stdout. The FreeRTOS calls PlatformAtomic.hpp makes
+ * are mapped onto a single-threaded host: never in an ISR, one task.
+ */
+
+#include "Esp.h"
+#include "HardwareSerial.h"
+#include "IPAddress.h"
+#include "Print.h"
+#include "Stream.h"
+#include "WString.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+
+#define IRAM_ATTR
+#define PROGMEM
+#define F(text) (text)
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define INPUT_PULLDOWN 0x09
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define digitalPinToInterrupt(pin) (pin)
+
+using byte = std::uint8_t;
+using boolean = bool;
+
+// ============================================================================
+// Time
+// ============================================================================
+
+unsigned long millis();
+unsigned long micros();
+void delay(std::uint32_t ms);
+void delayMicroseconds(std::uint32_t us);
+void yield();
+
+/// No SNTP on the host: time(nullptr) already is the workstation's clock
+inline void configTime(long, int, const char *, const char * = nullptr, const char * = nullptr)
+{
+}
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+void pinMode(std::uint8_t pin, std::uint8_t mode);
+void digitalWrite(std::uint8_t pin, std::uint8_t level);
+int digitalRead(std::uint8_t pin);
+void attachInterrupt(std::uint8_t pin, void (*handler)(), int mode);
+void detachInterrupt(std::uint8_t pin);
+void tone(std::uint8_t pin, unsigned int frequency, unsigned long durationMs = 0);
+void noTone(std::uint8_t pin);
+
+inline void interrupts()
+{
+}
+inline void noInterrupts()
+{
+}
+
+// ============================================================================
+// Math
+// ============================================================================
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+// ============================================================================
+// FreeRTOS (single task, never in an ISR)
+// ============================================================================
+
+using TaskHandle_t = void *;
+
+inline bool xPortInIsrContext()
+{
+    return false;
+}
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    static thread_local char task;
+    return &task;
+}
+
+struct portMUX_TYPE
+{
+    std::recursive_mutex mutex;
+};
+
+#define portMUX_INITIALIZER_UNLOCKED \
+    {                                \
+    }
+#define portENTER_CRITICAL_SAFE(mux) ((mux)->mutex.lock())
+#define portEXIT_CRITICAL_SAFE(mux) ((mux)->mutex.unlock())
+#define portENTER_CRITICAL(mux) portENTER_CRITICAL_SAFE(mux)
+#define portEXIT_CRITICAL(mux) portEXIT_CRITICAL_SAFE(mux)
+
+#endif // ISIC_NATIVE_ARDUINO_H
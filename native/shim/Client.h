@@ -0,0 +1,31 @@
+#ifndef ISIC_NATIVE_CLIENT_H
+#define ISIC_NATIVE_CLIENT_H
+
+#include "IPAddress.h"
+#include "Stream.h"
+
+/// Arduino network client interface (what PubSubClient talks to)
+class Client : public Stream
+{
+public:
+    virtual int connect(IPAddress ip, std::uint16_t port) = 0;
+    virtual int connect(const char *host, std::uint16_t port) = 0;
+    std::size_t write(std::uint8_t c) override = 0;
+    std::size_t write(const std::uint8_t *buffer, std::size_t size) override = 0;
+    int available() override = 0;
+    int read() override = 0;
+    virtual int read(std::uint8_t *buffer, std::size_t size) = 0;
+    int peek() override = 0;
+    void flush() override = 0;
+    virtual void stop() = 0;
+    virtual std::uint8_t connected() = 0;
+    virtual operator bool() = 0;
+
+protected:
+    std::uint8_t *rawIPAddress(IPAddress &address)
+    {
+        return address.raw_address();
+    }
+};
+
+#endif // ISIC_NATIVE_CLIENT_H
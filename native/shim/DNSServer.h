@@ -0,0 +1,48 @@
+#ifndef ISIC_NATIVE_DNSSERVER_H
+#define ISIC_NATIVE_DNSSERVER_H
+
+#include "IPAddress.h"
+#include "WString.h"
+
+#include <cstdint>
+
+enum class DNSReplyCode : std::uint8_t
+{
+    NoError = 0,
+    FormError = 1,
+    ServerFailure = 2,
+    NonExistentDomain = 3,
+    NotImplemented = 4,
+    Refused = 5,
+};
+
+/// Captive-portal DNS: nothing to answer on the host, the calls only keep state
+class DNSServer
+{
+public:
+    bool start(const std::uint16_t port, const String &domainName, const IPAddress &resolvedIp)
+    {
+        (void) port;
+        (void) domainName;
+        (void) resolvedIp;
+        m_running = true;
+        return true;
+    }
+    void stop()
+    {
+        m_running = false;
+    }
+    void processNextRequest()
+    {
+    }
+    void setErrorReplyCode(const DNSReplyCode &replyCode)
+    {
+        m_replyCode = replyCode;
+    }
+
+private:
+    bool m_running{false};
+    DNSReplyCode m_replyCode{DNSReplyCode::NonExistentDomain};
+};
+
+#endif // ISIC_NATIVE_DNSSERVER_H
@@ -0,0 +1,147 @@
+#ifndef ISIC_NATIVE_ESPASYNCWEBSERVER_H
+#define ISIC_NATIVE_ESPASYNCWEBSERVER_H
+
+#include "WString.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+
+typedef enum
+{
+    HTTP_GET = 0b00000001,
+    HTTP_POST = 0b00000010,
+    HTTP_DELETE = 0b00000100,
+    HTTP_PUT = 0b00001000,
+    HTTP_PATCH = 0b00010000,
+    HTTP_HEAD = 0b00100000,
+    HTTP_OPTIONS = 0b01000000,
+    HTTP_ANY = 0b01111111,
+} WebRequestMethod;
+
+using WebRequestMethodComposite = std::uint8_t;
+
+class AsyncWebParameter
+{
+public:
+    AsyncWebParameter(String name, String value)
+        : m_name(std::move(name))
+        , m_value(std::move(value))
+    {
+    }
+    const String &name() const
+    {
+        return m_name;
+    }
+    const String &value() const
+    {
+        return m_value;
+    }
+
+private:
+    String m_name;
+    String m_value;
+};
+
+/**
+ * A request handed to a route handler. The host has no HTTP listener, so
+ * requests only exist when a host program builds one and passes it to
+ * AsyncWebServer::handle(); the response is kept for it to inspect.
+ */
+class AsyncWebServerRequest
+{
+public:
+    void addParam(const String &name, const String &value)
+    {
+        m_params.emplace(name.c_str(), AsyncWebParameter{name, value});
+    }
+
+    bool hasParam(const String &name, bool post = false, bool file = false) const
+    {
+        (void) post;
+        (void) file;
+        return m_params.count(name.c_str()) != 0;
+    }
+    const AsyncWebParameter *getParam(const String &name, bool post = false, bool file = false) const
+    {
+        (void) post;
+        (void) file;
+        const auto it{m_params.find(name.c_str())};
+        return it != m_params.end() ? &it->second : nullptr;
+    }
+
+    void send(const int code, const String &contentType = String(), const String &content = String())
+    {
+        m_responseCode = code;
+        m_responseType = contentType;
+        m_responseBody = content;
+    }
+    void redirect(const String &url)
+    {
+        send(302, "text/plain", url);
+    }
+
+    int responseCode() const
+    {
+        return m_responseCode;
+    }
+    const String &responseBody() const
+    {
+        return m_responseBody;
+    }
+
+private:
+    std::map<std::string, AsyncWebParameter> m_params{};
+    int m_responseCode{0};
+    String m_responseType{};
+    String m_responseBody{};
+};
+
+using ArRequestHandlerFunction = std::function<void(AsyncWebServerRequest *request)>;
+
+class AsyncCallbackWebHandler
+{
+};
+
+class AsyncWebServer
+{
+public:
+    explicit AsyncWebServer(const std::uint16_t port)
+        : m_port(port)
+    {
+    }
+
+    void begin()
+    {
+    }
+    void end()
+    {
+    }
+
+    AsyncCallbackWebHandler &on(const char *uri, const WebRequestMethodComposite method, ArRequestHandlerFunction onRequest)
+    {
+        m_routes[uri] = {method, std::move(onRequest)};
+        return m_handler;
+    }
+
+    /// Host side: run the handler registered for @p uri; false if none matches
+    bool handle(const char *uri, const WebRequestMethod method, AsyncWebServerRequest &request)
+    {
+        const auto it{m_routes.find(uri)};
+        if (it == m_routes.end() || (it->second.first & method) == 0)
+        {
+            return false;
+        }
+        it->second.second(&request);
+        return true;
+    }
+
+private:
+    std::uint16_t m_port;
+    std::map<std::string, std::pair<WebRequestMethodComposite, ArRequestHandlerFunction>> m_routes{};
+    AsyncCallbackWebHandler m_handler{};
+};
+
+#endif // ISIC_NATIVE_ESPASYNCWEBSERVER_H
@@ -0,0 +1,48 @@
+#ifndef ISIC_NATIVE_ESP_H
+#define ISIC_NATIVE_ESP_H
+
+#include <cstdint>
+
+/**
+ * ESP32 EspClass on the host. Heap figures are a 320 KB device heap minus
+ * what the process has allocated since start-up (glibc mallinfo2), so the
+ * allocation costs main.cpp logs are meaningful; the rest are constants.
+ */
+class EspClass
+{
+public:
+    static constexpr std::uint32_t kHeapSize{320U * 1024U};
+
+    std::uint32_t getHeapSize();
+    std::uint32_t getFreeHeap();
+    std::uint32_t getMinFreeHeap();
+    std::uint32_t getMaxAllocHeap();
+
+    std::uint64_t getEfuseMac()
+    {
+        return 0x0000DEADBEEF0001ULL;
+    }
+    const char *getChipModel()
+    {
+        return "native";
+    }
+    std::uint32_t getFlashChipSize()
+    {
+        return 4U * 1024U * 1024U;
+    }
+    std::uint32_t getCpuFreqMHz()
+    {
+        return 240;
+    }
+    const char *getSdkVersion()
+    {
+        return "native";
+    }
+
+    /// Ends the process with isic::native::kRestartExitCode
+    [[noreturn]] void restart();
+};
+
+extern EspClass ESP;
+
+#endif // ISIC_NATIVE_ESP_H
@@ -0,0 +1,110 @@
+#ifndef ISIC_NATIVE_FS_H
+#define ISIC_NATIVE_FS_H
+
+#include "Stream.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace fs
+{
+enum SeekMode
+{
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+struct FileImpl;
+
+/// ESP32 fs::File over an in-memory file; writes are visible at once, no flush needed
+class File : public Stream
+{
+public:
+    File() = default;
+    explicit File(std::shared_ptr<FileImpl> impl)
+        : m_impl(std::move(impl))
+    {
+    }
+
+    std::size_t write(std::uint8_t c) override;
+    std::size_t write(const std::uint8_t *buffer, std::size_t size) override;
+    using Print::write;
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    void flush() override
+    {
+    }
+    std::size_t read(std::uint8_t *buffer, std::size_t size);
+
+    bool seek(std::uint32_t position, SeekMode mode = SeekSet);
+    [[nodiscard]] std::size_t position() const;
+    [[nodiscard]] std::size_t size() const;
+    void close();
+    explicit operator bool() const
+    {
+        return m_impl != nullptr;
+    }
+
+    [[nodiscard]] const char *path() const;
+    [[nodiscard]] const char *name() const;
+    [[nodiscard]] bool isDirectory() const;
+    File openNextFile(const char *mode = "r");
+    void rewindDirectory();
+
+protected:
+    bool canReceiveMore() override
+    {
+        return false;
+    }
+
+private:
+    std::shared_ptr<FileImpl> m_impl{};
+};
+
+class FS
+{
+public:
+    virtual ~FS() = default;
+
+    File open(const char *path, const char *mode = "r", bool create = false);
+    File open(const String &path, const char *mode = "r", bool create = false)
+    {
+        return open(path.c_str(), mode, create);
+    }
+    bool exists(const char *path);
+    bool exists(const String &path)
+    {
+        return exists(path.c_str());
+    }
+    bool remove(const char *path);
+    bool remove(const String &path)
+    {
+        return remove(path.c_str());
+    }
+    bool rename(const char *from, const char *to);
+    bool rename(const String &from, const String &to)
+    {
+        return rename(from.c_str(), to.c_str());
+    }
+    bool mkdir(const char *path);
+    bool mkdir(const String &path)
+    {
+        return mkdir(path.c_str());
+    }
+    bool rmdir(const char *path);
+    bool rmdir(const String &path)
+    {
+        return rmdir(path.c_str());
+    }
+};
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekMode;
+
+#endif // ISIC_NATIVE_FS_H
@@ -0,0 +1,57 @@
+#ifndef ISIC_NATIVE_HTTPCLIENT_H
+#define ISIC_NATIVE_HTTPCLIENT_H
+
+#include "WString.h"
+#include "WiFiClient.h"
+
+#include <cstdint>
+
+#define HTTP_CODE_OK 200
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+
+/// OTA downloads are not emulated: every request fails as if the server were down
+class HTTPClient
+{
+public:
+    bool begin(WiFiClient &client, const char *url)
+    {
+        (void) client;
+        (void) url;
+        return true;
+    }
+    void end()
+    {
+    }
+    void setTimeout(const std::uint16_t timeoutMs)
+    {
+        (void) timeoutMs;
+    }
+    void setAuthorization(const char *user, const char *password)
+    {
+        (void) user;
+        (void) password;
+    }
+
+    int GET()
+    {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    int getSize()
+    {
+        return -1;
+    }
+    String getString()
+    {
+        return {};
+    }
+    WiFiClient *getStreamPtr()
+    {
+        return nullptr;
+    }
+    bool connected()
+    {
+        return false;
+    }
+};
+
+#endif // ISIC_NATIVE_HTTPCLIENT_H
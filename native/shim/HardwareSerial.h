@@ -0,0 +1,70 @@
+#ifndef ISIC_NATIVE_HARDWARESERIAL_H
+#define ISIC_NATIVE_HARDWARESERIAL_H
+
+#include "Stream.h"
+
+#include <deque>
+#include <string_view>
+
+/**
+ * Serial on the host: output goes to stdout, input is whatever the host
+ * main hands to feed() (it owns stdin and filters out its SIM: commands).
+ */
+class HardwareSerial : public Stream
+{
+public:
+    void begin(const unsigned long baud)
+    {
+        (void) baud;
+    }
+    void end()
+    {
+    }
+    explicit operator bool() const
+    {
+        return true;
+    }
+
+    std::size_t write(std::uint8_t c) override;
+    std::size_t write(const std::uint8_t *buffer, std::size_t size) override;
+    using Print::write;
+    void flush() override;
+
+    int available() override
+    {
+        return static_cast<int>(m_rx.size());
+    }
+    int read() override
+    {
+        if (m_rx.empty())
+        {
+            return -1;
+        }
+        const auto c{m_rx.front()};
+        m_rx.pop_front();
+        return c;
+    }
+    int peek() override
+    {
+        return m_rx.empty() ? -1 : m_rx.front();
+    }
+
+    /// Host side: queue received bytes
+    void feed(const std::string_view data)
+    {
+        m_rx.insert(m_rx.end(), data.begin(), data.end());
+    }
+
+protected:
+    bool canReceiveMore() override
+    {
+        return false;
+    }
+
+private:
+    std::deque<std::uint8_t> m_rx{};
+};
+
+extern HardwareSerial Serial;
+
+#endif // ISIC_NATIVE_HARDWARESERIAL_H
@@ -0,0 +1,73 @@
+#ifndef ISIC_NATIVE_IPADDRESS_H
+#define ISIC_NATIVE_IPADDRESS_H
+
+#include "WString.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+class IPAddress
+{
+public:
+    IPAddress() = default;
+    IPAddress(const std::uint8_t a, const std::uint8_t b, const std::uint8_t c, const std::uint8_t d)
+        : m_octets{a, b, c, d}
+    {
+    }
+    IPAddress(const std::uint32_t address)
+    {
+        std::memcpy(m_octets, &address, sizeof(m_octets));
+    }
+    IPAddress(const std::uint8_t *address)
+    {
+        std::memcpy(m_octets, address, sizeof(m_octets));
+    }
+
+    operator std::uint32_t() const
+    {
+        std::uint32_t address;
+        std::memcpy(&address, m_octets, sizeof(address));
+        return address;
+    }
+    std::uint8_t operator[](const int index) const
+    {
+        return m_octets[index];
+    }
+    std::uint8_t &operator[](const int index)
+    {
+        return m_octets[index];
+    }
+    bool operator==(const IPAddress &other) const
+    {
+        return std::memcmp(m_octets, other.m_octets, sizeof(m_octets)) == 0;
+    }
+
+    bool fromString(const char *text)
+    {
+        unsigned int a, b, c, d;
+        char tail;
+        if (std::sscanf(text, "%u.%u.%u.%u%c", &a, &b, &c, &d, &tail) != 4 || a > 255 || b > 255 || c > 255 || d > 255)
+        {
+            return false;
+        }
+        *this = IPAddress(a, b, c, d);
+        return true;
+    }
+    [[nodiscard]] String toString() const
+    {
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), "%u.%u.%u.%u", m_octets[0], m_octets[1], m_octets[2], m_octets[3]);
+        return buf;
+    }
+
+    std::uint8_t *raw_address()
+    {
+        return m_octets;
+    }
+
+private:
+    std::uint8_t m_octets[4]{};
+};
+
+#endif // ISIC_NATIVE_IPADDRESS_H
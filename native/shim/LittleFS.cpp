@@ -0,0 +1,448 @@
+#include "LittleFS.h"
+#include "NativeHost.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+fs::LittleFSFS LittleFS;
+
+namespace
+{
+using Data = std::vector<std::uint8_t>;
+
+constexpr std::size_t kBlockSize{4096};
+constexpr std::size_t kMetadataBlocks{2}; // Superblock pair
+
+struct Storage
+{
+    std::map<std::string, std::shared_ptr<Data>> files{};
+    std::set<std::string> directories{};
+    std::size_t capacity{0x160000};
+    bool mounted{false};
+};
+
+// Never destroyed: exportFilesystem() may run from an atexit() handler
+Storage &storage()
+{
+    static auto *instance{new Storage()};
+    return *instance;
+}
+
+std::string normalize(const char *path)
+{
+    std::string result{path ? path : ""};
+    if (result.empty() || result.front() != '/')
+    {
+        result.insert(result.begin(), '/');
+    }
+    while (result.size() > 1 && result.back() == '/')
+    {
+        result.pop_back();
+    }
+    return result;
+}
+
+std::size_t blocksFor(const std::size_t size)
+{
+    return std::max<std::size_t>(1, (size + kBlockSize - 1) / kBlockSize);
+}
+
+std::size_t usedBlocks()
+{
+    auto blocks{kMetadataBlocks + storage().directories.size()};
+    for (const auto &[path, data]: storage().files)
+    {
+        blocks += blocksFor(data->size());
+    }
+    return blocks;
+}
+
+/// Can @p data grow to @p newSize without overflowing the partition?
+bool fits(const Data &data, const std::size_t newSize)
+{
+    const auto blocks{usedBlocks() - blocksFor(data.size()) + blocksFor(newSize)};
+    return blocks * kBlockSize <= storage().capacity;
+}
+
+bool isDirectory(const std::string &path)
+{
+    if (path == "/" || storage().directories.count(path) != 0)
+    {
+        return true;
+    }
+    const auto prefix{path + "/"};
+    const auto it{storage().files.lower_bound(prefix)};
+    return it != storage().files.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+}
+
+/// Direct children of @p dir, files and subdirectories, sorted
+std::vector<std::string> listDirectory(const std::string &dir)
+{
+    const auto prefix{dir == "/" ? dir : dir + "/"};
+    std::set<std::string> children;
+    const auto collect{[&](const std::string &path) {
+        if (path.size() <= prefix.size() || path.compare(0, prefix.size(), prefix) != 0)
+        {
+            return;
+        }
+        const auto slash{path.find('/', prefix.size())};
+        children.insert(slash == std::string::npos ? path : path.substr(0, slash));
+    }};
+    for (const auto &[path, data]: storage().files)
+    {
+        collect(path);
+    }
+    for (const auto &path: storage().directories)
+    {
+        collect(path);
+    }
+    return {children.begin(), children.end()};
+}
+} // namespace
+
+namespace fs
+{
+struct FileImpl
+{
+    std::string path{};
+    std::shared_ptr<Data> data{}; // null for a directory
+    std::size_t position{0};
+    bool writable{false};
+    bool append{false};
+    std::vector<std::string> entries{}; // directory listing, taken at open
+    std::size_t nextEntry{0};
+};
+
+// ============================================================================
+// File
+// ============================================================================
+
+std::size_t File::write(const std::uint8_t c)
+{
+    return write(&c, 1);
+}
+
+std::size_t File::write(const std::uint8_t *buffer, const std::size_t size)
+{
+    if (!m_impl || !m_impl->data || !m_impl->writable)
+    {
+        return 0;
+    }
+
+    auto &data{*m_impl->data};
+    if (m_impl->append)
+    {
+        m_impl->position = data.size();
+    }
+    auto end{m_impl->position + size};
+    if (end > data.size() && !fits(data, end))
+    {
+        // A full flash takes what fits in the blocks left and reports a short write
+        const auto otherBlocks{usedBlocks() - blocksFor(data.size())};
+        const auto totalBlocks{storage().capacity / kBlockSize};
+        const auto limit{totalBlocks > otherBlocks ? (totalBlocks - otherBlocks) * kBlockSize : 0};
+        end = std::max(data.size(), std::min(end, limit));
+        if (end <= m_impl->position)
+        {
+            return 0;
+        }
+    }
+    if (end > data.size())
+    {
+        data.resize(end);
+    }
+    const auto count{end - m_impl->position};
+    std::copy_n(buffer, count, data.begin() + static_cast<std::ptrdiff_t>(m_impl->position));
+    m_impl->position = end;
+    return count;
+}
+
+int File::available()
+{
+    if (!m_impl || !m_impl->data)
+    {
+        return 0;
+    }
+    const auto size{m_impl->data->size()};
+    return m_impl->position < size ? static_cast<int>(size - m_impl->position) : 0;
+}
+
+int File::read()
+{
+    std::uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek()
+{
+    return available() > 0 ? (*m_impl->data)[m_impl->position] : -1;
+}
+
+std::size_t File::read(std::uint8_t *buffer, const std::size_t size)
+{
+    const auto count{std::min<std::size_t>(size, static_cast<std::size_t>(available()))};
+    if (count != 0)
+    {
+        std::copy_n(m_impl->data->begin() + static_cast<std::ptrdiff_t>(m_impl->position), count, buffer);
+        m_impl->position += count;
+    }
+    return count;
+}
+
+bool File::seek(const std::uint32_t position, const SeekMode mode)
+{
+    if (!m_impl || !m_impl->data)
+    {
+        return false;
+    }
+    const auto size{m_impl->data->size()};
+    const auto base{mode == SeekSet ? 0 : mode == SeekCur ? m_impl->position : size};
+    if (base + position > size)
+    {
+        return false;
+    }
+    m_impl->position = base + position;
+    return true;
+}
+
+std::size_t File::position() const
+{
+    return m_impl ? m_impl->position : 0;
+}
+
+std::size_t File::size() const
+{
+    return m_impl && m_impl->data ? m_impl->data->size() : 0;
+}
+
+void File::close()
+{
+    m_impl.reset();
+}
+
+const char *File::path() const
+{
+    return m_impl ? m_impl->path.c_str() : nullptr;
+}
+
+const char *File::name() const
+{
+    return m_impl ? m_impl->path.c_str() + m_impl->path.rfind('/') + 1 : nullptr;
+}
+
+bool File::isDirectory() const
+{
+    return m_impl && !m_impl->data;
+}
+
+File File::openNextFile(const char *mode)
+{
+    if (!isDirectory() || m_impl->nextEntry >= m_impl->entries.size())
+    {
+        return File();
+    }
+    return LittleFS.open(m_impl->entries[m_impl->nextEntry++].c_str(), mode);
+}
+
+void File::rewindDirectory()
+{
+    if (isDirectory())
+    {
+        m_impl->nextEntry = 0;
+    }
+}
+
+// ============================================================================
+// FS
+// ============================================================================
+
+File FS::open(const char *path, const char *mode, const bool create)
+{
+    (void) create;
+    if (!storage().mounted || !mode)
+    {
+        return File();
+    }
+
+    const auto key{normalize(path)};
+    const auto read{mode[0] == 'r'};
+    const auto plus{std::strchr(mode, '+') != nullptr};
+    auto impl{std::make_shared<FileImpl>()};
+    impl->path = key;
+
+    if (read && isDirectory(key))
+    {
+        impl->entries = listDirectory(key);
+        return File(std::move(impl));
+    }
+
+    auto &files{storage().files};
+    auto it{files.find(key)};
+    if (read)
+    {
+        if (it == files.end())
+        {
+            return File();
+        }
+        impl->writable = plus;
+    }
+    else
+    {
+        if (isDirectory(key))
+        {
+            return File();
+        }
+        if (it == files.end())
+        {
+            if ((usedBlocks() + 1) * kBlockSize > storage().capacity)
+            {
+                return File();
+            }
+            it = files.emplace(key, std::make_shared<Data>()).first;
+        }
+        else if (mode[0] == 'w')
+        {
+            it->second->clear();
+        }
+        impl->writable = true;
+        impl->append = mode[0] == 'a';
+    }
+
+    impl->data = it->second;
+    return File(std::move(impl));
+}
+
+bool FS::exists(const char *path)
+{
+    const auto key{normalize(path)};
+    return storage().mounted && (storage().files.count(key) != 0 || isDirectory(key));
+}
+
+bool FS::remove(const char *path)
+{
+    return storage().mounted && storage().files.erase(normalize(path)) != 0;
+}
+
+bool FS::rename(const char *from, const char *to)
+{
+    auto &files{storage().files};
+    const auto it{files.find(normalize(from))};
+    if (!storage().mounted || it == files.end())
+    {
+        return false;
+    }
+    auto data{it->second};
+    files.erase(it);
+    files[normalize(to)] = std::move(data);
+    return true;
+}
+
+bool FS::mkdir(const char *path)
+{
+    const auto key{normalize(path)};
+    if (!storage().mounted || storage().files.count(key) != 0)
+    {
+        return false;
+    }
+    storage().directories.insert(key);
+    return true;
+}
+
+bool FS::rmdir(const char *path)
+{
+    const auto key{normalize(path)};
+    if (!storage().mounted || !listDirectory(key).empty())
+    {
+        return false;
+    }
+    return storage().directories.erase(key) != 0;
+}
+
+// ============================================================================
+// LittleFSFS
+// ============================================================================
+
+bool LittleFSFS::begin(const bool formatOnFail, const char *basePath, const std::uint8_t maxOpenFiles,
+                       const char *partitionLabel)
+{
+    (void) formatOnFail;
+    (void) basePath;
+    (void) maxOpenFiles;
+    (void) partitionLabel;
+    storage().mounted = true;
+    return true;
+}
+
+void LittleFSFS::end()
+{
+    storage().mounted = false;
+}
+
+bool LittleFSFS::format()
+{
+    storage().files.clear();
+    storage().directories.clear();
+    return true;
+}
+
+std::size_t LittleFSFS::totalBytes()
+{
+    return storage().capacity;
+}
+
+std::size_t LittleFSFS::usedBytes()
+{
+    return usedBlocks() * kBlockSize;
+}
+} // namespace fs
+
+namespace isic::native
+{
+std::size_t importFilesystem(const std::string &hostDir)
+{
+    namespace stdfs = std::filesystem;
+
+    std::error_code error;
+    std::size_t count{0};
+    for (stdfs::recursive_directory_iterator it{hostDir, error}, end; !error && it != end; it.increment(error))
+    {
+        if (!it->is_regular_file())
+        {
+            continue;
+        }
+        std::ifstream in{it->path(), std::ios::binary};
+        auto data{std::make_shared<Data>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>())};
+        storage().files[normalize(stdfs::relative(it->path(), hostDir).generic_string().c_str())] = std::move(data);
+        ++count;
+    }
+    return count;
+}
+
+std::size_t exportFilesystem(const std::string &hostDir)
+{
+    namespace stdfs = std::filesystem;
+
+    std::size_t count{0};
+    for (const auto &[path, data]: storage().files)
+    {
+        const auto target{stdfs::path(hostDir) / path.substr(1)};
+        std::error_code error;
+        stdfs::create_directories(target.parent_path(), error);
+        std::ofstream out{target, std::ios::binary | std::ios::trunc};
+        out.write(reinterpret_cast<const char *>(data->data()), static_cast<std::streamsize>(data->size()));
+        count += out.good() ? 1 : 0;
+    }
+    return count;
+}
+
+void setFilesystemCapacity(const std::size_t bytes)
+{
+    storage().capacity = bytes;
+}
+} // namespace isic::native
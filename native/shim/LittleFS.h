@@ -0,0 +1,29 @@
+#ifndef ISIC_NATIVE_LITTLEFS_H
+#define ISIC_NATIVE_LITTLEFS_H
+
+#include "FS.h"
+
+namespace fs
+{
+/**
+ * LittleFS kept in RAM. Starts empty and unformatted-but-mountable; seed and
+ * save it with isic::native::importFilesystem()/exportFilesystem(). Space is
+ * accounted in 4 KB blocks against setFilesystemCapacity() (default: the
+ * ESP32 default partition, 1.375 MB), so a full flash is reproducible:
+ * a write that does not fit fills the free blocks and returns short.
+ */
+class LittleFSFS : public FS
+{
+public:
+    bool begin(bool formatOnFail = false, const char *basePath = "/littlefs", std::uint8_t maxOpenFiles = 10,
+               const char *partitionLabel = "spiffs");
+    void end();
+    bool format();
+    std::size_t totalBytes();
+    std::size_t usedBytes();
+};
+} // namespace fs
+
+extern fs::LittleFSFS LittleFS;
+
+#endif // ISIC_NATIVE_LITTLEFS_H
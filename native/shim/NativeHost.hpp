@@ -0,0 +1,121 @@
+#ifndef ISIC_NATIVE_HOST_HPP
+#define ISIC_NATIVE_HOST_HPP
+
+/**
+ * @file NativeHost.hpp
+ * @brief Controls of the native (Linux) build that have no device equivalent
+ *
+ * The shim headers next to this file stand in for the ESP32 Arduino core so
+ * the firmware compiles unmodified on a workstation. This header is the
+ * other side of that shim: the knobs a host main, a benchmark or a replay
+ * driver turns to play the role of the hardware - the clock, the radio,
+ * the NFC field and the flash contents.
+ *
+ * Nothing under include/ or src/ includes it.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace isic::native
+{
+// ============================================================================
+// Clock
+// ============================================================================
+
+enum class ClockMode : std::uint8_t
+{
+    RealTime, ///< millis()/micros() follow the host's monotonic clock
+    Virtual,  ///< Time only moves through advanceClockUs() and delay()
+};
+
+/**
+ * @brief Select the clock behind millis()/micros()/delay()
+ *
+ * Virtual time starts at the current reading, so switching never makes
+ * millis() jump backwards. In Virtual mode delay() returns immediately
+ * after advancing the clock, and blocking waits in the shim (a socket with
+ * nothing to read, a PN532 read timeout) charge the time they would have
+ * taken on the device.
+ */
+void setClockMode(ClockMode mode);
+ClockMode getClockMode();
+
+std::uint64_t nowUs();
+
+/// Move virtual time forward; ignored in RealTime mode
+void advanceClockUs(std::uint64_t us);
+
+inline void advanceClockMs(const std::uint32_t ms)
+{
+    advanceClockUs(static_cast<std::uint64_t>(ms) * 1000ULL);
+}
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+/// Level an output pin was last driven to (digitalWrite), or the input level
+int pinLevel(std::uint8_t pin);
+
+/// Drive an input pin from the host side; replaces any previous source
+void setPinSource(std::uint8_t pin, std::function<int()> source);
+
+// ============================================================================
+// WiFi
+// ============================================================================
+
+/**
+ * @brief Bring the simulated access point in or out of range
+ *
+ * While down, WiFi.begin() never completes and every open WiFiClient reads
+ * as disconnected - the MQTT session drops the way it does when the device
+ * loses its AP. Up by default.
+ */
+void setWiFiLinkUp(bool up);
+bool isWiFiLinkUp();
+
+// ============================================================================
+// PN532
+// ============================================================================
+
+/// Queue a card for the simulated reader; taps are read in order
+void presentCard(const std::uint8_t *uid, std::size_t length);
+
+/// Cards queued but not read yet
+std::size_t pendingCards();
+
+/**
+ * @brief GPIO the simulated reader pulls LOW when a card is ready
+ *
+ * Must match Pn532Config::irqPin (the ESP32 default, 27, unless changed).
+ */
+void setNfcIrqPin(std::uint8_t pin);
+
+// ============================================================================
+// Filesystem
+// ============================================================================
+
+/// Copy every regular file below @p hostDir into the in-memory LittleFS
+std::size_t importFilesystem(const std::string &hostDir);
+
+/// Write the in-memory LittleFS out below @p hostDir
+std::size_t exportFilesystem(const std::string &hostDir);
+
+/// Capacity reported by LittleFS.totalBytes(); a write past it stops short, as on a full flash
+void setFilesystemCapacity(std::size_t bytes);
+
+// ============================================================================
+// System
+// ============================================================================
+
+/// Exit code of the process when the firmware calls ESP.restart()
+inline constexpr int kRestartExitCode{3};
+
+/// Exit code of the process when the firmware enters deep sleep
+inline constexpr int kDeepSleepExitCode{4};
+} // namespace isic::native
+
+#endif // ISIC_NATIVE_HOST_HPP
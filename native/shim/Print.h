@@ -0,0 +1,112 @@
+#ifndef ISIC_NATIVE_PRINT_H
+#define ISIC_NATIVE_PRINT_H
+
+#include "WString.h"
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print
+{
+public:
+    virtual ~Print() = default;
+
+    virtual std::size_t write(std::uint8_t c) = 0;
+    virtual std::size_t write(const std::uint8_t *buffer, std::size_t size)
+    {
+        std::size_t written{0};
+        while (size-- != 0 && write(*buffer++) == 1)
+        {
+            ++written;
+        }
+        return written;
+    }
+    std::size_t write(const char *text)
+    {
+        return text ? write(reinterpret_cast<const std::uint8_t *>(text), std::strlen(text)) : 0;
+    }
+    std::size_t write(const char *buffer, const std::size_t size)
+    {
+        return write(reinterpret_cast<const std::uint8_t *>(buffer), size);
+    }
+    virtual void flush()
+    {
+    }
+
+    std::size_t print(const char *text)
+    {
+        return write(text);
+    }
+    std::size_t print(const String &text)
+    {
+        return write(text.c_str(), text.length());
+    }
+    std::size_t print(const char c)
+    {
+        return write(static_cast<std::uint8_t>(c));
+    }
+    std::size_t print(const int value, const int base = DEC)
+    {
+        return print(String(value, static_cast<unsigned char>(base)));
+    }
+    std::size_t print(const unsigned int value, const int base = DEC)
+    {
+        return print(String(value, static_cast<unsigned char>(base)));
+    }
+    std::size_t print(const long value, const int base = DEC)
+    {
+        return print(String(value, static_cast<unsigned char>(base)));
+    }
+    std::size_t print(const unsigned long value, const int base = DEC)
+    {
+        return print(String(value, static_cast<unsigned char>(base)));
+    }
+    std::size_t print(const double value, const int digits = 2)
+    {
+        return print(String(value, static_cast<unsigned int>(digits)));
+    }
+
+    template<typename T>
+    std::size_t println(const T &value)
+    {
+        const auto n{print(value)};
+        return n + println();
+    }
+    std::size_t println()
+    {
+        return write("\r\n");
+    }
+
+    std::size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        char small[128];
+        va_list args;
+        va_start(args, format);
+        const auto length{std::vsnprintf(small, sizeof(small), format, args)};
+        va_end(args);
+        if (length < 0)
+        {
+            return 0;
+        }
+        if (static_cast<std::size_t>(length) < sizeof(small))
+        {
+            return write(small, static_cast<std::size_t>(length));
+        }
+
+        std::string large(static_cast<std::size_t>(length) + 1, '\0');
+        va_start(args, format);
+        std::vsnprintf(large.data(), large.size(), format, args);
+        va_end(args);
+        return write(large.data(), static_cast<std::size_t>(length));
+    }
+};
+
+#endif // ISIC_NATIVE_PRINT_H
@@ -0,0 +1,96 @@
+#ifndef ISIC_NATIVE_STREAM_H
+#define ISIC_NATIVE_STREAM_H
+
+#include "Print.h"
+
+#include <chrono>
+#include <thread>
+
+/**
+ * Arduino Stream. Read timeouts run on the host's wall clock, not millis():
+ * with a virtual clock nothing would advance time while a read waits.
+ * Sources that cannot grow while the caller waits (files, the host-fed
+ * Serial) return false from canReceiveMore() and end a read at once.
+ */
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(const unsigned long timeoutMs)
+    {
+        m_timeoutMs = timeoutMs;
+    }
+    [[nodiscard]] unsigned long getTimeout() const
+    {
+        return m_timeoutMs;
+    }
+
+    std::size_t readBytes(char *buffer, const std::size_t length)
+    {
+        std::size_t count{0};
+        while (count < length)
+        {
+            const auto c{timedRead()};
+            if (c < 0)
+            {
+                break;
+            }
+            buffer[count++] = static_cast<char>(c);
+        }
+        return count;
+    }
+    std::size_t readBytes(std::uint8_t *buffer, const std::size_t length)
+    {
+        return readBytes(reinterpret_cast<char *>(buffer), length);
+    }
+
+    String readString()
+    {
+        String text;
+        for (auto c{timedRead()}; c >= 0; c = timedRead())
+        {
+            text += static_cast<char>(c);
+        }
+        return text;
+    }
+    String readStringUntil(const char terminator)
+    {
+        String text;
+        for (auto c{timedRead()}; c >= 0 && c != terminator; c = timedRead())
+        {
+            text += static_cast<char>(c);
+        }
+        return text;
+    }
+
+protected:
+    virtual bool canReceiveMore()
+    {
+        return true;
+    }
+
+    int timedRead()
+    {
+        const auto deadline{std::chrono::steady_clock::now() + std::chrono::milliseconds(m_timeoutMs)};
+        do
+        {
+            if (available() > 0)
+            {
+                return read();
+            }
+            if (!canReceiveMore())
+            {
+                return -1;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        } while (std::chrono::steady_clock::now() < deadline);
+        return -1;
+    }
+
+    unsigned long m_timeoutMs{1000};
+};
+
+#endif // ISIC_NATIVE_STREAM_H
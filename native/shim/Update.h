@@ -0,0 +1,43 @@
+#ifndef ISIC_NATIVE_UPDATE_H
+#define ISIC_NATIVE_UPDATE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+#define UPDATE_ERROR_ABORT (12)
+
+/// No flash to update on the host; every update is refused
+class UpdateClass
+{
+public:
+    bool begin(const std::size_t size)
+    {
+        (void) size;
+        return false;
+    }
+    bool setMD5(const char *md5)
+    {
+        (void) md5;
+        return true;
+    }
+    std::size_t write(std::uint8_t *data, const std::size_t length)
+    {
+        (void) data;
+        (void) length;
+        return 0;
+    }
+    bool end(const bool evenIfRemaining = false)
+    {
+        (void) evenIfRemaining;
+        return false;
+    }
+    std::uint8_t getError() const
+    {
+        return UPDATE_ERROR_ABORT;
+    }
+};
+
+inline UpdateClass Update;
+
+#endif // ISIC_NATIVE_UPDATE_H
@@ -0,0 +1,335 @@
+#ifndef ISIC_NATIVE_WSTRING_H
+#define ISIC_NATIVE_WSTRING_H
+
+// Arduino String on top of std::string: the subset the firmware and its
+// libraries (ArduinoJson, PubSubClient) use
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+class StringSumHelper;
+
+class String
+{
+public:
+    String() = default;
+    String(const char *text)
+        : m_text(text ? text : "")
+    {
+    }
+    String(const char *text, const unsigned int length)
+        : m_text(text ? text : "", text ? length : 0)
+    {
+    }
+    explicit String(const char c)
+        : m_text(1, c)
+    {
+    }
+    explicit String(const unsigned char value, const unsigned char base = 10)
+        : String(static_cast<unsigned long>(value), base)
+    {
+    }
+    explicit String(const int value, const unsigned char base = 10)
+        : String(static_cast<long>(value), base)
+    {
+    }
+    explicit String(const unsigned int value, const unsigned char base = 10)
+        : String(static_cast<unsigned long>(value), base)
+    {
+    }
+    explicit String(const long value, const unsigned char base = 10)
+        : m_text(base == 10 ? std::to_string(value) : toBase(static_cast<unsigned long>(value), base))
+    {
+    }
+    explicit String(const unsigned long value, const unsigned char base = 10)
+        : m_text(toBase(value, base))
+    {
+    }
+    explicit String(const long long value)
+        : m_text(std::to_string(value))
+    {
+    }
+    explicit String(const unsigned long long value)
+        : m_text(std::to_string(value))
+    {
+    }
+    explicit String(const double value, const unsigned int decimalPlaces = 2)
+    {
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%.*f", static_cast<int>(decimalPlaces), value);
+        m_text = buf;
+    }
+    explicit String(const float value, const unsigned int decimalPlaces = 2)
+        : String(static_cast<double>(value), decimalPlaces)
+    {
+    }
+
+    [[nodiscard]] const char *c_str() const
+    {
+        return m_text.c_str();
+    }
+    [[nodiscard]] unsigned int length() const
+    {
+        return static_cast<unsigned int>(m_text.size());
+    }
+    [[nodiscard]] bool isEmpty() const
+    {
+        return m_text.empty();
+    }
+    bool reserve(const unsigned int size)
+    {
+        m_text.reserve(size);
+        return true;
+    }
+
+    char charAt(const unsigned int index) const
+    {
+        return index < m_text.size() ? m_text[index] : '\0';
+    }
+    char operator[](const unsigned int index) const
+    {
+        return charAt(index);
+    }
+    char &operator[](const unsigned int index)
+    {
+        return m_text[index];
+    }
+
+    bool concat(const String &other)
+    {
+        m_text += other.m_text;
+        return true;
+    }
+    bool concat(const char *text)
+    {
+        if (text)
+        {
+            m_text += text;
+        }
+        return text != nullptr;
+    }
+    bool concat(const char *text, const unsigned int length)
+    {
+        if (text)
+        {
+            m_text.append(text, length);
+        }
+        return text != nullptr;
+    }
+    bool concat(const char c)
+    {
+        m_text += c;
+        return true;
+    }
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, char>>>
+    bool concat(const T value)
+    {
+        return concat(String(value));
+    }
+
+    template<typename T>
+    String &operator+=(const T &value)
+    {
+        concat(value);
+        return *this;
+    }
+
+    [[nodiscard]] bool equals(const String &other) const
+    {
+        return m_text == other.m_text;
+    }
+    [[nodiscard]] bool equals(const char *text) const
+    {
+        return m_text == (text ? text : "");
+    }
+    [[nodiscard]] bool equalsIgnoreCase(const String &other) const
+    {
+        if (m_text.size() != other.m_text.size())
+        {
+            return false;
+        }
+        for (std::size_t i{0}; i < m_text.size(); ++i)
+        {
+            if (std::tolower(static_cast<unsigned char>(m_text[i])) != std::tolower(static_cast<unsigned char>(other.m_text[i])))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    friend bool operator==(const String &a, const String &b)
+    {
+        return a.m_text == b.m_text;
+    }
+    friend bool operator==(const String &a, const char *b)
+    {
+        return a.equals(b);
+    }
+    friend bool operator!=(const String &a, const String &b)
+    {
+        return !(a == b);
+    }
+    friend bool operator!=(const String &a, const char *b)
+    {
+        return !(a == b);
+    }
+    friend bool operator<(const String &a, const String &b)
+    {
+        return a.m_text < b.m_text;
+    }
+
+    [[nodiscard]] bool startsWith(const String &prefix) const
+    {
+        return m_text.compare(0, prefix.m_text.size(), prefix.m_text) == 0;
+    }
+    [[nodiscard]] bool endsWith(const String &suffix) const
+    {
+        return m_text.size() >= suffix.m_text.size() &&
+               m_text.compare(m_text.size() - suffix.m_text.size(), suffix.m_text.size(), suffix.m_text) == 0;
+    }
+
+    [[nodiscard]] int indexOf(const char c, const unsigned int from = 0) const
+    {
+        const auto pos{m_text.find(c, from)};
+        return pos == std::string::npos ? -1 : static_cast<int>(pos);
+    }
+    [[nodiscard]] int indexOf(const String &text, const unsigned int from = 0) const
+    {
+        const auto pos{m_text.find(text.m_text, from)};
+        return pos == std::string::npos ? -1 : static_cast<int>(pos);
+    }
+    [[nodiscard]] int lastIndexOf(const char c) const
+    {
+        const auto pos{m_text.rfind(c)};
+        return pos == std::string::npos ? -1 : static_cast<int>(pos);
+    }
+
+    [[nodiscard]] String substring(const unsigned int from) const
+    {
+        return from < m_text.size() ? String(m_text.c_str() + from) : String();
+    }
+    [[nodiscard]] String substring(unsigned int from, unsigned int to) const
+    {
+        if (from > to)
+        {
+            std::swap(from, to);
+        }
+        if (from >= m_text.size())
+        {
+            return {};
+        }
+        to = to > m_text.size() ? static_cast<unsigned int>(m_text.size()) : to;
+        return String(m_text.c_str() + from, to - from);
+    }
+
+    void trim()
+    {
+        const auto first{m_text.find_first_not_of(" \t\r\n\f\v")};
+        if (first == std::string::npos)
+        {
+            m_text.clear();
+            return;
+        }
+        const auto last{m_text.find_last_not_of(" \t\r\n\f\v")};
+        m_text = m_text.substr(first, last - first + 1);
+    }
+    void remove(const unsigned int index, const unsigned int count = static_cast<unsigned int>(-1))
+    {
+        if (index < m_text.size())
+        {
+            m_text.erase(index, count);
+        }
+    }
+    void replace(const String &from, const String &to)
+    {
+        if (from.m_text.empty())
+        {
+            return;
+        }
+        for (auto pos{m_text.find(from.m_text)}; pos != std::string::npos; pos = m_text.find(from.m_text, pos + to.m_text.size()))
+        {
+            m_text.replace(pos, from.m_text.size(), to.m_text);
+        }
+    }
+    void toLowerCase()
+    {
+        for (auto &c: m_text)
+        {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    void toUpperCase()
+    {
+        for (auto &c: m_text)
+        {
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+    }
+
+    [[nodiscard]] long toInt() const
+    {
+        return std::strtol(m_text.c_str(), nullptr, 10);
+    }
+    [[nodiscard]] float toFloat() const
+    {
+        return std::strtof(m_text.c_str(), nullptr);
+    }
+    [[nodiscard]] double toDouble() const
+    {
+        return std::strtod(m_text.c_str(), nullptr);
+    }
+
+private:
+    static std::string toBase(unsigned long value, const unsigned char base)
+    {
+        if (base < 2 || base > 36)
+        {
+            return {};
+        }
+        char buf[8 * sizeof(value) + 1];
+        auto *p{buf + sizeof(buf) - 1};
+        *p = '\0';
+        do
+        {
+            const auto digit{static_cast<char>(value % base)};
+            *--p = static_cast<char>(digit < 10 ? '0' + digit : 'A' + digit - 10);
+            value /= base;
+        } while (value != 0);
+        return p;
+    }
+
+    std::string m_text{};
+};
+
+/// Result type of operator+, as in the Arduino core (ArduinoJson adapts to it)
+class StringSumHelper : public String
+{
+public:
+    using String::String;
+    StringSumHelper(const String &text)
+        : String(text)
+    {
+    }
+};
+
+template<typename T>
+StringSumHelper operator+(const String &lhs, const T &rhs)
+{
+    StringSumHelper sum{lhs};
+    sum.concat(rhs);
+    return sum;
+}
+
+inline StringSumHelper operator+(const char *lhs, const String &rhs)
+{
+    StringSumHelper sum{lhs};
+    sum.concat(rhs);
+    return sum;
+}
+
+#endif // ISIC_NATIVE_WSTRING_H
@@ -0,0 +1,346 @@
+#include "WiFi.h"
+#include "NativeHost.hpp"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+WiFiClass WiFi;
+
+namespace
+{
+constexpr std::int32_t kConnectTimeoutMs{3000};
+
+bool g_linkUp{true};
+std::uint32_t g_linkGeneration{0}; ///< Bumped on every link loss; older sockets are dead
+} // namespace
+
+namespace isic::native
+{
+void setWiFiLinkUp(const bool up)
+{
+    if (g_linkUp && !up)
+    {
+        ++g_linkGeneration;
+    }
+    g_linkUp = up;
+}
+
+bool isWiFiLinkUp()
+{
+    return g_linkUp;
+}
+} // namespace isic::native
+
+// ============================================================================
+// WiFiClass
+// ============================================================================
+
+bool WiFiClass::mode(const wifi_mode_t mode)
+{
+    m_mode = mode;
+    if (mode == WIFI_MODE_NULL || mode == WIFI_MODE_AP)
+    {
+        m_stationStarted = false;
+    }
+    if (mode == WIFI_MODE_NULL || mode == WIFI_MODE_STA)
+    {
+        m_apStarted = false;
+    }
+    return true;
+}
+
+wl_status_t WiFiClass::begin(const char *ssid, const char *password)
+{
+    (void) password;
+    if (m_mode == WIFI_MODE_NULL || m_mode == WIFI_MODE_AP)
+    {
+        m_mode = m_mode == WIFI_MODE_AP ? WIFI_MODE_APSTA : WIFI_MODE_STA;
+    }
+    m_ssid = ssid ? ssid : "";
+    m_stationStarted = true;
+    return status();
+}
+
+wl_status_t WiFiClass::begin(const char *ssid, const wpa2_auth_method_t method, const char *identity,
+                             const char *username, const char *password)
+{
+    (void) method;
+    (void) identity;
+    (void) username;
+    return begin(ssid, password);
+}
+
+bool WiFiClass::disconnect(const bool wifiOff, const bool eraseAp)
+{
+    (void) eraseAp;
+    m_stationStarted = false;
+    if (wifiOff)
+    {
+        m_mode = WIFI_MODE_NULL;
+    }
+    return true;
+}
+
+wl_status_t WiFiClass::status()
+{
+    if (!m_stationStarted)
+    {
+        return WL_DISCONNECTED;
+    }
+    return isic::native::isWiFiLinkUp() ? WL_CONNECTED : WL_NO_SSID_AVAIL;
+}
+
+bool WiFiClass::softAPConfig(const IPAddress localIp, const IPAddress gateway, const IPAddress subnet)
+{
+    (void) gateway;
+    (void) subnet;
+    m_apIp = localIp;
+    return true;
+}
+
+bool WiFiClass::softAP(const char *ssid, const char *password)
+{
+    (void) ssid;
+    (void) password;
+    m_apStarted = true;
+    return true;
+}
+
+bool WiFiClass::softAPdisconnect(const bool wifiOff)
+{
+    m_apStarted = false;
+    if (wifiOff)
+    {
+        m_mode = WIFI_MODE_NULL;
+    }
+    return true;
+}
+
+std::int16_t WiFiClass::scanNetworks(const bool async)
+{
+    (void) async;
+    m_scanResult = isic::native::isWiFiLinkUp() ? 1 : 0;
+    return m_scanResult;
+}
+
+String WiFiClass::SSID(const std::uint8_t index) const
+{
+    return index < m_scanResult ? String("isic-native") : String();
+}
+
+std::int32_t WiFiClass::RSSI(const std::uint8_t index) const
+{
+    return index < m_scanResult ? -55 : 0;
+}
+
+wifi_auth_mode_t WiFiClass::encryptionType(const std::uint8_t index) const
+{
+    (void) index;
+    return WIFI_AUTH_OPEN;
+}
+
+// ============================================================================
+// WiFiClient
+// ============================================================================
+
+struct WiFiClient::Socket
+{
+    Socket(const int descriptor, const bool followsLink)
+        : fd(descriptor)
+        , generation(g_linkGeneration)
+        , followsLink(followsLink)
+    {
+    }
+    ~Socket()
+    {
+        ::close(fd);
+    }
+    Socket(const Socket &) = delete;
+    Socket &operator=(const Socket &) = delete;
+
+    [[nodiscard]] bool linkAlive() const
+    {
+        return !followsLink || (g_linkUp && generation == g_linkGeneration);
+    }
+
+    int fd;
+    std::uint32_t generation;
+    bool followsLink;
+    bool peerClosed{false};
+};
+
+WiFiClient::WiFiClient() = default;
+
+int WiFiClient::connect(const IPAddress ip, const std::uint16_t port)
+{
+    return connect(ip.toString().c_str(), port);
+}
+
+int WiFiClient::connect(const char *host, const std::uint16_t port)
+{
+    return connect(host, port, kConnectTimeoutMs);
+}
+
+int WiFiClient::connect(const char *host, const std::uint16_t port, const std::int32_t timeoutMs)
+{
+    stop();
+    if ((m_followsLink && !isic::native::isWiFiLinkUp()) || host == nullptr)
+    {
+        return 0;
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *results{nullptr};
+    const auto service{std::to_string(port)};
+    if (::getaddrinfo(host, service.c_str(), &hints, &results) != 0)
+    {
+        return 0;
+    }
+
+    for (auto *ai{results}; ai != nullptr && !m_socket; ai = ai->ai_next)
+    {
+        const auto fd{::socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, ai->ai_protocol)};
+        if (fd < 0)
+        {
+            continue;
+        }
+
+        auto connected{::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0};
+        if (!connected && errno == EINPROGRESS)
+        {
+            pollfd pfd{fd, POLLOUT, 0};
+            int error{0};
+            socklen_t length{sizeof(error)};
+            connected = ::poll(&pfd, 1, timeoutMs) == 1 &&
+                        ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0;
+        }
+        if (!connected)
+        {
+            ::close(fd);
+            continue;
+        }
+
+        const int noDelay{1};
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        m_socket = std::make_shared<Socket>(fd, m_followsLink);
+    }
+    ::freeaddrinfo(results);
+    return m_socket ? 1 : 0;
+}
+
+std::size_t WiFiClient::write(const std::uint8_t c)
+{
+    return write(&c, 1);
+}
+
+std::size_t WiFiClient::write(const std::uint8_t *buffer, const std::size_t size)
+{
+    std::size_t sent{0};
+    while (sent < size && connected())
+    {
+        const auto n{::send(m_socket->fd, buffer + sent, size - sent, MSG_NOSIGNAL)};
+        if (n > 0)
+        {
+            sent += static_cast<std::size_t>(n);
+        }
+        else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            pollfd pfd{m_socket->fd, POLLOUT, 0};
+            if (::poll(&pfd, 1, kConnectTimeoutMs) != 1)
+            {
+                break;
+            }
+        }
+        else
+        {
+            m_socket->peerClosed = true;
+            break;
+        }
+    }
+    return sent;
+}
+
+int WiFiClient::available()
+{
+    if (!connected())
+    {
+        return 0;
+    }
+
+    int pending{0};
+    ::ioctl(m_socket->fd, FIONREAD, &pending);
+    if (pending == 0 && isic::native::getClockMode() == isic::native::ClockMode::Virtual)
+    {
+        // Waiting on the network takes time on the device too
+        pollfd pfd{m_socket->fd, POLLIN, 0};
+        if (::poll(&pfd, 1, 1) == 1)
+        {
+            ::ioctl(m_socket->fd, FIONREAD, &pending);
+        }
+        isic::native::advanceClockMs(1);
+    }
+    return pending;
+}
+
+int WiFiClient::read()
+{
+    std::uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(std::uint8_t *buffer, const std::size_t size)
+{
+    if (!connected())
+    {
+        return -1;
+    }
+    const auto n{::recv(m_socket->fd, buffer, size, 0)};
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+    {
+        m_socket->peerClosed = true;
+    }
+    return n > 0 ? static_cast<int>(n) : -1;
+}
+
+int WiFiClient::peek()
+{
+    std::uint8_t c;
+    return connected() && ::recv(m_socket->fd, &c, 1, MSG_PEEK) == 1 ? c : -1;
+}
+
+void WiFiClient::flush()
+{
+}
+
+void WiFiClient::stop()
+{
+    m_socket.reset();
+}
+
+std::uint8_t WiFiClient::connected()
+{
+    if (!m_socket || m_socket->peerClosed || !m_socket->linkAlive())
+    {
+        return 0;
+    }
+
+    // Orderly shutdown by the peer shows up as a readable socket with nothing to read
+    std::uint8_t c;
+    const auto n{::recv(m_socket->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT)};
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+    {
+        m_socket->peerClosed = true;
+        return 0;
+    }
+    return 1;
+}
@@ -0,0 +1,132 @@
+#ifndef ISIC_NATIVE_WIFI_H
+#define ISIC_NATIVE_WIFI_H
+
+#include "Arduino.h"
+#include "IPAddress.h"
+#include "WiFiClient.h"
+
+#include <cstdint>
+
+typedef enum
+{
+    WL_NO_SHIELD = 255,
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6,
+} wl_status_t;
+
+typedef enum
+{
+    WIFI_MODE_NULL = 0,
+    WIFI_MODE_STA,
+    WIFI_MODE_AP,
+    WIFI_MODE_APSTA,
+} wifi_mode_t;
+
+#define WIFI_OFF WIFI_MODE_NULL
+#define WIFI_STA WIFI_MODE_STA
+#define WIFI_AP WIFI_MODE_AP
+#define WIFI_AP_STA WIFI_MODE_APSTA
+
+typedef enum
+{
+    WIFI_AUTH_OPEN = 0,
+    WIFI_AUTH_WEP,
+    WIFI_AUTH_WPA_PSK,
+    WIFI_AUTH_WPA2_PSK,
+    WIFI_AUTH_WPA_WPA2_PSK,
+    WIFI_AUTH_WPA2_ENTERPRISE,
+} wifi_auth_mode_t;
+
+typedef enum
+{
+    WPA2_AUTH_TLS = 0,
+    WPA2_AUTH_PEAP = 1,
+    WPA2_AUTH_TTLS = 2,
+} wpa2_auth_method_t;
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+
+/**
+ * WiFi on the host. A station connect succeeds with any credentials once
+ * the simulated AP is in range (isic::native::setWiFiLinkUp); the network
+ * underneath is the workstation's, so localIP() is loopback. Scans find
+ * one open network, "isic-native".
+ */
+class WiFiClass
+{
+public:
+    void persistent(bool)
+    {
+    }
+    bool mode(wifi_mode_t mode);
+    wifi_mode_t getMode() const
+    {
+        return m_mode;
+    }
+
+    wl_status_t begin(const char *ssid, const char *password = nullptr);
+    wl_status_t begin(const char *ssid, wpa2_auth_method_t method, const char *identity, const char *username,
+                      const char *password);
+    bool disconnect(bool wifiOff = false, bool eraseAp = false);
+    wl_status_t status();
+    bool isConnected()
+    {
+        return status() == WL_CONNECTED;
+    }
+
+    String SSID() const
+    {
+        return m_ssid;
+    }
+    std::int8_t RSSI()
+    {
+        return isConnected() ? -55 : 0;
+    }
+    IPAddress localIP()
+    {
+        return isConnected() ? IPAddress(127, 0, 0, 1) : IPAddress();
+    }
+
+    bool softAPConfig(IPAddress localIp, IPAddress gateway, IPAddress subnet);
+    bool softAP(const char *ssid, const char *password = nullptr);
+    bool softAPdisconnect(bool wifiOff = false);
+    IPAddress softAPIP() const
+    {
+        return m_apIp;
+    }
+    std::uint8_t softAPgetStationNum() const
+    {
+        return 0;
+    }
+
+    std::int16_t scanNetworks(bool async = false);
+    std::int16_t scanComplete() const
+    {
+        return m_scanResult;
+    }
+    void scanDelete()
+    {
+        m_scanResult = WIFI_SCAN_FAILED;
+    }
+    String SSID(std::uint8_t index) const;
+    std::int32_t RSSI(std::uint8_t index) const;
+    wifi_auth_mode_t encryptionType(std::uint8_t index) const;
+
+private:
+    wifi_mode_t m_mode{WIFI_MODE_NULL};
+    String m_ssid{};
+    bool m_stationStarted{false};
+    IPAddress m_apIp{192, 168, 4, 1};
+    bool m_apStarted{false};
+    std::int16_t m_scanResult{WIFI_SCAN_FAILED};
+};
+
+extern WiFiClass WiFi;
+
+#endif // ISIC_NATIVE_WIFI_H
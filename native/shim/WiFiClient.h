@@ -0,0 +1,77 @@
+#ifndef ISIC_NATIVE_WIFICLIENT_H
+#define ISIC_NATIVE_WIFICLIENT_H
+
+#include "Client.h"
+
+#include <memory>
+
+/**
+ * TCP client on a host socket. Copies share the connection, as on ESP32.
+ *
+ * A socket opened while the simulated AP is in range reads as disconnected
+ * once it goes out of range (isic::native::setWiFiLinkUp). With a virtual
+ * clock, available() on an idle socket waits up to 1 ms of wall time and
+ * charges 1 ms of virtual time, so PubSubClient's read timeouts still fire.
+ */
+class WiFiClient : public Client
+{
+public:
+    WiFiClient();
+    ~WiFiClient() override = default;
+
+    int connect(IPAddress ip, std::uint16_t port) override;
+    int connect(const char *host, std::uint16_t port) override;
+    int connect(const char *host, std::uint16_t port, std::int32_t timeoutMs);
+
+    std::size_t write(std::uint8_t c) override;
+    std::size_t write(const std::uint8_t *buffer, std::size_t size) override;
+    using Print::write;
+
+    int available() override;
+    int read() override;
+    int read(std::uint8_t *buffer, std::size_t size) override;
+    int peek() override;
+    void flush() override;
+    void stop() override;
+    std::uint8_t connected() override;
+    operator bool() override
+    {
+        return connected() != 0;
+    }
+
+    void setNoDelay(bool)
+    {
+    }
+
+protected:
+    bool canReceiveMore() override
+    {
+        return connected() != 0;
+    }
+
+    bool m_followsLink{true}; ///< Subject to isic::native::setWiFiLinkUp()
+
+private:
+    struct Socket;
+
+    std::shared_ptr<Socket> m_socket{};
+};
+
+namespace isic::native
+{
+/**
+ * TCP client for the harness side of a simulation (a subscriber, a fake
+ * backend): it is not behind the simulated AP, so it connects and stays
+ * connected whatever setWiFiLinkUp() says.
+ */
+class HostClient : public WiFiClient
+{
+public:
+    HostClient()
+    {
+        m_followsLink = false;
+    }
+};
+} // namespace isic::native
+
+#endif // ISIC_NATIVE_WIFICLIENT_H
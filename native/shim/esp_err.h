@@ -0,0 +1,9 @@
+#ifndef ISIC_NATIVE_ESP_ERR_H
+#define ISIC_NATIVE_ESP_ERR_H
+
+using esp_err_t = int;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+
+#endif // ISIC_NATIVE_ESP_ERR_H
@@ -0,0 +1,48 @@
+#ifndef ISIC_NATIVE_ESP_SLEEP_H
+#define ISIC_NATIVE_ESP_SLEEP_H
+
+#include "esp_err.h"
+
+#include <cstdint>
+
+typedef enum
+{
+    ESP_SLEEP_WAKEUP_UNDEFINED,
+    ESP_SLEEP_WAKEUP_ALL,
+    ESP_SLEEP_WAKEUP_EXT0,
+    ESP_SLEEP_WAKEUP_EXT1,
+    ESP_SLEEP_WAKEUP_TIMER,
+    ESP_SLEEP_WAKEUP_TOUCHPAD,
+    ESP_SLEEP_WAKEUP_ULP,
+    ESP_SLEEP_WAKEUP_GPIO,
+    ESP_SLEEP_WAKEUP_UART,
+} esp_sleep_source_t;
+
+using esp_sleep_wakeup_cause_t = esp_sleep_source_t;
+
+/// Every host run is a cold boot
+inline esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause()
+{
+    return ESP_SLEEP_WAKEUP_UNDEFINED;
+}
+
+inline esp_err_t esp_sleep_enable_timer_wakeup(const std::uint64_t)
+{
+    return ESP_OK;
+}
+
+inline esp_err_t esp_sleep_enable_ext0_wakeup(const int, const int)
+{
+    return ESP_OK;
+}
+
+/// Ends the process with isic::native::kDeepSleepExitCode
+[[noreturn]] void esp_deep_sleep_start();
+
+/// Returns at once: light sleep is just time passing, and the host loop does that
+inline esp_err_t esp_light_sleep_start()
+{
+    return ESP_OK;
+}
+
+#endif // ISIC_NATIVE_ESP_SLEEP_H
@@ -0,0 +1,18 @@
+#ifndef ISIC_NATIVE_ESP_WIFI_H
+#define ISIC_NATIVE_ESP_WIFI_H
+
+#include "esp_err.h"
+
+typedef enum
+{
+    WIFI_PS_NONE,
+    WIFI_PS_MIN_MODEM,
+    WIFI_PS_MAX_MODEM,
+} wifi_ps_type_t;
+
+inline esp_err_t esp_wifi_set_ps(const wifi_ps_type_t)
+{
+    return ESP_OK;
+}
+
+#endif // ISIC_NATIVE_ESP_WIFI_H
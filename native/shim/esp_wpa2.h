@@ -0,0 +1,7 @@
+#ifndef ISIC_NATIVE_ESP_WPA2_H
+#define ISIC_NATIVE_ESP_WPA2_H
+
+// WPA2-Enterprise has nothing to configure on the host: WiFi.begin() with
+// an identity behaves like any other station connect (see WiFi.h)
+
+#endif // ISIC_NATIVE_ESP_WPA2_H
@@ -0,0 +1,317 @@
+/**
+ * @file AttendanceDeliveryTest.cpp
+ * @brief Every attendance record reaches the broker exactly once, in order
+ *
+ * A fake broker stands in for MqttService: it decodes each attendance publish
+ * it accepts and answers confirmed ones with MqttPublished or
+ * MqttPublishFailed, as MqttService does. Whatever it is made to refuse, and
+ * whatever the bus evicts, the sequence numbers it saw must come out as
+ * 1..N with nothing missing and nothing repeated.
+ */
+
+#include "TestSupport.hpp"
+
+#include "NativeHost.hpp"
+#include "services/AttendanceService.hpp"
+
+#include <LittleFS.h>
+#include <Print.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+using namespace isic;
+
+/// Collects what a PayloadWriter puts on air
+class Capture : public Print
+{
+public:
+    std::size_t write(const std::uint8_t byte) override
+    {
+        text.push_back(static_cast<char>(byte));
+        return 1;
+    }
+
+    std::size_t write(const std::uint8_t *buffer, const std::size_t size) override
+    {
+        text.append(reinterpret_cast<const char *>(buffer), size);
+        return size;
+    }
+
+    std::string text;
+};
+
+/// MqttService's side of an attendance publish, with a link that can be made to fail
+class FakeBroker
+{
+public:
+    explicit FakeBroker(EventBus &bus)
+        : m_bus(bus)
+        , m_connection(bus.subscribeScoped(EventType::MqttPublishRequest, [this](const Event &event) { receive(*event.get<MqttEvent>()); }))
+    {
+    }
+
+    bool up{true};
+    std::uint32_t failNext{0}; ///< Publishes to fail before the link works again
+
+    std::vector<std::uint32_t> sequences; ///< Every record accepted, in arrival order
+    std::uint32_t failures{0};
+    std::size_t largestPayload{0}; ///< Bytes on air of the longest attendance publish
+
+    /// Each of 1..@p count exactly once, in order
+    [[nodiscard]] bool receivedInOrder(const std::uint32_t count) const
+    {
+        if (sequences.size() != count)
+        {
+            return false;
+        }
+        for (std::uint32_t i{0}; i < count; ++i)
+        {
+            if (sequences[i] != i + 1)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    void receive(const MqttEvent &mqtt)
+    {
+        const auto accepted{up && failNext == 0};
+        if (accepted && mqtt.topic == "attendance")
+        {
+            Capture capture;
+            mqtt.writer(mqtt.payload.view(), &capture);
+            largestPayload = std::max(largestPayload, capture.text.size());
+            for (auto at{capture.text.find("\"seq\":")}; at != std::string::npos; at = capture.text.find("\"seq\":", at + 1))
+            {
+                sequences.push_back(static_cast<std::uint32_t>(std::strtoul(capture.text.c_str() + at + 6, nullptr, 10)));
+            }
+        }
+        else if (!accepted)
+        {
+            failNext -= failNext != 0 ? 1 : 0;
+            ++failures;
+        }
+
+        if (mqtt.confirm)
+        {
+            m_bus.publish(Event{accepted ? EventType::MqttPublished : EventType::MqttPublishFailed, mqtt});
+        }
+    }
+
+    EventBus &m_bus;
+    EventBus::ScopedConnection m_connection;
+};
+
+/// A started AttendanceService on a fresh flash, the broker connected, time virtual
+class Fixture
+{
+public:
+    explicit Fixture(const bool journal)
+    {
+        native::setClockMode(native::ClockMode::Virtual);
+        LittleFS.begin(true);
+        LittleFS.format();
+
+        m_config.journalEnabled = journal;
+        m_config.debounceIntervalMs = 0;
+        m_config.batchingEnabled = true;
+        m_config.batchMaxSize = 5;
+        m_config.offlineBufferSize = 1000;
+        (void)m_service.begin();
+
+        m_bus.publish(EventType::MqttConnected);
+        m_bus.dispatch();
+    }
+
+    ~Fixture()
+    {
+        m_service.end();
+    }
+
+    Fixture(const Fixture &) = delete;
+    Fixture &operator=(const Fixture &) = delete;
+
+    /// A tap of a card no one tapped before
+    void tap()
+    {
+        const auto index{m_taps++};
+        const CardEvent card{static_cast<std::uint32_t>(millis()),
+                             CardUid{4, static_cast<std::uint8_t>(index), static_cast<std::uint8_t>(index >> 8), 1, 2, 3, 4}};
+        m_bus.publish(Event{EventType::CardScanned, card});
+    }
+
+    /// Let @p ms of virtual time pass, one dispatch per millisecond
+    void run(const std::uint32_t ms)
+    {
+        for (std::uint32_t i{0}; i < ms; ++i)
+        {
+            native::advanceClockMs(1);
+            m_bus.dispatch();
+        }
+    }
+
+    /// Run until nothing is batched, buffered or in flight (one minute at most)
+    void settle()
+    {
+        for (std::uint32_t i{0}; i < 60; ++i)
+        {
+            run(1000);
+            if (m_service.getCurrentBatchSize() == 0 && m_service.getOfflineBufferSize() == 0 && m_bus.pendingCount() == 0 &&
+                m_broker.sequences.size() == m_taps)
+            {
+                return;
+            }
+        }
+    }
+
+    [[nodiscard]] std::uint32_t taps() const
+    {
+        return m_taps;
+    }
+
+    EventBus &bus()
+    {
+        return m_bus;
+    }
+
+    AttendanceService &service()
+    {
+        return m_service;
+    }
+
+    FakeBroker &broker()
+    {
+        return m_broker;
+    }
+
+private:
+    EventBus m_bus;
+    AttendanceConfig m_config{};
+    AttendanceService m_service{m_bus, m_config};
+    FakeBroker m_broker{m_bus};
+    std::uint32_t m_taps{0};
+};
+
+/// Failed online publishes are kept and sent again
+void testFailedOnlineBatches()
+{
+    Fixture fixture{false};
+    fixture.broker().failNext = 3;
+
+    for (int i{0}; i < 60; ++i)
+    {
+        fixture.tap();
+        fixture.run(150);
+    }
+    fixture.settle();
+
+    ISIC_CHECK_EQUAL(fixture.broker().failures, 3U);
+    ISIC_CHECK(fixture.broker().receivedInOrder(fixture.taps()));
+    ISIC_CHECK_EQUAL(fixture.service().getOfflineBufferSize(), 0U);
+}
+
+/// A publish request evicted from the bus queue is sent again after the retry interval
+void testEvictedRequest()
+{
+    Fixture fixture{false};
+    const auto capacity{kEventTraitsTable[static_cast<std::size_t>(EventType::MqttPublishRequest)].capacity};
+
+    for (int i{0}; i < 5; ++i)
+    {
+        fixture.tap(); // A full batch: flushed by the next timer run
+    }
+    fixture.bus().dispatch(0); // Timers only: the batch is now a pending publish request
+
+    // Other publishers push the batch out of the request queue before the broker sees it
+    for (std::size_t i{0}; i < capacity; ++i)
+    {
+        fixture.bus().publish(Event{EventType::MqttPublishRequest, MqttEvent{"health", PayloadBuffer{}}});
+    }
+    ISIC_CHECK_EQUAL(fixture.bus().droppedCount(EventType::MqttPublishRequest), 1U);
+    fixture.run(10);
+    ISIC_CHECK(fixture.broker().sequences.empty());
+
+    fixture.tap(); // Waits behind the lost batch, follows it
+    fixture.settle();
+
+    ISIC_CHECK(fixture.broker().receivedInOrder(fixture.taps()));
+}
+
+/// The link drops with a batch in flight: it goes to the journal and is drained on reconnect
+void testDisconnectInFlight()
+{
+    Fixture fixture{true};
+
+    for (int i{0}; i < 5; ++i)
+    {
+        fixture.tap();
+    }
+    fixture.bus().dispatch(0); // Timers only: the batch is now a pending publish request
+    fixture.broker().up = false;
+    fixture.bus().publish(EventType::MqttDisconnected);
+    fixture.run(AttendanceConfig::kDefaultBatchFlushIntervalMs + 1000); // Back in the batch, written out on its interval
+
+    ISIC_CHECK(fixture.service().isOfflineMode());
+    ISIC_CHECK_EQUAL(fixture.service().getOfflineBufferSize(), 5U);
+
+    fixture.tap();
+    fixture.run(15000);
+    fixture.broker().up = true;
+    fixture.bus().publish(EventType::MqttConnected);
+    fixture.settle();
+
+    ISIC_CHECK(fixture.broker().receivedInOrder(fixture.taps()));
+    ISIC_CHECK_EQUAL(fixture.service().getOfflineBufferSize(), 0U);
+}
+
+/// An offline backlog drains in chunks; a failed chunk is sent again from its first record, nothing before it
+void testBacklogDrain(const bool journal)
+{
+    Fixture fixture{journal};
+    fixture.broker().up = false;
+    fixture.bus().publish(EventType::MqttDisconnected);
+    for (int i{0}; i < 700; ++i)
+    {
+        fixture.tap();
+        fixture.run(1);
+    }
+    fixture.run(AttendanceConfig::kDefaultBatchFlushIntervalMs + 1000);
+    ISIC_CHECK_EQUAL(fixture.service().getOfflineBufferSize(), 700U);
+
+    // The first chunks fail, then one fails again halfway through the drain
+    fixture.broker().up = true;
+    fixture.broker().failNext = 2;
+    fixture.bus().publish(EventType::MqttConnected);
+    for (std::uint32_t ms{0}; ms < 30000 && fixture.broker().sequences.size() < 300; ++ms)
+    {
+        fixture.run(1);
+    }
+    ISIC_CHECK(fixture.broker().sequences.size() < fixture.taps());
+    fixture.broker().failNext = 1;
+    fixture.settle();
+
+    ISIC_CHECK_EQUAL(fixture.broker().failures, 3U);
+    ISIC_CHECK(fixture.broker().receivedInOrder(fixture.taps()));
+    ISIC_CHECK(fixture.broker().largestPayload <= MqttConfig::Constants::kMaxPayloadSizeBytes);
+    ISIC_CHECK_EQUAL(fixture.service().getOfflineBufferSize(), 0U);
+    ISIC_CHECK_EQUAL(fixture.service().getMetrics().offlineRecordsSent, 700U);
+}
+} // namespace
+
+int main()
+{
+    testFailedOnlineBatches();
+    testEvictedRequest();
+    testDisconnectInFlight();
+    testBacklogDrain(true);
+    testBacklogDrain(false);
+    return isic::test::result();
+}
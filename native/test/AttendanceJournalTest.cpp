@@ -0,0 +1,317 @@
+/**
+ * @file AttendanceJournalTest.cpp
+ * @brief utils::AttendanceJournal across power cuts
+ *
+ * A power cut is a journal object going away without end() and a new one
+ * opened with begin() on whatever the in-memory LittleFS holds; the damage
+ * a cut can do on the device (a short write, a flipped bit, a rename that
+ * never happened) is made by editing the files in between. A full flash is
+ * a partition shrunk under a running journal. Undelivered records may come
+ * back twice but must never go missing or change order.
+ */
+
+#include "TestSupport.hpp"
+
+#include "NativeHost.hpp"
+#include "utils/AttendanceJournal.hpp"
+
+#include <LittleFS.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace
+{
+using namespace isic;
+using utils::AttendanceJournal;
+
+constexpr std::uint32_t kMaxRecords{5000};
+constexpr std::size_t kFrameBytes{20};
+
+AttendanceRecord record(const std::uint32_t sequence)
+{
+    return AttendanceRecord{sequence * 10, sequence, CardUid{4, static_cast<std::uint8_t>(sequence), 1, 2, 3, 4, 5}};
+}
+
+/// An empty flash with @p count records, numbered from 1, written to it
+void writeJournal(const std::uint32_t count)
+{
+    LittleFS.format();
+    AttendanceJournal journal;
+    journal.begin(kMaxRecords);
+    for (std::uint32_t sequence{1}; sequence <= count; ++sequence)
+    {
+        journal.append(record(sequence));
+    }
+    journal.flush();
+}
+
+std::string segmentPath(const std::uint32_t segment)
+{
+    return std::string{AttendanceJournal::kDirectory} + "/" + std::to_string(segment) + ".seg";
+}
+
+std::vector<std::uint8_t> readFile(const std::string &path)
+{
+    auto file{LittleFS.open(path.c_str(), "r")};
+    std::vector<std::uint8_t> bytes(file ? file.size() : 0);
+    if (file)
+    {
+        file.read(bytes.data(), bytes.size());
+        file.close();
+    }
+    return bytes;
+}
+
+void writeFile(const std::string &path, const std::vector<std::uint8_t> &bytes, const char *mode = "w")
+{
+    auto file{LittleFS.open(path.c_str(), mode)};
+    file.write(bytes.data(), bytes.size());
+    file.close();
+}
+
+/// Sequence numbers of every record left, oldest first
+std::vector<std::uint32_t> sequences(AttendanceJournal &journal)
+{
+    std::vector<AttendanceRecord> records;
+    journal.peek(records, journal.size());
+    std::vector<std::uint32_t> result;
+    for (const auto &entry: records)
+    {
+        result.push_back(entry.sequence);
+    }
+    return result;
+}
+
+std::vector<std::uint32_t> range(const std::uint32_t first, const std::uint32_t last)
+{
+    std::vector<std::uint32_t> result;
+    for (auto sequence{first}; sequence <= last; ++sequence)
+    {
+        result.push_back(sequence);
+    }
+    return result;
+}
+
+/// Half a frame at the end of the last segment: cut off, the rest intact, appends carry on behind it
+void testTornTailFrame()
+{
+    writeJournal(100);
+    writeFile(segmentPath(1), {0x65, 0x00, 0x00, 0x00, 0x10, 0x20, 0x30}, "a");
+
+    AttendanceJournal journal;
+    ISIC_CHECK(journal.begin(kMaxRecords));
+    ISIC_CHECK_EQUAL(journal.size(), 100U);
+    ISIC_CHECK_EQUAL(journal.getMetrics().recovered, 1U);
+    ISIC_CHECK_EQUAL(journal.lastSequence(), 100U);
+    ISIC_CHECK_EQUAL(readFile(segmentPath(1)).size(), 100 * kFrameBytes);
+
+    journal.append(record(101));
+    ISIC_CHECK(sequences(journal) == range(1, 101));
+}
+
+/// A flipped bit mid-file is skipped on read and still consumed; at the tail it is cut off like a torn frame
+void testCrcCorruption()
+{
+    writeJournal(100);
+    auto bytes{readFile(segmentPath(1))};
+    bytes[40 * kFrameBytes + 9] ^= 0x01; // Record 41
+    writeFile(segmentPath(1), bytes);
+
+    {
+        AttendanceJournal journal;
+        journal.begin(kMaxRecords);
+        ISIC_CHECK_EQUAL(journal.size(), 100U);
+        ISIC_CHECK_EQUAL(journal.getMetrics().recovered, 0U);
+
+        std::vector<AttendanceRecord> records;
+        ISIC_CHECK_EQUAL(journal.peek(records, 50), 50U);
+        ISIC_CHECK_EQUAL(records.size(), 49U);
+        ISIC_CHECK_EQUAL(journal.getMetrics().corrupt, 1U);
+        ISIC_CHECK_EQUAL(records[40].sequence, 42U);
+        journal.consume(50);
+        ISIC_CHECK(sequences(journal) == range(51, 100));
+    }
+
+    writeJournal(100);
+    bytes = readFile(segmentPath(1));
+    bytes[99 * kFrameBytes + 17] ^= 0x80; // CRC of record 100
+    writeFile(segmentPath(1), bytes);
+
+    AttendanceJournal journal;
+    journal.begin(kMaxRecords);
+    ISIC_CHECK_EQUAL(journal.size(), 99U);
+    ISIC_CHECK_EQUAL(journal.getMetrics().recovered, 1U);
+    ISIC_CHECK_EQUAL(journal.lastSequence(), 99U);
+    ISIC_CHECK(sequences(journal) == range(1, 99));
+}
+
+/// Power lost after the new cursor reached cursor.tmp but before the rename: the old position holds
+void testCutBeforeCursorRename()
+{
+    writeJournal(100);
+    const std::string cursorPath{std::string{AttendanceJournal::kDirectory} + "/cursor"};
+
+    std::vector<std::uint8_t> before;
+    std::vector<std::uint8_t> after;
+    {
+        AttendanceJournal journal;
+        journal.begin(kMaxRecords);
+        journal.consume(30);
+        before = readFile(cursorPath);
+        journal.consume(20);
+        after = readFile(cursorPath);
+    }
+    ISIC_CHECK(before != after);
+
+    writeFile(cursorPath, before);
+    writeFile(cursorPath + ".tmp", after);
+    {
+        AttendanceJournal journal;
+        journal.begin(kMaxRecords);
+        ISIC_CHECK(sequences(journal) == range(31, 100)); // 31-50 go out twice, nothing is skipped
+
+        // The stale temp file is overwritten by the next cursor write
+        journal.consume(10);
+    }
+
+    // A torn temp file next to a good cursor changes nothing
+    writeFile(cursorPath + ".tmp", {0x43, 0x4A});
+    AttendanceJournal journal;
+    journal.begin(kMaxRecords);
+    ISIC_CHECK(sequences(journal) == range(41, 100));
+}
+
+/// Several segments, part delivered: a reopen counts what is left, and numbering goes on after it
+void testReopenAcrossSegments()
+{
+    const auto perSegment{AttendanceJournal::kRecordsPerSegment};
+    writeJournal(2 * perSegment + 276);
+    {
+        AttendanceJournal journal;
+        journal.begin(kMaxRecords);
+        ISIC_CHECK_EQUAL(journal.size(), 2 * perSegment + 276);
+        journal.consume(perSegment + 88);
+        ISIC_CHECK(!LittleFS.exists(segmentPath(1).c_str()));
+    }
+
+    AttendanceJournal journal;
+    journal.begin(kMaxRecords);
+    ISIC_CHECK_EQUAL(journal.size(), perSegment + 188);
+    ISIC_CHECK_EQUAL(journal.lastSequence(), 2 * perSegment + 276);
+
+    journal.append(record(2 * perSegment + 277));
+    ISIC_CHECK(sequences(journal) == range(perSegment + 89, 2 * perSegment + 277));
+
+    // Delivered to the end: the next boot starts on an empty journal in a fresh segment
+    journal.consume(journal.size());
+    AttendanceJournal reopened;
+    reopened.begin(kMaxRecords);
+    ISIC_CHECK(reopened.empty());
+    ISIC_CHECK(!LittleFS.exists(segmentPath(3).c_str()));
+}
+
+/// The tail segment holds only a torn first frame: lastSequence() comes from the segment before
+void testTornFirstFrameOfSegment()
+{
+    const auto perSegment{AttendanceJournal::kRecordsPerSegment};
+    writeJournal(perSegment);
+    writeFile(segmentPath(2), {0x01, 0x02, 0x00, 0x00, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA});
+
+    AttendanceJournal journal;
+    journal.begin(kMaxRecords);
+    ISIC_CHECK_EQUAL(journal.size(), perSegment);
+    ISIC_CHECK_EQUAL(journal.lastSequence(), perSegment);
+    ISIC_CHECK_EQUAL(journal.getMetrics().recovered, 1U);
+
+    journal.append(record(perSegment + 1));
+    ISIC_CHECK(sequences(journal) == range(1, perSegment + 1));
+}
+
+/// DropOldest removes one record at a time and writes the cursor with the next batch, not per drop
+void testDropOldest()
+{
+    const auto perSegment{AttendanceJournal::kRecordsPerSegment};
+    writeJournal(perSegment + 100);
+    {
+        AttendanceJournal journal;
+        journal.begin(kMaxRecords);
+        const auto writes{journal.getMetrics().flashWrites};
+        for (int i{0}; i < 3; ++i)
+        {
+            journal.dropOldest();
+        }
+        ISIC_CHECK_EQUAL(journal.size(), perSegment + 97);
+        ISIC_CHECK_EQUAL(journal.getMetrics().dropped, 3U);
+        ISIC_CHECK_EQUAL(journal.getMetrics().flashWrites, writes);
+
+        // Power lost before a flush: the drops are undone, nothing undelivered is lost
+    }
+    {
+        AttendanceJournal journal;
+        journal.begin(kMaxRecords);
+        ISIC_CHECK_EQUAL(journal.size(), perSegment + 100);
+        for (int i{0}; i < 3; ++i)
+        {
+            journal.dropOldest();
+        }
+        journal.flush();
+    }
+
+    AttendanceJournal journal;
+    journal.begin(kMaxRecords);
+    ISIC_CHECK(sequences(journal) == range(4, perSegment + 100));
+}
+
+/// The flash fills up mid-flush: the frames that landed count as written once, and appends go on frame-aligned
+void testShortWriteWhenFull()
+{
+    LittleFS.format();
+    const auto capacity{LittleFS.totalBytes()};
+    native::setFilesystemCapacity(4 * 4096); // Superblocks, the directory and one block of segment 1
+    {
+        AttendanceJournal journal;
+        journal.begin(kMaxRecords);
+        for (std::uint32_t sequence{1}; sequence <= 210; ++sequence)
+        {
+            journal.append(record(sequence));
+        }
+
+        // 204 frames fit in the block, the 205th is torn and there is no room to copy the segment without it
+        ISIC_CHECK(!journal.flush());
+        ISIC_CHECK_EQUAL(journal.size(), 210U);
+        ISIC_CHECK_EQUAL(readFile(segmentPath(1)).size(), 4096U);
+        ISIC_CHECK(sequences(journal) == range(1, 204));
+
+        native::setFilesystemCapacity(capacity);
+        ISIC_CHECK(journal.flush());
+        ISIC_CHECK_EQUAL(readFile(segmentPath(2)).size(), 6 * kFrameBytes);
+        ISIC_CHECK(sequences(journal) == range(1, 210));
+        journal.consume(100);
+    }
+
+    AttendanceJournal journal;
+    journal.begin(kMaxRecords);
+    ISIC_CHECK_EQUAL(journal.lastSequence(), 210U);
+    ISIC_CHECK(sequences(journal) == range(101, 210));
+
+    // Delivered to the end: nothing hides behind the torn segment
+    journal.consume(journal.size());
+    ISIC_CHECK(journal.empty());
+    ISIC_CHECK(!LittleFS.exists(segmentPath(1).c_str()));
+}
+} // namespace
+
+int main()
+{
+    LittleFS.begin(true);
+    testTornTailFrame();
+    testCrcCorruption();
+    testCutBeforeCursorRename();
+    testReopenAcrossSegments();
+    testTornFirstFrameOfSegment();
+    testDropOldest();
+    testShortWriteWhenFull();
+    return isic::test::result();
+}
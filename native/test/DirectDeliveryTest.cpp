@@ -0,0 +1,217 @@
+/**
+ * @file DirectDeliveryTest.cpp
+ * @brief ConnectionMode::Direct subscribers of EventBus
+ *
+ * Direct subscribers run inside publish() on the dispatching task, and from
+ * dispatch() whenever they could not: before the first dispatch(), from
+ * another thread, or past ISIC_DIRECT_DEPTH_LIMIT nested deliveries. Either
+ * way each accepted event reaches every subscriber exactly once, and an event
+ * the queue refuses reaches none.
+ */
+
+#include "TestSupport.hpp"
+
+#include "core/EventBus.hpp"
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+using namespace isic;
+
+/// Who ran, in order: small integers chosen by each test
+struct CallLog
+{
+    std::vector<int> calls;
+
+    void add(const int who)
+    {
+        calls.push_back(who);
+    }
+
+    [[nodiscard]] std::size_t count(const int who) const
+    {
+        std::size_t n{0};
+        for (const auto call: calls)
+        {
+            n += call == who ? 1 : 0;
+        }
+        return n;
+    }
+};
+
+Event card()
+{
+    return Event{EventType::CardScanned, CardEvent{}};
+}
+
+/// Inline on the dispatching task, nested publishes included; queued before the first dispatch and from other threads
+void testInlineDelivery()
+{
+    EventBus bus;
+    CallLog log;
+    struct Context
+    {
+        EventBus *bus;
+        CallLog *log;
+    } context{&bus, &log};
+
+    auto attendance{bus.subscribeScoped(
+            EventType::CardScanned,
+            [context = &context](const Event &) {
+                context->log->add(1);
+                context->bus->publish(EventType::AttendanceRecorded);
+                context->log->add(3);
+            },
+            ConnectionMode::Direct)};
+    auto feedback{bus.subscribeScoped(EventType::AttendanceRecorded, [log = &log](const Event &) { log->add(2); }, ConnectionMode::Direct)};
+    auto queued{bus.subscribeScoped(EventType::CardScanned, [log = &log](const Event &) { log->add(9); })};
+
+    // The dispatching task is not known yet: everything waits for dispatch()
+    bus.publish(card());
+    ISIC_CHECK(log.calls.empty());
+    bus.dispatch();
+    ISIC_CHECK_EQUAL(log.count(1), 1U);
+    ISIC_CHECK_EQUAL(log.count(2), 1U);
+    ISIC_CHECK_EQUAL(log.count(9), 1U);
+
+    // Now inline, the nested Direct publish too; the Queued subscriber still waits
+    log.calls.clear();
+    const auto directBefore{bus.getMetrics().directDeliveries};
+    bus.publish(card());
+    ISIC_CHECK(log.calls == (std::vector{1, 2, 3}));
+    ISIC_CHECK_EQUAL(bus.getMetrics().directDeliveries, directBefore + 2);
+    bus.dispatch();
+    ISIC_CHECK(log.calls == (std::vector{1, 2, 3, 9}));
+
+    // Another thread: queued, and dispatch() runs the Direct subscribers as well
+    log.calls.clear();
+    std::thread([&bus]() { bus.publish(card()); }).join();
+    ISIC_CHECK(log.calls.empty());
+    bus.dispatch();
+    ISIC_CHECK_EQUAL(log.count(1), 1U);
+    ISIC_CHECK_EQUAL(log.count(2), 1U);
+    ISIC_CHECK_EQUAL(log.count(9), 1U);
+    ISIC_CHECK_EQUAL(bus.pendingCount(), 0U);
+}
+
+/// Past ISIC_DIRECT_DEPTH_LIMIT a nested publish is queued, and dispatch() delivers it once
+void testDepthLimitFallback()
+{
+    EventBus bus;
+    bus.dispatch();
+
+    struct Context
+    {
+        EventBus *bus;
+        int calls{0};
+        bool nested{true};
+    } context{&bus};
+
+    // Republishes itself while nesting: each level one deeper
+    auto recursive{bus.subscribeScoped(
+            EventType::AttendanceError,
+            [context = &context](const Event &) {
+                ++context->calls;
+                if (context->nested)
+                {
+                    context->bus->publish(EventType::AttendanceError);
+                }
+            },
+            ConnectionMode::Direct)};
+
+    bus.publish(EventType::AttendanceError);
+    ISIC_CHECK_EQUAL(context.calls, ISIC_DIRECT_DEPTH_LIMIT);
+    ISIC_CHECK_EQUAL(bus.getMetrics().directFallbacks, 1U);
+    ISIC_CHECK_EQUAL(bus.pendingCount(), static_cast<std::size_t>(ISIC_DIRECT_DEPTH_LIMIT) + 1);
+
+    // Queued copies of the inline deliveries are skipped; the fallback one is delivered
+    context.nested = false;
+    bus.dispatch();
+    ISIC_CHECK_EQUAL(context.calls, ISIC_DIRECT_DEPTH_LIMIT + 1);
+    ISIC_CHECK_EQUAL(bus.pendingCount(), 0U);
+}
+
+/// An event refused by BlockWithError never reaches a Direct subscriber, so a retry is not a duplicate
+void testRefusedEventSuppressed()
+{
+    EventBus bus;
+    bus.dispatch();
+
+    std::uint32_t direct{0};
+    auto connection{bus.subscribeScoped(EventType::CardScanned, [direct = &direct](const Event &) { ++*direct; }, ConnectionMode::Direct)};
+
+    std::uint32_t accepted{0};
+    std::uint32_t refused{0};
+    for (int i{0}; i < 40; ++i)
+    {
+        (bus.publish(card()) ? accepted : refused) += 1;
+    }
+    ISIC_CHECK(refused > 0);
+    ISIC_CHECK_EQUAL(bus.getTypeMetrics(EventType::CardScanned).blocked, refused);
+    ISIC_CHECK_EQUAL(direct, accepted);
+
+    while (bus.dispatch() != 0)
+    {
+    }
+    ISIC_CHECK_EQUAL(direct, accepted);
+}
+
+/// Subscribers connected or disconnected by a Direct callback, while its list is being invoked
+void testReentrantConnect()
+{
+    EventBus bus;
+    bus.dispatch();
+
+    struct Context
+    {
+        EventBus *bus;
+        CallLog log{};
+        EventBus::Connection self{0};
+        EventBus::Connection victim{0};
+        EventBus::Connection queuedVictim{0};
+        EventBus::Connection added{0};
+    } context{&bus};
+
+    context.self = bus.subscribe(
+            EventType::CardScanned,
+            [context = &context](const Event &) {
+                context->log.add(1);
+                // Itself and the ones later in this pass: they must not run, now or from dispatch()
+                context->bus->unsubscribe(EventType::CardScanned, context->self);
+                context->bus->unsubscribe(EventType::CardScanned, context->victim);
+                context->bus->unsubscribe(EventType::CardScanned, context->queuedVictim);
+                // Connected during this pass: sees the next event, not this one
+                context->added = context->bus->subscribe(
+                        EventType::CardScanned, [log = &context->log](const Event &) { log->add(4); }, ConnectionMode::Direct);
+            },
+            ConnectionMode::Direct);
+    context.victim = bus.subscribe(
+            EventType::CardScanned, [log = &context.log](const Event &) { log->add(2); }, ConnectionMode::Direct);
+    context.queuedVictim = bus.subscribe(EventType::CardScanned, [log = &context.log](const Event &) { log->add(3); });
+
+    bus.publish(card());
+    ISIC_CHECK(context.log.calls == (std::vector{1}));
+    bus.dispatch();
+    ISIC_CHECK(context.log.calls == (std::vector{1}));
+
+    context.log.calls.clear();
+    bus.publish(card());
+    ISIC_CHECK(context.log.calls == (std::vector{4}));
+    bus.dispatch();
+    ISIC_CHECK(context.log.calls == (std::vector{4}));
+    ISIC_CHECK_EQUAL(bus.pendingCount(), 0U);
+
+    bus.unsubscribe(EventType::CardScanned, context.added);
+}
+} // namespace
+
+int main()
+{
+    testInlineDelivery();
+    testDepthLimitFallback();
+    testRefusedEventSuppressed();
+    testReentrantConnect();
+    return isic::test::result();
+}
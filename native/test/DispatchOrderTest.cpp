@@ -0,0 +1,239 @@
+/**
+ * @file DispatchOrderTest.cpp
+ * @brief EventBus::DispatchOrder::Publish delivers in global publish order
+ *
+ * Every event carries a ticket (CardEvent::timestampMs) taken when it was
+ * published. In publish order the tickets must come out strictly increasing
+ * across all types, whatever the dispatch budget, and events lost to
+ * eviction or coalescing must leave no gap in the accounting.
+ */
+
+#include "TestSupport.hpp"
+
+#include "core/EventBus.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace
+{
+using namespace isic;
+
+constexpr auto kTypeCount{static_cast<std::size_t>(EventType::_Count)};
+
+/// What the subscribers saw, in delivery order
+struct DeliveryLog
+{
+    std::vector<std::uint32_t> tickets;
+    std::vector<EventType> types;
+
+    void receive(const Event &event)
+    {
+        tickets.push_back(event.get<CardEvent>()->timestampMs);
+        types.push_back(event.type);
+    }
+
+    [[nodiscard]] bool increasing() const
+    {
+        for (std::size_t i{1}; i < tickets.size(); ++i)
+        {
+            if (tickets[i] <= tickets[i - 1])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void clear()
+    {
+        tickets.clear();
+        types.clear();
+    }
+};
+
+/// A bus in publish order with every type (but None) logged
+class Fixture
+{
+public:
+    Fixture()
+    {
+        m_bus.setDispatchOrder(EventBus::DispatchOrder::Publish);
+        for (std::size_t type{1}; type < kTypeCount; ++type)
+        {
+            m_connections.push_back(
+                    m_bus.subscribeScoped(static_cast<EventType>(type), [log = &m_log](const Event &event) { log->receive(event); }));
+        }
+    }
+
+    bool publish(const EventType type)
+    {
+        CardEvent card{};
+        card.timestampMs = m_nextTicket++;
+        return m_bus.publish(Event{type, card});
+    }
+
+    EventBus &bus()
+    {
+        return m_bus;
+    }
+
+    DeliveryLog &log()
+    {
+        return m_log;
+    }
+
+    [[nodiscard]] std::uint32_t published() const
+    {
+        return m_nextTicket;
+    }
+
+private:
+    EventBus m_bus;
+    DeliveryLog m_log;
+    std::vector<EventBus::ScopedConnection> m_connections;
+    std::uint32_t m_nextTicket{0};
+};
+
+/// Random types and bursts, drained with small event budgets and a 1 us time budget
+void testRandomTraffic()
+{
+    Fixture fixture;
+    std::mt19937 random{1};
+    std::uint32_t refused{0};
+
+    for (int round{0}; round < 20000; ++round)
+    {
+        const auto burst{random() % 6};
+        for (std::uint32_t i{0}; i < burst; ++i)
+        {
+            const auto type{static_cast<EventType>(1 + random() % (kTypeCount - 1))};
+            refused += fixture.publish(type) ? 0 : 1;
+        }
+        if (random() % 4 == 0)
+        {
+            fixture.bus().dispatch(EventBus::kUnlimitedEvents, 1);
+        }
+        else
+        {
+            fixture.bus().dispatch(1 + random() % 4);
+        }
+    }
+    while (fixture.bus().dispatch() != 0)
+    {
+    }
+
+    ISIC_CHECK(fixture.log().increasing());
+    ISIC_CHECK_EQUAL(fixture.bus().pendingCount(), 0U);
+
+    // Every ticket is delivered, evicted, superseded or refused at the door
+    std::uint32_t lost{0};
+    std::uint32_t blocked{0};
+    std::uint32_t coalesced{0};
+    for (std::size_t type{1}; type < kTypeCount; ++type)
+    {
+        const auto metrics{fixture.bus().getTypeMetrics(static_cast<EventType>(type))};
+        lost += metrics.dropped;
+        blocked += metrics.blocked;
+        coalesced += metrics.coalesced;
+    }
+    ISIC_CHECK(coalesced > 0);
+    ISIC_CHECK(lost > 0);
+    ISIC_CHECK_EQUAL(fixture.log().tickets.size() + lost + blocked + coalesced, fixture.published());
+    ISIC_CHECK(refused <= lost + blocked);
+}
+
+/// Priority mode reorders by class; publish mode keeps the order of publish()
+void testOrderAcrossPriorities()
+{
+    Fixture fixture;
+
+    fixture.bus().setDispatchOrder(EventBus::DispatchOrder::Priority);
+    fixture.publish(EventType::ConfigError); // Low
+    fixture.publish(EventType::CardScanned); // Critical
+    fixture.bus().dispatch();
+    ISIC_CHECK(fixture.log().types == (std::vector{EventType::CardScanned, EventType::ConfigError}));
+
+    fixture.log().clear();
+    fixture.bus().setDispatchOrder(EventBus::DispatchOrder::Publish);
+    fixture.publish(EventType::MqttDisconnected);
+    fixture.publish(EventType::MqttPublishRequest);
+    fixture.publish(EventType::ConfigError);
+    fixture.publish(EventType::CardScanned);
+    fixture.bus().dispatch(1);
+    fixture.bus().dispatch(2);
+    fixture.bus().dispatch();
+    ISIC_CHECK(fixture.log().types == (std::vector{EventType::MqttDisconnected, EventType::MqttPublishRequest,
+                                                   EventType::ConfigError, EventType::CardScanned}));
+    ISIC_CHECK(fixture.log().increasing());
+}
+
+/// An evicted event leaves the order of the others intact
+void testEviction()
+{
+    Fixture fixture;
+    const auto capacity{kEventTraitsTable[static_cast<std::size_t>(EventType::CardRemoved)].capacity};
+
+    for (std::size_t i{0}; i <= capacity; ++i)
+    {
+        fixture.publish(EventType::CardRemoved);        // DropOldest, capacity 4
+        fixture.publish(EventType::AttendanceRecorded); // Capacity 8, never full here
+    }
+    fixture.bus().dispatch();
+
+    ISIC_CHECK_EQUAL(fixture.bus().droppedCount(EventType::CardRemoved), 1U);
+    ISIC_CHECK_EQUAL(fixture.log().tickets.size(), 2U * capacity + 1);
+    ISIC_CHECK_EQUAL(fixture.log().tickets.front(), 1U); // Ticket 0, the oldest CardRemoved, was evicted
+    ISIC_CHECK(fixture.log().increasing());
+}
+
+/// A coalesced event is delivered in the position of the newest publish
+void testCoalescing()
+{
+    Fixture fixture;
+
+    fixture.publish(EventType::WifiConnected);
+    fixture.publish(EventType::NfcReady);
+    fixture.publish(EventType::WifiDisconnected); // Supersedes the pending WifiConnected
+    fixture.publish(EventType::CardRemoved);
+    fixture.publish(EventType::ConfigChanged);
+    fixture.publish(EventType::ConfigChanged); // Supersedes the first one
+    fixture.bus().dispatch(2);
+    fixture.bus().dispatch();
+
+    ISIC_CHECK(fixture.log().types ==
+               (std::vector{EventType::NfcReady, EventType::WifiDisconnected, EventType::CardRemoved, EventType::ConfigChanged}));
+    ISIC_CHECK(fixture.log().tickets == (std::vector<std::uint32_t>{1, 2, 3, 5}));
+    ISIC_CHECK_EQUAL(fixture.bus().coalescedCount(EventType::WifiDisconnected), 1U);
+    ISIC_CHECK_EQUAL(fixture.bus().coalescedCount(EventType::ConfigChanged), 1U);
+}
+
+/// Events published by a subscriber queue behind everything already pending
+void testPublishFromCallback()
+{
+    Fixture fixture;
+    auto republish{fixture.bus().subscribeScoped(EventType::SystemReady, [fixture = &fixture](const Event &) {
+        fixture->publish(EventType::NfcReady);
+    })};
+
+    fixture.publish(EventType::SystemReady);
+    fixture.publish(EventType::CardRemoved);
+    fixture.publish(EventType::SystemError);
+    fixture.bus().dispatch();
+
+    ISIC_CHECK(fixture.log().types ==
+               (std::vector{EventType::SystemReady, EventType::CardRemoved, EventType::SystemError, EventType::NfcReady}));
+    ISIC_CHECK(fixture.log().increasing());
+}
+} // namespace
+
+int main()
+{
+    testRandomTraffic();
+    testOrderAcrossPriorities();
+    testEviction();
+    testCoalescing();
+    testPublishFromCallback();
+    return isic::test::result();
+}
@@ -0,0 +1,225 @@
+/**
+ * @file PublishStressTest.cpp
+ * @brief Several threads publishing into Signal and EventBus against one dispatching thread
+ *
+ * Built with -fsanitize=thread. Every producer numbers its events; the
+ * subscriber checks that each producer's numbers arrive in order, and the
+ * counters must account for every publish: delivered, or counted as
+ * dropped / blocked by the overflow policy, never missing.
+ */
+
+#include "TestSupport.hpp"
+
+#include "core/EventBus.hpp"
+#include "core/Signal.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using namespace isic;
+
+constexpr std::size_t kProducers{4};
+constexpr std::uint32_t kEventsPerProducer{50000};
+
+/// Runs @p dispatch on its own thread until stop(), then until it delivers nothing more
+class Dispatcher
+{
+public:
+    template<typename Dispatch>
+    explicit Dispatcher(Dispatch dispatch)
+        : m_thread([this, dispatch]() mutable {
+            while (!m_stop.load(std::memory_order_acquire))
+            {
+                dispatch();
+            }
+            while (dispatch() != 0)
+            {
+            }
+        })
+    {
+    }
+
+    void stop()
+    {
+        m_stop.store(true, std::memory_order_release);
+        m_thread.join();
+    }
+
+private:
+    std::atomic<bool> m_stop{false};
+    std::thread m_thread;
+};
+
+/// Per-producer sequence check, only touched on the dispatching thread
+struct OrderCheck
+{
+    std::array<std::int64_t, kProducers> lastSeen{-1, -1, -1, -1};
+    std::uint64_t delivered{0};
+    bool inOrder{true};
+
+    void receive(const std::uint8_t producer, const std::uint32_t sequence)
+    {
+        inOrder = inOrder && static_cast<std::int64_t>(sequence) > lastSeen[producer];
+        lastSeen[producer] = sequence;
+        ++delivered;
+    }
+};
+
+void testSignal()
+{
+    Signal<std::uint8_t, std::uint32_t> signal;
+
+    OrderCheck subscriber;
+    auto connection{signal.connectScoped(
+            [&subscriber](const std::uint8_t producer, const std::uint32_t sequence) { subscriber.receive(producer, sequence); })};
+
+    std::atomic<std::uint64_t> accepted{0};
+    std::atomic<std::uint64_t> rejected{0};
+    Dispatcher dispatcher{[&signal]() { return signal.dispatch(); }};
+
+    std::vector<std::thread> producers;
+    for (std::size_t producer{0}; producer < kProducers; ++producer)
+    {
+        producers.emplace_back([&, producer]() {
+            for (std::uint32_t sequence{0}; sequence < kEventsPerProducer; ++sequence)
+            {
+                auto &counter{signal.publish(static_cast<std::uint8_t>(producer), sequence) ? accepted : rejected};
+                counter.fetch_add(1, std::memory_order_relaxed);
+                if (sequence % 64 == 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &thread: producers)
+    {
+        thread.join();
+    }
+    dispatcher.stop();
+
+    ISIC_CHECK(subscriber.inOrder);
+    ISIC_CHECK_EQUAL(signal.pendingCount(), 0U);
+    ISIC_CHECK_EQUAL(accepted.load() + rejected.load(), std::uint64_t{kProducers} * kEventsPerProducer);
+    ISIC_CHECK_EQUAL(subscriber.delivered + signal.droppedCount(), accepted.load());
+    ISIC_CHECK(subscriber.delivered > 0);
+}
+
+/// Publish-side tallies of one producer for one event type
+struct Tally
+{
+    std::uint32_t attempts{0};
+    std::uint32_t accepted{0};
+    std::uint32_t refused{0};
+};
+
+void testEventBus()
+{
+    // One type per overflow policy that can refuse or lose events
+    constexpr std::array<EventType, 3> kTypes{EventType::CardScanned,  // BlockWithError: retried until accepted
+                                              EventType::CardRemoved,  // DropOldest
+                                              EventType::MqttMessage}; // RejectNewest
+
+    EventBus bus;
+    std::array<OrderCheck, kTypes.size()> subscribers{};
+    std::vector<EventBus::ScopedConnection> connections;
+    for (std::size_t slot{0}; slot < kTypes.size(); ++slot)
+    {
+        connections.push_back(bus.subscribeScoped(kTypes[slot], [subscriber = &subscribers[slot]](const Event &event) {
+            const auto *card{event.get<CardEvent>()};
+            subscriber->receive(card->uid[0], card->timestampMs);
+        }));
+    }
+
+    std::array<std::array<Tally, kTypes.size()>, kProducers> tallies{};
+    Dispatcher dispatcher{[&bus]() { return bus.dispatch(8); }};
+
+    std::vector<std::thread> producers;
+    for (std::size_t producer{0}; producer < kProducers; ++producer)
+    {
+        producers.emplace_back([&, producer]() {
+            for (std::uint32_t sequence{0}; sequence < kEventsPerProducer / 4; ++sequence)
+            {
+                const auto slot{(sequence + producer) % kTypes.size()};
+                auto &tally{tallies[producer][slot]};
+                CardEvent card{};
+                card.timestampMs = sequence;
+                card.uid[0] = static_cast<std::uint8_t>(producer);
+
+                ++tally.attempts;
+                Event event{kTypes[slot], card};
+                while (true)
+                {
+                    // A refused event is left intact, so it can be published again
+                    if (bus.publish(std::move(event)))
+                    {
+                        ++tally.accepted;
+                        break;
+                    }
+                    ++tally.refused;
+                    if (kTypes[slot] != EventType::CardScanned)
+                    {
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &thread: producers)
+    {
+        thread.join();
+    }
+    dispatcher.stop();
+
+    ISIC_CHECK_EQUAL(bus.pendingCount(), 0U);
+
+    for (std::size_t slot{0}; slot < kTypes.size(); ++slot)
+    {
+        Tally total{};
+        for (const auto &perProducer: tallies)
+        {
+            total.attempts += perProducer[slot].attempts;
+            total.accepted += perProducer[slot].accepted;
+            total.refused += perProducer[slot].refused;
+        }
+        const auto metrics{bus.getTypeMetrics(kTypes[slot])};
+        const auto delivered{subscribers[slot].delivered};
+
+        ISIC_CHECK(subscribers[slot].inOrder);
+
+        ISIC_CHECK_EQUAL(metrics.dispatched, delivered);
+        ISIC_CHECK_EQUAL(metrics.published, total.accepted);
+        switch (kTypes[slot])
+        {
+            case EventType::CardScanned:
+                // Every scan eventually gets in and out: refusals are counted, nothing is dropped
+                ISIC_CHECK_EQUAL(delivered, total.attempts);
+                ISIC_CHECK_EQUAL(metrics.blocked, total.refused);
+                ISIC_CHECK_EQUAL(metrics.dropped, 0U);
+                break;
+            case EventType::CardRemoved:
+                // Evictions and refusals on an exhausted pool both count as dropped
+                ISIC_CHECK_EQUAL(delivered + metrics.dropped, total.attempts);
+                break;
+            default:
+                ISIC_CHECK_EQUAL(delivered, total.accepted);
+                ISIC_CHECK_EQUAL(metrics.dropped, total.refused);
+                ISIC_CHECK_EQUAL(total.accepted + total.refused, total.attempts);
+                break;
+        }
+    }
+}
+} // namespace
+
+int main()
+{
+    testSignal();
+    testEventBus();
+    return isic::test::result();
+}
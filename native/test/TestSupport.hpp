@@ -0,0 +1,63 @@
+#ifndef ISIC_NATIVE_TEST_TEST_SUPPORT_HPP
+#define ISIC_NATIVE_TEST_TEST_SUPPORT_HPP
+
+/**
+ * @file TestSupport.hpp
+ * @brief Checks for the host tests (one executable per file, run by ctest)
+ *
+ * A failed check prints where it failed and carries on, so one run reports
+ * every broken expectation. main() ends with `return isic::test::result();`,
+ * non-zero when anything failed.
+ */
+
+#include <cstdio>
+#include <iostream>
+
+namespace isic::test
+{
+inline int &failureCount()
+{
+    static int failures{0};
+    return failures;
+}
+
+inline bool check(const bool passed, const char *expression, const char *file, const int line)
+{
+    if (!passed)
+    {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+        ++failureCount();
+    }
+    return passed;
+}
+
+template<typename Actual, typename Expected>
+bool checkEqual(const Actual &actual, const Expected &expected, const char *expression, const char *file, const int line)
+{
+    if (!(actual == expected))
+    {
+        std::cerr << file << ':' << line << ": check failed: " << expression << " (got " << +actual << ", expected " << +expected
+                  << ")\n";
+        ++failureCount();
+        return false;
+    }
+    return true;
+}
+
+/// Exit status for main()
+inline int result()
+{
+    if (failureCount() != 0)
+    {
+        std::fprintf(stderr, "%d check(s) failed\n", failureCount());
+        return 1;
+    }
+    return 0;
+}
+} // namespace isic::test
+
+#define ISIC_CHECK(expression) ::isic::test::check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+#define ISIC_CHECK_EQUAL(actual, expected) \
+    ::isic::test::checkEqual((actual), (expected), #actual " == " #expected, __FILE__, __LINE__)
+
+#endif // ISIC_NATIVE_TEST_TEST_SUPPORT_HPP
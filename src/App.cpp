@@ -3,6 +3,7 @@
 #include <TaskScheduler.h>
 
 #include "common/Logger.hpp"
+#include "core/Trace.hpp"
 
 namespace isic
 {
@@ -10,15 +11,18 @@ constexpr auto *TAG{"App"};
 
 App::App()
     : m_webServer(80)
-    , m_configService(m_eventBus)
+    , m_configService(m_eventBus, m_topicRouter)
     , m_wifiService(m_eventBus, m_configService, m_webServer)
-    , m_mqttService(m_eventBus, m_configService.get().mqtt, m_configService.get().device)
-    , m_otaService(m_eventBus, m_configService.get().ota)
+    , m_mqttService(m_eventBus, m_topicRouter, m_configService.get().mqtt, m_configService.get().device)
+    , m_otaService(m_eventBus, m_topicRouter, m_configService.get().ota)
     , m_pn532Service(m_eventBus, m_configService)
     , m_attendanceService(m_eventBus, m_configService.getMutable().attendance)
     , m_feedbackService(m_eventBus, m_configService.getMutable().feedback)
-    , m_healthService(m_eventBus, m_configService.getMutable().health)
-    , m_powerService(m_eventBus, m_configService.getMutable().power)
+    , m_healthService(m_eventBus, m_topicRouter, m_configService.getMutable().health)
+    , m_powerService(m_eventBus, m_topicRouter, m_configService.getMutable().power)
+#ifdef ISIC_ENABLE_EVENT_JOURNAL
+    , m_journalRecorder(m_eventBus, m_topicRouter)
+#endif
 {
     LOG_INFO(TAG, "ISIC Attendance System");
     LOG_INFO(TAG, "Firmware: %s", DeviceConfig::Constants::kFirmwareVersion);
@@ -38,6 +42,11 @@ Status App::begin()
         return status;
     }
 
+#ifdef ISIC_ENABLE_EVENT_JOURNAL
+    // LittleFS is mounted now; recording from boot captures the initial connects
+    m_journalRecorder.begin();
+#endif
+
     // // Initialize OTA early (before WiFi) so routes are registered before web server starts
     // status = m_otaService.begin();
     // if (status.failed())
@@ -115,6 +124,7 @@ Status App::begin()
     m_healthService.registerComponent(&m_powerService);
     m_healthService.registerComponent(&m_feedbackService);
     m_healthService.registerComponent(&m_otaService);
+    m_healthService.registerComponent(&m_eventBus);
     // Start web server after all services have registered their routes
     startWebServer();
 
@@ -135,9 +145,16 @@ void App::loop()
         return;
     }
 
-    // Execute scheduler (includes automatic EventBus dispatch at 100Hz)
+    // Execute scheduler (includes EventBus dispatch while events are pending)
     m_scheduler.execute();
 
+    // Wake the idle dispatch task as soon as anything was published (ISR/other tasks included)
+    // or a bus timer is due
+    if (m_eventBus.takeWakeRequest() || m_eventBus.msUntilNextTimer() == 0)
+    {
+        m_eventBusTask.enableIfNot();
+    }
+
     // Yield to system
     yield();
 }
@@ -148,22 +165,36 @@ void App::loop()
 
 void App::setupScheduler()
 {
-    // EventBus dispatch task - CRITICAL: Runs at 100Hz (every 10ms)
+    // EventBus dispatch task - CRITICAL: Runs only while events are pending
     //
     // This task processes ALL async events for the entire system.
-    // All services publish events which are queued in ring buffers,
-    // then this task dispatches them to subscribers.
+    // All services publish events which are queued in the shared event pool,
+    // then this task dispatches them to subscribers, highest priority first.
     //
     // Priority: HIGHEST - must run before other tasks to ensure timely delivery
-    // Frequency: 100Hz - fast enough for real-time responsiveness
-    // Overhead: ~10-50μs per call (depends on pending event count)
+    // Wakeup: disabled once the queues are empty, re-enabled by loop() on the
+    //         next scheduler pass after a publish or when a bus timer is due -
+    //         no idle 100Hz polling, and an event no longer waits for the next
+    //         10ms slot
+    // Budget: bounded per tick so bursts (metrics, config) cannot starve the
+    //         PN532 task; leftovers are delivered EVENTBUS_INTERVAL_MS later
     m_eventBusTask.set(EVENTBUS_INTERVAL_MS, TASK_FOREVER, [this]() {
-        std::size_t dispatched = m_eventBus.dispatch();
+        ISIC_TRACE_TASK(EventBus);
+        std::size_t dispatched = m_eventBus.dispatch(EVENTBUS_MAX_EVENTS_PER_TICK, EVENTBUS_BUDGET_US);
         (void) dispatched; // Suppress unused variable warning
+
+        // Sleep until the next publish. Consume the flag before the emptiness check: an event
+        // whose flag is taken here is already counted, anything later raises it again
+        (void) m_eventBus.takeWakeRequest();
+        if (m_eventBus.pendingCount() == 0)
+        {
+            m_eventBusTask.disable();
+            return;
+        }
 #ifdef ISIC_DEBUG
         // Monitor event bus saturation (debug builds only)
         std::size_t pending = m_eventBus.pendingCount();
-        if (dispatched > 10 || pending > 8)
+        if (pending > 8)
         {
             LOG_WARN(TAG, "EventBus high load: dispatched=%u, pending=%u",
                      dispatched, pending);
@@ -175,6 +206,7 @@ void App::setupScheduler()
 
     // ConfigService task - low frequency
     m_configTask.set(CONFIG_INTERVAL_MS, TASK_FOREVER, [this]() {
+        ISIC_TRACE_TASK(Config);
         m_configService.loop();
     });
     m_scheduler.addTask(m_configTask);
@@ -182,6 +214,7 @@ void App::setupScheduler()
 
     // WiFiService task
     m_wifiTask.set(WIFI_INTERVAL_MS, TASK_FOREVER, [this]() {
+        ISIC_TRACE_TASK(WiFi);
         m_wifiService.loop();
     });
     m_scheduler.addTask(m_wifiTask);
@@ -189,6 +222,7 @@ void App::setupScheduler()
 
     // MqttService task
     m_mqttTask.set(MQTT_INTERVAL_MS, TASK_FOREVER, [this]() {
+        ISIC_TRACE_TASK(Mqtt);
         m_mqttService.loop();
     });
     m_scheduler.addTask(m_mqttTask);
@@ -196,34 +230,26 @@ void App::setupScheduler()
 
     // Pn532Service task - high frequency for responsive card reading
     m_pn532Task.set(PN532_INTERVAL_MS, TASK_FOREVER, [this]() {
+        ISIC_TRACE_TASK(Pn532);
         m_pn532Service.loop();
     });
     m_scheduler.addTask(m_pn532Task);
     m_pn532Task.enable();
 
-    // AttendanceService task
-    m_attendanceTask.set(ATTENDANCE_INTERVAL_MS, TASK_FOREVER, [this]() {
-        m_attendanceService.loop();
-    });
-    m_scheduler.addTask(m_attendanceTask);
-    m_attendanceTask.enable();
-
     // FeedbackService task - high frequency for smooth LED/buzzer patterns
     m_feedbackTask.set(FEEDBACK_INTERVAL_MS, TASK_FOREVER, [this]() {
+        ISIC_TRACE_TASK(Feedback);
         m_feedbackService.loop();
     });
     m_scheduler.addTask(m_feedbackTask);
     m_feedbackTask.enable();
 
-    // HealthService task - low frequency
-    m_healthTask.set(HEALTH_INTERVAL_MS, TASK_FOREVER, [this]() {
-        m_healthService.loop();
-    });
-    m_scheduler.addTask(m_healthTask);
-    m_healthTask.enable();
+    // AttendanceService and HealthService have no task: batch flushes, offline
+    // retries, health checks and publishes are EventBus timers
 
     // OtaService task
     m_otaTask.set(OTA_INTERVAL_MS, TASK_FOREVER, [this]() {
+        ISIC_TRACE_TASK(Ota);
         m_otaService.loop();
     });
     m_scheduler.addTask(m_otaTask);
@@ -231,12 +257,13 @@ void App::setupScheduler()
 
     // PowerService task
     m_powerTask.set(POWER_INTERVAL_MS, TASK_FOREVER, [this]() {
+        ISIC_TRACE_TASK(Power);
         m_powerService.loop();
     });
     m_scheduler.addTask(m_powerTask);
     m_powerTask.enable();
 
-    LOG_DEBUG(TAG, "Scheduler configured with %d tasks", 10);
+    LOG_DEBUG(TAG, "Scheduler configured with %d tasks", 8);
 }
 
 void App::startWebServer()
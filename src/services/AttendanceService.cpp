@@ -3,40 +3,199 @@
 #include "common/Logger.hpp"
 #include "platform/PlatformESP.hpp"
 
-#include <ArduinoJson.h>
+#include <Print.h>
+#include <algorithm>
+#include <cstring>
 
 namespace isic
 {
 namespace
 {
-bool hasTimeElapsed(const std::uint32_t startMs, const std::uint32_t nowMs, const std::uint32_t thresholdMs) noexcept
+/// Longest record writeRecordJson() can write: {"uid":"<14 hex>","ts":<20 digits>,"seq":<10 digits>} plus a comma
+constexpr std::size_t kRecordJsonMaxBytes{8 + 2 * kCardUidMaxSize + 7 + 20 + 7 + 10 + 1 + 1};
+
+/// Longest record writeRecordPacked() can write: UID, sequence delta and age varints
+constexpr std::size_t kRecordPackedMaxBytes{kCardUidMaxSize + 5 + 5};
+
+/// Packed format header: version, count varint, base unix time, first sequence varint
+constexpr std::size_t kPackedHeaderMaxBytes{1 + 5 + 8 + 5};
+constexpr std::uint8_t kPackedFormatVersion{1};
+
+/// Stack buffer the batch writers fill before each write to the socket: a few records per TCP write
+constexpr std::size_t kScratchBytes{256};
+static_assert(kScratchBytes >= kRecordJsonMaxBytes + 1 && kScratchBytes >= kPackedHeaderMaxBytes,
+              "Scratch must hold the largest piece written at once");
+
+/// Records per offline publish: even worst-case records stay within kMaxPayloadSizeBytes
+constexpr std::size_t offlineChunkRecords(const AttendanceConfig::PayloadFormat format)
 {
-    return (nowMs - startMs) >= thresholdMs;
+    return format == AttendanceConfig::PayloadFormat::Packed
+                   ? (MqttConfig::Constants::kMaxPayloadSizeBytes - kPackedHeaderMaxBytes) / kRecordPackedMaxBytes
+                   : (MqttConfig::Constants::kMaxPayloadSizeBytes - 2) / kRecordJsonMaxBytes;
 }
+static_assert(offlineChunkRecords(AttendanceConfig::PayloadFormat::Json) > 0, "MQTT payload too small for one attendance record");
+
+/**
+ * What packBatch() puts in front of the records: taken once per batch so the
+ * measuring and the writing pass of a PayloadWriter see the same values
+ */
+struct PackedBatchHeader
+{
+    std::uint64_t unixMs{0};       ///< Unix time at packing, 0 if the clock is not set
+    std::uint32_t packedAtMs{0};   ///< millis() at packing, for the records' age
+    std::uint32_t bootSequence{0}; ///< Records up to this sequence were taken before this boot
+};
+
+/// Header and records of a packBatch() block; the records sit unaligned, so each is copied out
+class PackedBatch
+{
+public:
+    explicit PackedBatch(const std::string_view packed)
+        : m_packed(packed)
+    {
+        if (packed.size() >= sizeof(m_header))
+        {
+            std::memcpy(&m_header, packed.data(), sizeof(m_header));
+            m_count = (packed.size() - sizeof(m_header)) / sizeof(AttendanceRecord);
+        }
+    }
+
+    [[nodiscard]] const PackedBatchHeader &header() const
+    {
+        return m_header;
+    }
 
-void serializeRecord(const JsonObject &obj, const AttendanceRecord &record)
+    [[nodiscard]] std::size_t size() const
+    {
+        return m_count;
+    }
+
+    [[nodiscard]] AttendanceRecord operator[](const std::size_t index) const
+    {
+        AttendanceRecord record{};
+        std::memcpy(&record, m_packed.data() + sizeof(m_header) + index * sizeof(AttendanceRecord), sizeof(record));
+        return record;
+    }
+
+private:
+    std::string_view m_packed;
+    PackedBatchHeader m_header{};
+    std::size_t m_count{0};
+};
+
+/// Fills a stack buffer and hands it to @p out whenever the next piece might not fit; with no @p out it only counts
+class ScratchWriter
 {
-    const auto unixMs{platform::getUnixTimeMs()};
-    obj["uid"] = cardUidToString(record.cardUid);
-    obj["ts"] = unixMs.value_or(0); // TODO: handle missing unix time, for now set to 0 backend must handle it
-    obj["seq"] = record.sequence;
+public:
+    explicit ScratchWriter(Print *out)
+        : m_out(out)
+    {
+    }
+
+    /// Where to write at most @p bytes; pass the end of what was written to commit()
+    [[nodiscard]] char *reserve(const std::size_t bytes)
+    {
+        if (static_cast<std::size_t>(m_buffer + kScratchBytes - m_cursor) < bytes)
+        {
+            drain();
+        }
+        return m_cursor;
+    }
+
+    void commit(char *end)
+    {
+        m_cursor = end;
+    }
+
+    /// @return Bytes handed to the client (or counted)
+    std::size_t finish()
+    {
+        drain();
+        return m_total;
+    }
+
+private:
+    void drain()
+    {
+        const auto length{static_cast<std::size_t>(m_cursor - m_buffer)};
+        m_total += m_out != nullptr ? m_out->write(reinterpret_cast<const std::uint8_t *>(m_buffer), length) : length;
+        m_cursor = m_buffer;
+    }
+
+    Print *m_out;
+    char m_buffer[kScratchBytes];
+    char *m_cursor{m_buffer};
+    std::size_t m_total{0};
+};
+
+char *appendText(char *out, const char *text)
+{
+    const auto length{std::strlen(text)};
+    std::memcpy(out, text, length);
+    return out + length;
 }
 
-std::string serializeBatch(const std::vector<AttendanceRecord> &records)
+char *appendUnsigned(char *out, std::uint64_t value)
 {
-    JsonDocument doc;
-    const auto arr{doc.to<JsonArray>()};
+    char digits[20];
+    std::size_t count{0};
+    do
+    {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (count != 0)
+    {
+        *out++ = digits[--count];
+    }
+    return out;
+}
 
-    for (const auto &record: records)
+/// LEB128: 7 bits per byte, low group first, high bit set on all but the last
+char *appendVarint(char *out, std::uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        *out++ = static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<char>(value);
+    return out;
+}
+
+/// Same text ArduinoJson produced for {"uid":..., "ts":..., "seq":...}, without building a document
+char *writeRecordJson(char *out, const AttendanceRecord &record, const std::uint64_t unixMs)
+{
+    static constexpr char kHexChars[]{"0123456789ABCDEF"};
+
+    out = appendText(out, "{\"uid\":\"");
+    // Reverse byte order, as cardUidToString()
+    for (auto i{kCardUidMaxSize}; i > 0; --i)
     {
-        serializeRecord(arr.add<JsonObject>(), record);
+        *out++ = kHexChars[(record.cardUid[i - 1] >> 4) & 0x0F];
+        *out++ = kHexChars[record.cardUid[i - 1] & 0x0F];
     }
+    out = appendText(out, "\",\"ts\":");
+    out = appendUnsigned(out, unixMs);
+    out = appendText(out, ",\"seq\":");
+    out = appendUnsigned(out, record.sequence);
+    *out++ = '}';
+    return out;
+}
+
+/// UID bytes as read, zigzag(sequence - expected), age + 1 (0: taken before this boot, age unknown)
+char *writeRecordPacked(char *out, const AttendanceRecord &record, const std::uint32_t expectedSequence,
+                        const PackedBatchHeader &header)
+{
+    std::memcpy(out, record.cardUid.data(), kCardUidMaxSize);
+    out += kCardUidMaxSize;
 
-    std::string json;
-    json.reserve(measureJson(doc) + 1);
-    serializeJson(doc, json);
+    const auto delta{static_cast<std::int32_t>(record.sequence - expectedSequence)};
+    out = appendVarint(out, (static_cast<std::uint32_t>(delta) << 1) ^ static_cast<std::uint32_t>(delta >> 31));
 
-    return json; // NRVO must apply
+    const auto thisBoot{record.sequence > header.bootSequence};
+    const auto ageMs{header.packedAtMs - record.timestampMs};
+    return appendVarint(out, thisBoot && ageMs != UINT32_MAX ? ageMs + 1 : 0);
 }
 } // namespace
 
@@ -48,19 +207,43 @@ AttendanceService::AttendanceService(EventBus &bus, const AttendanceConfig &conf
     m_batch.reserve(m_config.batchMaxSize);
     m_offlineBatch.reserve(m_config.offlineBufferSize);
 
-    m_eventConnections.reserve(4);
-    m_eventConnections.push_back(m_bus.subscribeScoped(EventType::CardScanned, [this](const Event &e) {
-        if (const auto *card = e.get<CardEvent>())
-        {
-            processCard(*card);
-        }
-    }));
+    m_eventConnections.reserve(8);
+    // Direct: the tap is processed inside Pn532Service's publish, not a bus tick later
+    m_eventConnections.push_back(m_bus.subscribeScoped(
+            EventType::CardScanned, [this](const Event &e) {
+                if (const auto *card = e.get<CardEvent>())
+                {
+                    processCard(*card);
+                }
+            },
+            ConnectionMode::Direct));
     m_eventConnections.push_back(m_bus.subscribeScoped(EventType::MqttConnected, [this](const Event & /*e*/) {
         m_useOfflineMode = false;
         flushOfflineBatch();
     }));
     m_eventConnections.push_back(m_bus.subscribeScoped(EventType::MqttDisconnected, [this](const Event & /*e*/) {
         m_useOfflineMode = true;
+        releaseChunk();
+        m_drainStartMs = 0; // An interrupted drain says nothing about throughput
+    }));
+    m_eventConnections.push_back(m_bus.subscribeScoped(EventType::MqttPublished, [this](const Event &e) {
+        if (const auto *mqtt = e.get<MqttEvent>())
+        {
+            onChunkReceipt(*mqtt, true);
+        }
+    }));
+    m_eventConnections.push_back(m_bus.subscribeScoped(EventType::MqttPublishFailed, [this](const Event &e) {
+        if (const auto *mqtt = e.get<MqttEvent>())
+        {
+            onChunkReceipt(*mqtt, false);
+        }
+    }));
+    // Deep sleep and hibernation lose RAM: put the pending write batch on flash first
+    m_eventConnections.push_back(m_bus.subscribeScoped(EventType::SleepRequested, [this](const Event & /*e*/) {
+        if (m_journalReady)
+        {
+            m_journal.flush();
+        }
     }));
 
     m_eventConnections.push_back(m_bus.subscribeScoped(EventType::ConfigChanged, [this](const Event /*e*/) {
@@ -74,41 +257,36 @@ AttendanceService::AttendanceService(EventBus &bus, const AttendanceConfig &conf
 Status AttendanceService::begin()
 {
     setState(ServiceState::Initializing);
-    LOG_INFO(m_name, "Init: batch=%u, offline=%u, debounce=%ums", m_config.batchMaxSize, m_config.offlineBufferSize, m_config.debounceIntervalMs);
-    setState(ServiceState::Running);
-    return Status::Ok();
-}
-
-void AttendanceService::loop()
-{
-    // Only loop if service is in Running state
-    if (m_state != ServiceState::Running)
+    if (!m_debounceTable.reset(m_config.debounceCacheSize))
     {
-        return;
+        // Not fatal: the previous table (none at first boot, so no debounce) stays in use
+        LOG_ERROR(m_name, "No memory for a %u-card debounce table, keeping %u", m_config.debounceCacheSize,
+                  static_cast<unsigned>(m_debounceTable.capacity()));
+        ++m_metrics.errorCount;
     }
 
-    const auto now{millis()};
-
-    // Check batch flush conditions (only if batch has data)
-    if (!m_batch.empty())
+    m_journalReady = m_config.journalEnabled && m_journal.begin(m_config.journalMaxRecords);
+    if (m_journalReady)
     {
-        const bool batchFull{m_batch.size() >= m_config.batchMaxSize};
-        const bool batchTimeout{hasTimeElapsed(m_batchStartMs, now, m_config.batchFlushIntervalMs)};
-
-        if (batchFull || batchTimeout)
-        {
-            flushBatch();
-        }
+        // Keep numbering after the records still waiting from the previous boot
+        m_sequenceNumber = std::max(m_sequenceNumber, m_journal.lastSequence());
     }
-
-    if (!m_offlineBatch.empty() && !m_useOfflineMode)
+    else if (m_config.journalEnabled)
     {
-        if (hasTimeElapsed(m_lastOfflineRetryMs, now, m_config.offlineBufferFlushIntervalMs))
-        {
-            flushOfflineBatch();
-            m_lastOfflineRetryMs = now;
-        }
+        LOG_WARN(m_name, "Journal unavailable, buffering offline records in RAM");
     }
+    m_bootSequence = m_sequenceNumber;
+
+    LOG_INFO(m_name, "Init: batch=%u, offline=%u%s, debounce=%ums x %u cards", m_config.batchMaxSize,
+             m_journalReady ? static_cast<unsigned>(m_config.journalMaxRecords) : m_config.offlineBufferSize,
+             m_journalReady ? " (journal)" : "", m_config.debounceIntervalMs, static_cast<unsigned>(m_debounceTable.capacity()));
+    setState(ServiceState::Running);
+    return Status::Ok();
+}
+
+void AttendanceService::loop()
+{
+    // Nothing to poll: flushes run from EventBus timers armed when records arrive
 }
 
 void AttendanceService::end()
@@ -117,6 +295,13 @@ void AttendanceService::end()
     LOG_INFO(m_name, "Shutting down...");
 
     flush();
+    if (m_journalReady)
+    {
+        m_journal.flush();
+    }
+    m_bus.cancelTimer(m_batchFlushTimer);
+    m_bus.cancelTimer(m_offlineRetryTimer);
+    m_bus.cancelTimer(m_journalFlushTimer);
     m_eventConnections.clear();
 
     setState(ServiceState::Stopped);
@@ -149,38 +334,95 @@ void AttendanceService::processCard(const CardEvent &card)
     ++m_metrics.cardsProcessed;
 
     addToBatch(record);
+
+    // Feedback first: with a Direct subscriber this beeps before the (possibly slow) flush
+    m_bus.publish(EventType::AttendanceRecorded);
+
     if (!m_config.batchingEnabled)
     {
         flushBatch();
     }
-
-    m_bus.publish(EventType::AttendanceRecorded);
 }
 
 bool AttendanceService::shouldProcessCard(const CardUid &cardUid, const std::uint32_t timestampMs) noexcept
 {
-    // Search for existing entry and update in-place if found
-    for (auto &[uid, lastSeenMs]: m_debounceCache)
+    return m_debounceTable.admit(cardUid, timestampMs, m_config.debounceIntervalMs);
+}
+
+PayloadBuffer AttendanceService::packBatch(const std::vector<AttendanceRecord> &records, const std::uint32_t bootSequence)
+{
+    const auto bytes{records.size() * sizeof(AttendanceRecord)};
+    auto payload{PayloadBuffer::allocate(sizeof(PackedBatchHeader) + bytes)};
+    if (payload.capacity() == 0)
     {
-        if ((lastSeenMs != 0) && (uid == cardUid))
+        return payload;
+    }
+
+    // TODO: handle missing unix time, for now set to 0 backend must handle it
+    const PackedBatchHeader header{platform::getUnixTimeMs().value_or(0), static_cast<std::uint32_t>(millis()), bootSequence};
+    std::memcpy(payload.data(), &header, sizeof(header));
+    if (bytes != 0)
+    {
+        std::memcpy(payload.data() + sizeof(header), records.data(), bytes);
+    }
+    payload.resize(sizeof(header) + bytes);
+    return payload;
+}
+
+std::size_t AttendanceService::writeBatchJson(const std::string_view packed, Print *out)
+{
+    const PackedBatch batch{packed};
+    ScratchWriter writer{out};
+
+    auto *cursor{writer.reserve(1)};
+    *cursor++ = '[';
+    writer.commit(cursor);
+    for (std::size_t i{0}; i < batch.size(); ++i)
+    {
+        cursor = writer.reserve(kRecordJsonMaxBytes);
+        if (i != 0)
         {
-            if (!hasTimeElapsed(lastSeenMs, timestampMs, m_config.debounceIntervalMs))
-            {
-                return false; // Still in debounce window
-            }
-            // Expired - update timestamp in-place and allow
-            lastSeenMs = timestampMs;
-            return true;
+            *cursor++ = ',';
         }
+        writer.commit(writeRecordJson(cursor, batch[i], batch.header().unixMs));
+    }
+    cursor = writer.reserve(1);
+    *cursor++ = ']';
+    writer.commit(cursor);
+    return writer.finish();
+}
+
+std::size_t AttendanceService::writeBatchPacked(const std::string_view packed, Print *out)
+{
+    const PackedBatch batch{packed};
+    ScratchWriter writer{out};
+
+    const auto firstSequence{batch.size() != 0 ? batch[0].sequence : 0};
+    auto *cursor{writer.reserve(kPackedHeaderMaxBytes)};
+    *cursor++ = static_cast<char>(kPackedFormatVersion);
+    cursor = appendVarint(cursor, static_cast<std::uint32_t>(batch.size()));
+    for (std::size_t i{0}; i < 8; ++i)
+    {
+        *cursor++ = static_cast<char>(batch.header().unixMs >> (8 * i));
     }
+    writer.commit(appendVarint(cursor, firstSequence));
 
-    // Not found - add new entry using ring buffer eviction
-    auto &entry{m_debounceCache[m_debounceCacheIndex]};
-    entry.uid = cardUid;
-    entry.lastSeenMs = timestampMs;
+    auto expected{firstSequence};
+    for (std::size_t i{0}; i < batch.size(); ++i)
+    {
+        const auto record{batch[i]};
+        writer.commit(writeRecordPacked(writer.reserve(kRecordPackedMaxBytes), record, expected, batch.header()));
+        expected = record.sequence + 1;
+    }
+    return writer.finish();
+}
 
-    m_debounceCacheIndex = static_cast<std::uint8_t>((m_debounceCacheIndex + 1) % AttendanceConfig::Constants::kDebounceCacheSize);
-    return true;
+bool AttendanceService::publishBatch(const PayloadBuffer &packed, const bool confirm)
+{
+    const auto packedFormat{m_config.payloadFormat == AttendanceConfig::PayloadFormat::Packed};
+    return m_bus.publish(Event{EventType::MqttPublishRequest,
+                               MqttEvent{packedFormat ? "attendance/packed" : "attendance", packed, false, confirm,
+                                         packedFormat ? &writeBatchPacked : &writeBatchJson}});
 }
 
 void AttendanceService::addToBatch(const AttendanceRecord &record)
@@ -188,11 +430,10 @@ void AttendanceService::addToBatch(const AttendanceRecord &record)
     // Fast path: batch has room
     if (m_batch.size() < m_config.batchMaxSize)
     {
-        if (m_batch.empty())
-        {
-            m_batchStartMs = millis();
-        }
         m_batch.push_back(record);
+
+        // Full: flush on the next dispatch, after this tap's feedback; otherwise when the interval runs out
+        armBatchFlush(m_batch.size() >= m_config.batchMaxSize ? 0 : m_config.batchFlushIntervalMs);
         return;
     }
 
@@ -202,8 +443,8 @@ void AttendanceService::addToBatch(const AttendanceRecord &record)
 
     if (m_batch.size() < m_config.batchMaxSize)
     {
-        m_batchStartMs = millis();
         m_batch.push_back(record);
+        armBatchFlush(m_config.batchFlushIntervalMs);
     }
     else
     {
@@ -227,22 +468,87 @@ void AttendanceService::flushBatch()
             addToOfflineBatch(record);
         }
         m_batch.clear();
+        m_bus.cancelTimer(m_batchFlushTimer);
         return;
     }
 
-    // Online mode: serialize and publish
-    const auto recordCount{m_batch.size()};
-    auto json{serializeBatch(m_batch)};
+    // Online with a journal backlog: queue behind it so the backend still sees records in order
+    if (m_journalReady && !m_journal.empty())
+    {
+        for (const auto &record: m_batch)
+        {
+            addToJournal(record);
+        }
+        m_batch.clear();
+        m_bus.cancelTimer(m_batchFlushTimer);
+        flushOfflineBatch();
+        return;
+    }
 
-    LOG_INFO(m_name, "Flush: %u records, %u bytes", recordCount, json.length());
-    m_bus.publish(Event{EventType::MqttPublishRequest, MqttEvent{"attendance", std::move(json), false}});
+    // One publish in flight at a time: its receipt flushes what gathered here meanwhile
+    if (!m_chunkPayload.empty())
+    {
+        return;
+    }
 
-    ++m_metrics.batchesSent;
-    m_batch.clear();
+    // Online mode: serialize and publish, at most one batch: records handed back by releaseChunk() can make it longer
+    const auto recordCount{std::min<std::size_t>(m_batch.size(), std::max<std::size_t>(m_config.batchMaxSize, 1))};
+    m_chunkRecords.assign(m_batch.begin(), m_batch.begin() + static_cast<std::ptrdiff_t>(recordCount));
+    auto packed{packBatch(m_chunkRecords, m_bootSequence)};
+    if (packed.empty())
+    {
+        // Keep the records, the next flush retries
+        LOG_ERROR(m_name, "Flush: no buffer for %u records", recordCount);
+        ++m_metrics.errorCount;
+        m_chunkRecords.clear();
+        armBatchFlush(m_config.batchFlushIntervalMs);
+        return;
+    }
+
+    LOG_INFO(m_name, "Flush: %u records", recordCount);
+    m_batch.erase(m_batch.begin(), m_batch.begin() + static_cast<std::ptrdiff_t>(recordCount));
+    m_bus.cancelTimer(m_batchFlushTimer);
+
+    // Held as the chunk in flight until MqttPublished: the request queue may evict it, the socket may fail it
+    m_chunkPayload = packed;
+    m_chunkFromBatch = true;
+    if (!publishBatch(packed, true))
+    {
+        LOG_WARN(m_name, "Flush: publish refused, keeping %u records", recordCount);
+        ++m_metrics.errorCount;
+        releaseChunk();
+        return;
+    }
+    armOfflineRetry();
+}
+
+void AttendanceService::armBatchFlush(const std::uint32_t delayMs)
+{
+    // An immediate flush overrides the pending interval; otherwise keep the deadline of the oldest record
+    if (delayMs == 0)
+    {
+        m_bus.cancelTimer(m_batchFlushTimer);
+    }
+    if (!m_bus.isTimerArmed(m_batchFlushTimer))
+    {
+        m_batchFlushTimer = m_bus.callAfter(delayMs, [this]() { flushBatch(); });
+    }
 }
 
 void AttendanceService::addToOfflineBatch(const AttendanceRecord &record)
 {
+    // Only a full online batch lands here while connected: retry it on the offline interval
+    if (!m_useOfflineMode)
+    {
+        armOfflineRetry();
+    }
+
+    if (m_journalReady)
+    {
+        addToJournal(record);
+        return;
+    }
+
     // Fast path: buffer has room
     if (m_offlineBatch.size() < m_config.offlineBufferSize)
     {
@@ -252,6 +558,11 @@ void AttendanceService::addToOfflineBatch(const AttendanceRecord &record)
 
     ++m_metrics.errorCount; // Count as error because we couldn't send it, add data loss
 
+    if (m_config.offlineQueuePolicy != AttendanceConfig::OfflineQueuePolicy::DropNewest && !m_chunkFromBatch)
+    {
+        clearChunk(); // The chunk in flight starts at the front we are about to drop
+    }
+
     // Slow path: buffer is full - apply policy
     switch (m_config.offlineQueuePolicy)
     {
@@ -284,18 +595,191 @@ void AttendanceService::addToOfflineBatch(const AttendanceRecord &record)
 
 void AttendanceService::flushOfflineBatch()
 {
-    if (m_offlineBatch.empty() || m_useOfflineMode)
+    // One chunk in flight at a time: the next goes out when this one's receipt comes back
+    if (m_useOfflineMode || !m_chunkPayload.empty() || getOfflineBufferSize() == 0)
     {
         return;
     }
 
-    const auto recordCount{m_offlineBatch.size()};
-    auto json{serializeBatch(m_offlineBatch)};
+    if (m_journalReady)
+    {
+        m_chunkFrames = m_journal.peek(m_chunkRecords, offlineChunkRecords(m_config.payloadFormat));
+        if (m_chunkRecords.empty())
+        {
+            // Only corrupt frames (or an unreadable segment): skip them rather than retry forever
+            LOG_WARN(m_name, "Offline flush: skipping %u unreadable records", m_chunkFrames);
+            m_journal.consume(m_chunkFrames);
+            m_chunkFrames = 0;
+            scheduleNextChunk();
+            return;
+        }
+    }
+    else
+    {
+        const auto count{std::min(m_offlineBatch.size(), offlineChunkRecords(m_config.payloadFormat))};
+        m_chunkRecords.assign(m_offlineBatch.begin(), m_offlineBatch.begin() + static_cast<std::ptrdiff_t>(count));
+        m_chunkFrames = static_cast<std::uint32_t>(count);
+    }
+
+    auto packed{packBatch(m_chunkRecords, m_bootSequence)};
+    if (packed.empty())
+    {
+        // Keep the records, retry on the offline interval (or the next reconnect)
+        LOG_ERROR(m_name, "Offline flush: no buffer for %u records", m_chunkRecords.size());
+        ++m_metrics.errorCount;
+        clearChunk();
+        armOfflineRetry();
+        return;
+    }
+
+    if (m_drainStartMs == 0)
+    {
+        m_drainStartMs = millis() | 1U; // 0 means "not draining"
+        m_drainRecords = 0;
+    }
 
-    LOG_INFO(m_name, "Offline flush: %u records, %u bytes", recordCount, json.length());
-    m_bus.publish(Event{EventType::MqttPublishRequest, MqttEvent{"attendance", std::move(json), false}});
+    LOG_INFO(m_name, "Offline flush: %u of %u records", m_chunkRecords.size(), static_cast<unsigned>(getOfflineBufferSize()));
+    m_chunkPayload = packed;
+    if (!publishBatch(packed, true))
+    {
+        clearChunk();
+    }
+    armOfflineRetry();
+}
 
-    m_offlineBatch.clear();
+void AttendanceService::onChunkReceipt(const MqttEvent &mqtt, const bool published)
+{
+    // Receipts for other publishers, or for a chunk given up on, carry another block
+    if (m_chunkPayload.empty() || mqtt.payload.data() != m_chunkPayload.data())
+    {
+        return;
+    }
+
+    if (!published)
+    {
+        // Nothing removed: the flush resumes from this chunk
+        LOG_WARN(m_name, "Publish failed, keeping %u records", m_chunkRecords.size());
+        releaseChunk();
+        armOfflineRetry();
+        return;
+    }
+
+    // An online batch lived only in the chunk; an offline chunk leaves the journal or RAM buffer now
+    if (!m_chunkFromBatch)
+    {
+        if (m_journalReady)
+        {
+            m_journal.consume(m_chunkFrames);
+        }
+        else
+        {
+            m_offlineBatch.erase(m_offlineBatch.begin(), m_offlineBatch.begin() + static_cast<std::ptrdiff_t>(m_chunkFrames));
+        }
+        m_metrics.offlineRecordsSent += static_cast<std::uint32_t>(m_chunkRecords.size());
+        m_drainRecords += static_cast<std::uint32_t>(m_chunkRecords.size());
+    }
     ++m_metrics.batchesSent;
+    clearChunk();
+    m_bus.cancelTimer(m_offlineRetryTimer);
+
+    // Taps that waited behind this publish: send them now if their flush already came and went
+    if (!m_batch.empty() && !m_bus.isTimerArmed(m_batchFlushTimer))
+    {
+        armBatchFlush(0);
+    }
+
+    if (getOfflineBufferSize() != 0)
+    {
+        scheduleNextChunk();
+        return;
+    }
+    if (m_drainStartMs == 0)
+    {
+        return; // An online batch, not the end of a drain
+    }
+
+    const auto elapsedMs{std::max<std::uint32_t>(millis() - m_drainStartMs, 1)};
+    m_metrics.offlineDrainRecordsPerSec = static_cast<std::uint32_t>(std::uint64_t{m_drainRecords} * 1000 / elapsedMs);
+    LOG_INFO(m_name, "Offline drained: %u records in %ums (%u records/s)", m_drainRecords, elapsedMs,
+             m_metrics.offlineDrainRecordsPerSec);
+    m_drainStartMs = 0;
+}
+
+void AttendanceService::scheduleNextChunk()
+{
+    // Next dispatch, not now: a long backlog goes out one chunk per bus tick instead of holding up the loop
+    m_bus.cancelTimer(m_offlineRetryTimer);
+    m_offlineRetryTimer = m_bus.callAfter(0, [this]() { flushOfflineBatch(); });
+}
+
+void AttendanceService::clearChunk()
+{
+    m_chunkFrames = 0;
+    m_chunkFromBatch = false;
+    m_chunkPayload = {};
+    m_chunkRecords.clear();
+}
+
+void AttendanceService::releaseChunk()
+{
+    if (m_chunkFromBatch)
+    {
+        // Older than any tap batched since: back in front of them, flushed on the usual interval (or offline)
+        m_batch.insert(m_batch.begin(), m_chunkRecords.begin(), m_chunkRecords.end());
+        armBatchFlush(m_config.batchFlushIntervalMs);
+    }
+    clearChunk();
+}
+
+void AttendanceService::armOfflineRetry()
+{
+    if (!m_bus.isTimerArmed(m_offlineRetryTimer))
+    {
+        m_offlineRetryTimer = m_bus.callAfter(m_config.offlineBufferFlushIntervalMs, [this]() {
+            // No receipt for the chunk in flight by now: send it again rather than stall (at-least-once)
+            releaseChunk();
+            flushOfflineBatch();
+        });
+    }
+}
+
+void AttendanceService::addToJournal(const AttendanceRecord &record)
+{
+    if (m_journal.isFull())
+    {
+        ++m_metrics.errorCount; // Same accounting as the RAM buffer: a record is lost either way
+
+        if (m_config.offlineQueuePolicy != AttendanceConfig::OfflineQueuePolicy::DropNewest && !m_chunkFromBatch)
+        {
+            clearChunk(); // The chunk in flight may be among the dropped records: re-read it after its receipt
+        }
+
+        switch (m_config.offlineQueuePolicy)
+        {
+            case AttendanceConfig::OfflineQueuePolicy::DropOldest: {
+                m_journal.dropOldest();
+                LOG_WARN(m_name, "Journal full: dropped oldest");
+                break;
+            }
+            case AttendanceConfig::OfflineQueuePolicy::DropAll: {
+                m_journal.clear();
+                LOG_WARN(m_name, "Journal full: cleared all");
+                break;
+            }
+            case AttendanceConfig::OfflineQueuePolicy::DropNewest:
+            default: {
+                LOG_WARN(m_name, "Journal full: dropped newest");
+                return;
+            }
+        }
+    }
+
+    m_journal.append(record);
+
+    // Bound what a power cut can take: the write batch reaches flash within kWriteBatchDelayMs
+    if (!m_bus.isTimerArmed(m_journalFlushTimer))
+    {
+        m_journalFlushTimer = m_bus.callAfter(utils::AttendanceJournal::kWriteBatchDelayMs, [this]() { m_journal.flush(); });
+    }
 }
 } // namespace isic
@@ -1,27 +1,17 @@
 #include "services/ConfigService.hpp"
 
 #include "common/Logger.hpp"
+#include "core/DebounceTable.hpp"
 
 #include <LittleFS.h>
 #include <ArduinoJson.h>
+#include <algorithm>
 #include <utility>
 
 namespace isic
 {
 namespace
 {
-bool endsWith(const std::string &str, const char *suffix) noexcept
-{
-    const auto suffixLen{strlen(suffix)};
-
-    if (str.length() < suffixLen)
-    {
-        return false;
-    }
-
-    return str.compare(str.length() - suffixLen, suffixLen, suffix) == 0;
-}
-
 template<typename Type>
 bool parseNumber(const JsonVariant &json, const char *key, Type &target)
 {
@@ -110,12 +100,16 @@ void serializePn532Config(const JsonObject &pn532, const Pn532Config &pn532Confi
 void serializeAttendanceConfig(const JsonObject &attendance, const AttendanceConfig &attendanceConfig)
 {
     attendance["debounceIntervalMs"] = attendanceConfig.debounceIntervalMs;
+    attendance["debounceCacheSize"] = attendanceConfig.debounceCacheSize;
     attendance["batchMaxSize"] = attendanceConfig.batchMaxSize;
     attendance["batchFlushIntervalMs"] = attendanceConfig.batchFlushIntervalMs;
     attendance["offlineBufferSize"] = attendanceConfig.offlineBufferSize;
     attendance["offlineBufferFlushIntervalMs"] = attendanceConfig.offlineBufferFlushIntervalMs;
     attendance["batchingEnabled"] = attendanceConfig.batchingEnabled;
     attendance["offlineQueuePolicy"] = static_cast<uint8_t>(attendanceConfig.offlineQueuePolicy);
+    attendance["journalEnabled"] = attendanceConfig.journalEnabled;
+    attendance["journalMaxRecords"] = attendanceConfig.journalMaxRecords;
+    attendance["payloadFormat"] = static_cast<uint8_t>(attendanceConfig.payloadFormat);
 }
 
 void serializeFeedbackConfig(const JsonObject &feedback, const FeedbackConfig &feedbackConfig)
@@ -169,10 +163,8 @@ void serializePowerConfig(const JsonObject &power, const PowerConfig &powerConfi
     power["activityTypeMask"] = powerConfig.activityTypeMask;
 }
 
-std::string serializeToJson(const Config &config)
+void serializeConfig(JsonDocument &doc, const Config &config)
 {
-    JsonDocument doc;
-
     // Version and magic for validation on load
     doc["magic"] = config.magic;
     doc["version"] = config.version;
@@ -212,6 +204,12 @@ std::string serializeToJson(const Config &config)
     // Power
     const auto power{doc["power"].to<JsonObject>()};
     serializePowerConfig(power, config.power);
+}
+
+std::string serializeToJson(const Config &config)
+{
+    JsonDocument doc;
+    serializeConfig(doc, config);
 
     std::string result;
     result.reserve(measureJson(doc) + 1);
@@ -346,6 +344,16 @@ bool deserializeAttendanceConfig(const JsonVariant &json, AttendanceConfig &atte
     PARSE_NUM(json, "offlineBufferSize", attendanceConfig.offlineBufferSize);
     PARSE_NUM(json, "offlineBufferFlushIntervalMs", attendanceConfig.offlineBufferFlushIntervalMs);
     PARSE_BOOL(json, "batchingEnabled", attendanceConfig.batchingEnabled);
+    PARSE_BOOL(json, "journalEnabled", attendanceConfig.journalEnabled);
+    PARSE_NUM(json, "journalMaxRecords", attendanceConfig.journalMaxRecords);
+
+    // debounceCacheSize sizes a heap table at begin(): clamp to [1, DebounceTable::kMaxCapacity], lower on the ESP8266
+    if (json["debounceCacheSize"].is<uint16_t>())
+    {
+        const auto cacheSize{std::clamp<std::size_t>(json["debounceCacheSize"].as<uint16_t>(), 1, DebounceTable::kMaxCapacity)};
+        attendanceConfig.debounceCacheSize = static_cast<uint16_t>(cacheSize);
+        changed = true;
+    }
 
     // Parse enum separately, with validation. offlineQueuePolicy is uint8_t in JSON so 0 - DropOldest, 1 - DropNewest, 2 - DropAll
     if (json["offlineQueuePolicy"].is<uint8_t>())
@@ -357,6 +365,16 @@ bool deserializeAttendanceConfig(const JsonVariant &json, AttendanceConfig &atte
         }
     }
 
+    // payloadFormat: 0 - Json, 1 - Packed
+    if (json["payloadFormat"].is<uint8_t>())
+    {
+        if (const auto format{json["payloadFormat"].as<uint8_t>()}; format <= static_cast<uint8_t>(AttendanceConfig::PayloadFormat::Packed))
+        {
+            attendanceConfig.payloadFormat = static_cast<AttendanceConfig::PayloadFormat>(format);
+            changed = true;
+        }
+    }
+
     return changed;
 }
 
@@ -447,11 +465,11 @@ bool deserializePowerConfig(const JsonVariant &json, PowerConfig &powerConfig)
     return changed;
 }
 
-bool deserializeJson(const char *serviceName, const char *json, Config &config)
+bool deserializeJson(const char *serviceName, const std::string_view json, Config &config)
 {
     JsonDocument doc;
 
-    if (const auto error = deserializeJson(doc, json); error)
+    if (const auto error = deserializeJson(doc, json.data(), json.size()); error)
     {
         LOG_ERROR(serviceName, "Parse error: %s", error.c_str());
         return false;
@@ -534,35 +552,23 @@ bool deserializeJson(const char *serviceName, const char *json, Config &config)
 #undef PARSE_NUM
 #undef PARSE_BOOL
 
-constexpr auto *kConfigSetTopicSuffix{"config/set"};
-constexpr auto *kConfigGetTopicSuffix{"config/get"};
 constexpr auto *kConfigSetTopic{"config/set/#"};
 constexpr auto *kConfigGetTopic{"config/get/#"};
+
+/// Section level of "config/set/<section>", empty for the whole config
+constexpr std::size_t kConfigSectionLevel{2};
 } // namespace
 
-ConfigService::ConfigService(EventBus &bus)
+ConfigService::ConfigService(EventBus &bus, TopicRouter &router)
     : ServiceBase("ConfigService")
     , m_bus(bus)
 {
-
-    m_eventConnections.reserve(2);
-    m_eventConnections.push_back(m_bus.subscribeScoped(EventType::MqttConnected, [this](const Event &) {
-        m_bus.publish({EventType::MqttSubscribeRequest, MqttEvent{.topic = kConfigSetTopic}});
-        m_bus.publish({EventType::MqttSubscribeRequest, MqttEvent{.topic = kConfigGetTopic}});
-    }));
-    m_eventConnections.push_back(m_bus.subscribeScoped(EventType::MqttMessage, [this](const Event &event) {
-        if (const auto *mqtt = event.get<MqttEvent>())
-        {
-            if (mqtt->topic.find(kConfigSetTopicSuffix) != std::string::npos)
-            {
-                handleSetConfigMessage(mqtt->topic, mqtt->payload);
-            }
-            else if (mqtt->topic.find(kConfigGetTopicSuffix) != std::string::npos)
-            {
-                handleGetConfigMessage(mqtt->topic);
-            }
-        }
-    }));
+    router.addRoute(kConfigSetTopic, [this](const TopicView &topic, const std::string_view payload) {
+        handleSetConfigMessage(topic[kConfigSectionLevel], payload);
+    });
+    router.addRoute(kConfigGetTopic, [this](const TopicView &topic, std::string_view) {
+        handleGetConfigMessage(topic[kConfigSectionLevel]);
+    });
 }
 
 ConfigService::~ConfigService()
@@ -626,7 +632,6 @@ void ConfigService::end()
         (void) saveNow(); // TODO: handle failure?
     }
 
-    m_eventConnections.clear();
     setState(ServiceState::Stopped);
 }
 
@@ -709,11 +714,21 @@ Status ConfigService::reset()
     return status;
 }
 
-void ConfigService::handleSetConfigMessage(const std::string &topic, const std::string &payload)
+std::string ConfigService::toJson(const Config &config)
+{
+    return serializeToJson(config);
+}
+
+bool ConfigService::fromJson(const std::string_view json, Config &config)
+{
+    return deserializeJson("ConfigService", json, config);
+}
+
+void ConfigService::handleSetConfigMessage(const std::string_view section, const std::string_view payload)
 {
     JsonDocument doc;
 
-    if (const auto error = deserializeJson(doc, payload); error)
+    if (const auto error = deserializeJson(doc, payload.data(), payload.size()); error)
     {
         LOG_ERROR(m_name, "JSON error: %s", error.c_str());
         return;
@@ -722,47 +737,47 @@ void ConfigService::handleSetConfigMessage(const std::string &topic, const std::
     auto updated{false};
     const auto json{doc.as<JsonVariant>()};
 
-    if (endsWith(topic, "/wifi"))
+    if (section == "wifi")
     {
         LOG_INFO(m_name, "Updating WiFi");
         updated = deserializeWifiConfig(json, m_config.wifi);
     }
-    else if (endsWith(topic, "/mqtt"))
+    else if (section == "mqtt")
     {
         LOG_INFO(m_name, "Updating MQTT");
         updated = deserializeMqttConfig(json, m_config.mqtt);
     }
-    else if (endsWith(topic, "/device"))
+    else if (section == "device")
     {
         LOG_INFO(m_name, "Updating Device");
         updated = deserializeDeviceConfig(json, m_config.device);
     }
-    else if (endsWith(topic, "/pn532"))
+    else if (section == "pn532")
     {
         LOG_INFO(m_name, "Updating PN532");
         updated = deserializePn532Config(json, m_config.pn532);
     }
-    else if (endsWith(topic, "/attendance"))
+    else if (section == "attendance")
     {
         LOG_INFO(m_name, "Updating Attendance");
         updated = deserializeAttendanceConfig(json, m_config.attendance);
     }
-    else if (endsWith(topic, "/feedback"))
+    else if (section == "feedback")
     {
         LOG_INFO(m_name, "Updating Feedback");
         updated = deserializeFeedbackConfig(json, m_config.feedback);
     }
-    else if (endsWith(topic, "/health"))
+    else if (section == "health")
     {
         LOG_INFO(m_name, "Updating Health");
         updated = deserializeHealthConfig(json, m_config.health);
     }
-    else if (endsWith(topic, "/ota"))
+    else if (section == "ota")
     {
         LOG_INFO(m_name, "Updating OTA");
         updated = deserializeOtaConfig(json, m_config.ota);
     }
-    else if (endsWith(topic, "/power"))
+    else if (section == "power")
     {
         LOG_INFO(m_name, "Updating Power");
         updated = deserializePowerConfig(json, m_config.power);
@@ -770,7 +785,7 @@ void ConfigService::handleSetConfigMessage(const std::string &topic, const std::
     else
     {
         LOG_INFO(m_name, "Full update");
-        updated = deserializeJson(m_name, payload.c_str(), m_config);
+        updated = deserializeJson(m_name, payload, m_config);
     }
 
     if (updated)
@@ -780,69 +795,68 @@ void ConfigService::handleSetConfigMessage(const std::string &topic, const std::
     }
 }
 
-void ConfigService::handleGetConfigMessage(const std::string &topic)
+void ConfigService::handleGetConfigMessage(const std::string_view section)
 {
     JsonDocument doc;
-    std::string payload{};
     std::string responseTopic{"config"};
 
-    if (endsWith(topic, "/wifi"))
+    if (section == "wifi")
     {
         LOG_INFO(m_name, "Getting WiFi config");
         const auto obj{doc.to<JsonObject>()};
         serializeWifiConfig(obj, m_config.wifi);
         responseTopic = "config/wifi";
     }
-    else if (endsWith(topic, "/mqtt"))
+    else if (section == "mqtt")
     {
         LOG_INFO(m_name, "Getting MQTT config");
         const auto obj{doc.to<JsonObject>()};
         serializeMqttConfig(obj, m_config.mqtt);
         responseTopic = "config/mqtt";
     }
-    else if (endsWith(topic, "/device"))
+    else if (section == "device")
     {
         LOG_INFO(m_name, "Getting Device config");
         const auto obj{doc.to<JsonObject>()};
         serializeDeviceConfig(obj, m_config.device);
         responseTopic = "config/device";
     }
-    else if (endsWith(topic, "/pn532"))
+    else if (section == "pn532")
     {
         LOG_INFO(m_name, "Getting PN532 config");
         const auto obj{doc.to<JsonObject>()};
         serializePn532Config(obj, m_config.pn532);
         responseTopic = "config/pn532";
     }
-    else if (endsWith(topic, "/attendance"))
+    else if (section == "attendance")
     {
         LOG_INFO(m_name, "Getting Attendance config");
         const auto obj{doc.to<JsonObject>()};
         serializeAttendanceConfig(obj, m_config.attendance);
         responseTopic = "config/attendance";
     }
-    else if (endsWith(topic, "/feedback"))
+    else if (section == "feedback")
     {
         LOG_INFO(m_name, "Getting Feedback config");
         const auto obj{doc.to<JsonObject>()};
         serializeFeedbackConfig(obj, m_config.feedback);
         responseTopic = "config/feedback";
     }
-    else if (endsWith(topic, "/health"))
+    else if (section == "health")
     {
         LOG_INFO(m_name, "Getting Health config");
         const auto obj{doc.to<JsonObject>()};
         serializeHealthConfig(obj, m_config.health);
         responseTopic = "config/health";
     }
-    else if (endsWith(topic, "/ota"))
+    else if (section == "ota")
     {
         LOG_INFO(m_name, "Getting OTA config");
         const auto obj{doc.to<JsonObject>()};
         serializeOtaConfig(obj, m_config.ota);
         responseTopic = "config/ota";
     }
-    else if (endsWith(topic, "/power"))
+    else if (section == "power")
     {
         LOG_INFO(m_name, "Getting Power config");
         const auto obj{doc.to<JsonObject>()};
@@ -852,16 +866,9 @@ void ConfigService::handleGetConfigMessage(const std::string &topic)
     else
     {
         LOG_INFO(m_name, "Getting full config");
-        payload = serializeToJson(m_config);
-    }
-
-    if (payload.empty())
-    {
-        const auto jsonSize = measureJson(doc);
-        payload.reserve(jsonSize + 1);
-        serializeJson(doc, payload);
+        serializeConfig(doc, m_config);
     }
 
-    m_bus.publish({EventType::MqttPublishRequest, MqttEvent{.topic = std::move(responseTopic), .payload = std::move(payload)}});
+    m_bus.publish({EventType::MqttPublishRequest, MqttEvent{.topic = std::move(responseTopic), .payload = serializeJsonPayload(doc)}});
 }
 } // namespace isic
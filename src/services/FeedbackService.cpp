@@ -89,10 +89,13 @@ FeedbackService::FeedbackService(EventBus &bus, FeedbackConfig &config)
 {
     m_eventConnections.reserve(1); // Known subscription count
 
+    // Direct: beep in the same loop pass as the scan instead of after two bus hops
     m_eventConnections.push_back(
-            m_bus.subscribeScoped(EventType::AttendanceRecorded, [this](const Event &) {
-                signalSuccess();
-            }));
+            m_bus.subscribeScoped(
+                    EventType::AttendanceRecorded, [this](const Event &) {
+                        signalSuccess();
+                    },
+                    ConnectionMode::Direct));
 }
 
 Status FeedbackService::begin()
@@ -267,6 +270,13 @@ void FeedbackService::queuePattern(const FeedbackPattern &pattern)
         return;
     }
 
+    // Idle: start now rather than on the next loop() tick (up to FEEDBACK_INTERVAL_MS later)
+    if (!m_inPattern && m_queueCount == 0)
+    {
+        executePattern(pattern);
+        return;
+    }
+
     if (m_queueCount >= FeedbackConfig::Constants::kPatternQueueSize)
     {
         LOG_WARN(m_name, "Queue full, dropping pattern");
@@ -21,7 +21,7 @@ constexpr auto *kHealthPublishTopic{"health"};
 constexpr auto *kMetricsPublishTopic{"metrics"};
 } // namespace
 
-HealthService::HealthService(EventBus &bus, HealthConfig &config)
+HealthService::HealthService(EventBus &bus, TopicRouter &router, HealthConfig &config)
     : ServiceBase("HealthService")
     , m_bus(bus)
     , m_config(config)
@@ -31,39 +31,46 @@ HealthService::HealthService(EventBus &bus, HealthConfig &config)
     // Subscribers
     m_eventConnections.reserve(3);
 
-    // MQTT connected - subscribe to health/request topic and publish status
+    // MQTT connected - publish status, then on the configured intervals
     m_eventConnections.push_back(m_bus.subscribeScoped(EventType::MqttConnected, [this](const Event &) {
         m_mqttConnected = true;
 
-        m_bus.publish({EventType::MqttSubscribeRequest, MqttEvent{.topic = kHealthRequestTopic, .payload = "", .retain = false}});
-        m_bus.publish({EventType::MqttSubscribeRequest, MqttEvent{.topic = kMetricsRequestTopic, .payload = "", .retain = false}});
-
         if (m_config.publishToMqtt)
         {
             LOG_DEBUG(m_name, "MQTT connected - scheduling initial status update");
-            m_pendingHealthPublish = true;
+            requestHealthPublish();
+            armPublishTimers();
         }
     }));
     m_eventConnections.push_back(m_bus.subscribeScoped(EventType::MqttDisconnected, [this](const Event &) {
         m_mqttConnected = false;
+        cancelPublishTimers();
     }));
 
-    // Handle incoming status requests via MQTT
-    m_eventConnections.push_back(m_bus.subscribeScoped(EventType::MqttMessage, [this](const Event &e) {
-        if (const auto *mqtt = e.get<MqttEvent>())
+    // Intervals may have changed
+    m_eventConnections.push_back(m_bus.subscribeScoped(EventType::ConfigChanged, [this](const Event &) {
+        if (!isRunning())
         {
-            if (mqtt->topic.find(kHealthRequestTopic) != std::string::npos)
-            {
-                LOG_DEBUG(m_name, "Status update requested via MQTT");
-                m_pendingHealthPublish = true;
-            }
-            else if (mqtt->topic.find(kMetricsRequestTopic) != std::string::npos)
-            {
-                LOG_DEBUG(m_name, "Metrics update requested via MQTT");
-                m_pendingMetricsPublish = true;
-            }
+            return;
+        }
+        m_bus.cancelTimer(m_healthCheckTimer);
+        m_healthCheckTimer = m_bus.callEvery(m_config.healthCheckIntervalMs, [this]() { updateSystemHealth(); });
+        cancelPublishTimers();
+        if (m_config.publishToMqtt && m_mqttConnected)
+        {
+            armPublishTimers();
         }
     }));
+
+    // Handle incoming status requests via MQTT
+    router.addRoute(kHealthRequestTopic, [this](const TopicView &, std::string_view) {
+        LOG_DEBUG(m_name, "Status update requested via MQTT");
+        requestHealthPublish();
+    });
+    router.addRoute(kMetricsRequestTopic, [this](const TopicView &, std::string_view) {
+        LOG_DEBUG(m_name, "Metrics update requested via MQTT");
+        requestMetricsPublish();
+    });
 }
 
 Status HealthService::begin()
@@ -72,9 +79,7 @@ Status HealthService::begin()
     LOG_INFO(m_name, "Initializing...");
 
     m_startTimeMs = millis();
-    m_lastHealthCheckMs = m_startTimeMs;
-    m_lastHealthPublishMs = m_startTimeMs;
-    m_lastMetricsPublishMs = m_startTimeMs;
+    m_healthCheckTimer = m_bus.callEvery(m_config.healthCheckIntervalMs, [this]() { updateSystemHealth(); });
 
     // Initial state
     m_systemHealth.overallState = HealthState::Healthy;
@@ -86,70 +91,71 @@ Status HealthService::begin()
 
 void HealthService::loop()
 {
-    if (m_state != ServiceState::Running)
-    {
-        return;
-    }
-
-    const auto now{millis()};
-    auto updatedForInterval{false};
+    // Nothing to poll: checks and publishes run from EventBus timers
+}
 
-    if ((now - m_lastHealthCheckMs) >= m_config.healthCheckIntervalMs)
+void HealthService::requestHealthPublish()
+{
+    if (m_bus.isTimerArmed(m_healthRequestTimer))
     {
-        updateSystemHealth();
-        m_lastHealthCheckMs = now;
-        updatedForInterval = true;
+        return; // Already due on the next dispatch
     }
-
-    if (m_pendingHealthPublish)
-    {
-        if (!updatedForInterval)
-        {
-            updateSystemHealth();
-        }
+    m_healthRequestTimer = m_bus.callAfter(0, [this]() {
+        updateSystemHealth();
+        // A state change seen by the update above requested this very publish again
+        m_bus.cancelTimer(m_healthRequestTimer);
         publishHealthUpdate();
-        m_pendingHealthPublish = false;
-    }
+    });
+}
 
-    if (m_pendingMetricsPublish)
+void HealthService::requestMetricsPublish()
+{
+    if (!m_bus.isTimerArmed(m_metricsRequestTimer))
     {
-        publishMetricsUpdate();
-        m_pendingMetricsPublish = false;
+        m_metricsRequestTimer = m_bus.callAfter(0, [this]() { publishMetricsUpdate(); });
     }
+}
 
-    if (m_config.publishToMqtt && m_mqttConnected)
+void HealthService::armPublishTimers()
+{
+    if (!m_bus.isTimerArmed(m_healthPublishTimer))
     {
-        const auto isHealthIntervalElapsed{((now - m_lastHealthPublishMs) >= m_config.statusUpdateIntervalMs)};
-        const auto isMetricsIntervalElapsed{((now - m_lastMetricsPublishMs) >= m_config.metricsPublishIntervalMs)};
-
-        if (isHealthIntervalElapsed)
-        {
+        m_healthPublishTimer = m_bus.callEvery(m_config.statusUpdateIntervalMs, [this]() {
             LOG_DEBUG(m_name, "Periodic health status update");
             publishHealthUpdate();
-            m_lastHealthPublishMs = now;
-        }
-
-        if (isMetricsIntervalElapsed)
-        {
+        });
+    }
+    if (!m_bus.isTimerArmed(m_metricsPublishTimer))
+    {
+        m_metricsPublishTimer = m_bus.callEvery(m_config.metricsPublishIntervalMs, [this]() {
             LOG_DEBUG(m_name, "Periodic metrics update");
             publishMetricsUpdate();
-            m_lastMetricsPublishMs = now;
-        }
+        });
     }
 }
 
+void HealthService::cancelPublishTimers()
+{
+    m_bus.cancelTimer(m_healthPublishTimer);
+    m_bus.cancelTimer(m_metricsPublishTimer);
+}
+
 void HealthService::end()
 {
     setState(ServiceState::Stopping);
     LOG_INFO(m_name, "Shutting down...");
 
+    cancelPublishTimers();
+    m_bus.cancelTimer(m_healthCheckTimer);
+    m_bus.cancelTimer(m_healthRequestTimer);
+    m_bus.cancelTimer(m_metricsRequestTimer);
     m_eventConnections.clear();
 
     setState(ServiceState::Stopped);
     LOG_INFO(m_name, "Stopped");
 }
 
-void HealthService::registerComponent(const IService *component)
+void HealthService::registerComponent(const IMetricsSource *component)
 {
     if (!component)
     {
@@ -167,7 +173,7 @@ void HealthService::registerComponent(const IService *component)
     LOG_DEBUG(m_name, "Registered component, count=%u", m_components.size());
 }
 
-void HealthService::unregisterComponent(const IService *component)
+void HealthService::unregisterComponent(const IMetricsSource *component)
 {
     if (!component)
     {
@@ -223,12 +229,12 @@ void HealthService::updateSystemHealth()
                  toString(m_systemHealth.heapState), 
                  toString(m_systemHealth.fragmentationState), 
                  toString(m_systemHealth.wifiState));
-        m_pendingHealthPublish = true;
+        requestHealthPublish();
     }
     else if (!isCurrentlyUnhealthy && wasUnhealthy)
     {
         LOG_INFO(m_name, "System health recovered");
-        m_pendingHealthPublish = true;
+        requestHealthPublish();
     }
     
     wasUnhealthy = isCurrentlyUnhealthy;
@@ -255,13 +261,9 @@ void HealthService::publishHealthUpdate()
     doc["wifi_rssi"] = m_systemHealth.wifiRssi;
     doc["wifi_rssi_state"] = toString(m_systemHealth.wifiState);
 
-    std::string json;
-    json.reserve(measureJson(doc) + 1);
-    serializeJson(doc, json);
-
     m_bus.publish(Event{EventType::MqttPublishRequest, MqttEvent{
                                                                .topic = kHealthPublishTopic,
-                                                               .payload = std::move(json),
+                                                               .payload = serializeJsonPayload(doc),
                                                                .retain = true}});
 
     LOG_INFO(m_name, "Published health update");
@@ -286,14 +288,19 @@ void HealthService::publishMetricsUpdate()
         }
     }
 
-    std::string json;
-    json.reserve(measureJson(doc) + 1);
-    serializeJson(doc, json);
+    const auto poolMetrics{PayloadPool::instance().getMetrics()};
+    auto poolObj{doc["payload_pool"].to<JsonObject>()};
+    poolObj["small_in_use"] = poolMetrics.smallInUse;
+    poolObj["small_peak"] = poolMetrics.smallPeak;
+    poolObj["large_in_use"] = poolMetrics.largeInUse;
+    poolObj["large_peak"] = poolMetrics.largePeak;
+    poolObj["heap_fallbacks"] = poolMetrics.heapFallbacks;
+    poolObj["alloc_failures"] = poolMetrics.allocFailures;
 
     m_bus.publish(Event{EventType::MqttPublishRequest,
                         MqttEvent{
                                 .topic = kMetricsPublishTopic,
-                                .payload = std::move(json),
+                                .payload = serializeJsonPayload(doc),
                                 .retain = true}});
 
     LOG_INFO(m_name, "Publishing metrics update");
@@ -10,9 +10,10 @@
 
 namespace isic
 {
-MqttService::MqttService(EventBus &bus, const MqttConfig &config, const DeviceConfig &deviceConfig)
+MqttService::MqttService(EventBus &bus, TopicRouter &router, const MqttConfig &config, const DeviceConfig &deviceConfig)
     : ServiceBase("MqttService")
     , m_bus(bus)
+    , m_router(router)
     , m_config(config)
     , m_deviceConfig(deviceConfig)
 {
@@ -43,7 +44,12 @@ MqttService::MqttService(EventBus &bus, const MqttConfig &config, const DeviceCo
         if (const auto *mqtt = e.get<MqttEvent>())
         {
             LOG_DEBUG(m_name, "MQTT message publish request: topic=%s, retain=%d", mqtt->topic.c_str(), mqtt->retain);
-            publish(mqtt->topic, mqtt->payload, mqtt->retain);
+            const auto published{mqtt->writer != nullptr ? publish(mqtt->topic.c_str(), mqtt->payload.view(), mqtt->writer, mqtt->retain)
+                                                          : publish(mqtt->topic.c_str(), mqtt->payload.view(), mqtt->retain)};
+            if (mqtt->confirm)
+            {
+                m_bus.publish(Event{published ? EventType::MqttPublished : EventType::MqttPublishFailed, *mqtt});
+            }
         }
     }));
     m_eventConnections.push_back(m_bus.subscribeScoped(EventType::MqttSubscribeRequest, [this](const Event &e) {
@@ -140,6 +146,11 @@ void MqttService::end()
 }
 
 bool MqttService::publish(const char *topicSuffix, const char *payload, bool retained)
+{
+    return publish(topicSuffix, std::string_view{payload}, retained);
+}
+
+bool MqttService::publish(const char *topicSuffix, const std::string_view payload, bool retained)
 {
     if (!m_mqttClient.connected())
     {
@@ -147,7 +158,39 @@ bool MqttService::publish(const char *topicSuffix, const char *payload, bool ret
         return false;
     }
 
-    const auto success{m_mqttClient.publish(buildTopic(topicSuffix).c_str(), payload, retained)};
+    const auto success{m_mqttClient.publish(fullTopic(topicSuffix), reinterpret_cast<const std::uint8_t *>(payload.data()),
+                                            static_cast<unsigned int>(payload.size()), retained)};
+
+    if (success)
+    {
+        ++m_metrics.messagesPublished;
+    }
+    else
+    {
+        ++m_metrics.messagesFailed;
+    }
+
+    return success;
+}
+
+bool MqttService::publish(const char *topicSuffix, const std::string_view source, const PayloadWriter writer, bool retained)
+{
+    if (!m_mqttClient.connected())
+    {
+        ++m_metrics.messagesFailed;
+        return false;
+    }
+
+    const auto length{writer(source, nullptr)};
+    auto success{m_mqttClient.beginPublish(fullTopic(topicSuffix), static_cast<unsigned int>(length), retained)};
+    if (success && writer(source, &m_mqttClient) != length)
+    {
+        // The broker is still waiting for the rest of the packet: drop the connection, loop() reconnects
+        LOG_WARN(m_name, "Short write while streaming to %s, disconnecting", topicSuffix);
+        m_mqttClient.disconnect();
+        success = false;
+    }
+    success = success && m_mqttClient.endPublish() == 1;
 
     if (success)
     {
@@ -163,7 +206,7 @@ bool MqttService::publish(const char *topicSuffix, const char *payload, bool ret
 
 bool MqttService::publish(const std::string &topicSuffix, const std::string &payload, bool retained)
 {
-    return publish(topicSuffix.c_str(), payload.c_str(), retained);
+    return publish(topicSuffix.c_str(), std::string_view{payload}, retained);
 }
 
 bool MqttService::subscribe(const char *topicSuffix)
@@ -171,8 +214,7 @@ bool MqttService::subscribe(const char *topicSuffix)
     if (!m_mqttClient.connected())
         return false;
 
-    std::string topic = buildTopic(topicSuffix);
-    return m_mqttClient.subscribe(topic.c_str());
+    return m_mqttClient.subscribe(fullTopic(topicSuffix));
 }
 
 bool MqttService::unsubscribe(const char *topicSuffix)
@@ -180,8 +222,7 @@ bool MqttService::unsubscribe(const char *topicSuffix)
     if (!m_mqttClient.connected())
         return false;
 
-    std::string topic = buildTopic(topicSuffix);
-    return m_mqttClient.unsubscribe(topic.c_str());
+    return m_mqttClient.unsubscribe(fullTopic(topicSuffix));
 }
 
 std::string MqttService::buildTopic(const char *suffix) const
@@ -195,6 +236,14 @@ std::string MqttService::buildTopic(const char *suffix) const
     return topic;
 }
 
+const char *MqttService::fullTopic(const char *suffix)
+{
+    // Keeps its capacity between calls, so steady-state publishes do not allocate
+    m_topicBuffer.assign(m_topicPrefix);
+    m_topicBuffer += suffix;
+    return m_topicBuffer.c_str();
+}
+
 void MqttService::rebuildTopicPrefix()
 {
     // Pre-reserve space for typical topic prefix to avoid reallocations
@@ -212,6 +261,9 @@ void MqttService::rebuildTopicPrefix()
         m_topicPrefix += m_deviceConfig.deviceId;
         m_topicPrefix += "/";
     }
+
+    // Prefix plus the longest suffix in use ("ota/update_available")
+    m_topicBuffer.reserve(m_topicPrefix.length() + 32);
 }
 
 void MqttService::connect()
@@ -256,6 +308,7 @@ void MqttService::connect()
 
         LOG_INFO(m_name, "MQTT connected - service now Running");
         setState(ServiceState::Running);
+        subscribeRoutes();
         m_bus.publish(EventType::MqttConnected);
     }
     else
@@ -272,12 +325,30 @@ void MqttService::handleMessage(const char *topic, std::uint8_t *payload, const
 
     LOG_DEBUG(m_name, "MQTT message: %s", topic);
 
-    // Create event with MQTT data
-    MqttEvent mqttData{
-            .topic = topic,
-            .payload = std::string(reinterpret_cast<char *>(payload), length),
-            .retain = false};
-    m_bus.publish({EventType::MqttMessage, std::move(mqttData)});
+    // Routes are relative to the device prefix; split once, handlers get views into PubSubClient's buffer
+    const std::string_view fullTopic{topic};
+    TopicView levels;
+    if (fullTopic.compare(0, m_topicPrefix.length(), m_topicPrefix) != 0 ||
+        !levels.assign(fullTopic.substr(m_topicPrefix.length())))
+    {
+        ++m_metrics.messagesUnrouted;
+        return;
+    }
+
+    if (m_router.route(levels, {reinterpret_cast<const char *>(payload), length}) == 0)
+    {
+        ++m_metrics.messagesUnrouted;
+    }
+}
+
+void MqttService::subscribeRoutes()
+{
+    m_router.forEachSubscription([this](const std::string &filter) {
+        if (!subscribe(filter.c_str()))
+        {
+            LOG_WARN(m_name, "Subscribe failed: %s", filter.c_str());
+        }
+    });
 }
 
 std::uint32_t MqttService::calculateBackoff() const noexcept
@@ -27,18 +27,16 @@ int compareVersions(const char *v1, const char *v2)
 }
 } // namespace
 
-OtaService::OtaService(EventBus &bus, const OtaConfig &config)
+OtaService::OtaService(EventBus &bus, TopicRouter &router, const OtaConfig &config)
     : ServiceBase("OtaService")
     , m_bus(bus)
     , m_config(config)
 {
-    m_eventConnections.reserve(3);
+    m_eventConnections.reserve(2);
     m_eventConnections.push_back(m_bus.subscribeScoped(EventType::MqttConnected, [this](const Event &) {
         const bool firstConnect{!m_mqttConnected};
         m_mqttConnected = true;
 
-        m_bus.publish({EventType::MqttSubscribeRequest, MqttEvent{.topic = "ota/start"}});
-
         if (firstConnect && m_config.checkOnConnect && m_config.isConfigured())
         {
             LOG_INFO(m_name, "First MQTT connect, scheduling OTA check");
@@ -54,12 +52,7 @@ OtaService::OtaService(EventBus &bus, const OtaConfig &config)
             failDownload("Connection lost");
         }
     }));
-    m_eventConnections.push_back(m_bus.subscribeScoped(EventType::MqttMessage, [this](const Event &event) {
-        if (const auto *mqtt = event.get<MqttEvent>(); mqtt && mqtt->topic.find("/ota/start") != std::string::npos)
-        {
-            m_pendingCheck = true;
-        }
-    }));
+    router.addRoute("ota/start", [this](const TopicView &, std::string_view) { m_pendingCheck = true; });
 }
 
 Status OtaService::begin()
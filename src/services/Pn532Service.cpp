@@ -131,6 +131,12 @@ void Pn532Service::loop()
         return;
     }
 
+    // A tap the bus could not take last time goes out before we read new ones
+    if (m_unpublishedCard && !retryUnpublishedCard())
+    {
+        return;
+    }
+
     if (m_useIrqMode)
     {
         // IRQ mode: start detection once, then wait for IRQ to go LOW
@@ -279,7 +285,32 @@ void Pn532Service::publishCardEvent(const std::uint8_t* uid, std::uint8_t uidLen
 
     LOG_DEBUG(m_name, "Card: %s", cardUidToString(m_lastCardUid, uidLength).c_str());
 
-    m_bus.publish({EventType::CardScanned, CardEvent{.timestampMs = m_lastCardReadMs, .uid = m_lastCardUid}});
+    if (m_unpublishedCard && !retryUnpublishedCard())
+    {
+        // Still blocked and only one retry slot - make the loss visible instead of silent
+        ++m_metrics.cardsLost;
+        LOG_ERROR(m_name, "Card lost, event queue still full: %s", cardUidToString(m_unpublishedCard->uid).c_str());
+        m_unpublishedCard.reset();
+    }
+
+    const CardEvent card{.timestampMs = m_lastCardReadMs, .uid = m_lastCardUid};
+    if (!m_bus.publish({EventType::CardScanned, card}))
+    {
+        // CardScanned is BlockWithError: nothing was queued, keep it for the next loop
+        LOG_WARN(m_name, "Event queue full, retrying card publish");
+        m_unpublishedCard = card;
+    }
+}
+
+bool Pn532Service::retryUnpublishedCard()
+{
+    ++m_metrics.publishRetries;
+    if (!m_bus.publish({EventType::CardScanned, *m_unpublishedCard}))
+    {
+        return false;
+    }
+    m_unpublishedCard.reset();
+    return true;
 }
 
 bool Pn532Service::enterSleep()
@@ -4,15 +4,17 @@
 #include "platform/PlatformPower.hpp"
 #include "services/ConfigService.hpp"
 
+#include <algorithm>
+
 namespace isic
 {
 
-PowerService::PowerService(EventBus &bus, const PowerConfig &config)
+PowerService::PowerService(EventBus &bus, TopicRouter &router, const PowerConfig &config)
     : ServiceBase("PowerService")
     , m_bus(bus)
     , m_config(config)
 {
-    eventConnections_.reserve(7);
+    eventConnections_.reserve(6);
     eventConnections_.push_back(m_bus.subscribeScoped(EventType::WifiConnected, [this](const Event &e) {
         handleWifiConnected(e);
     }));
@@ -28,12 +30,12 @@ PowerService::PowerService(EventBus &bus, const PowerConfig &config)
     eventConnections_.push_back(m_bus.subscribeScoped(EventType::CardScanned, [this](const Event &e) {
         handleCardScanned(e);
     }));
-    eventConnections_.push_back(m_bus.subscribeScoped(EventType::MqttMessage, [this](const Event &e) {
-        handleMqttMessage(e);
-    }));
     eventConnections_.push_back(m_bus.subscribeScoped(EventType::NfcReady, [this](const Event &e) {
         handleNfcReady(e);
     }));
+
+    // Any inbound message counts as activity; Local so the device does not subscribe to its own topics
+    router.addRoute("#", [this](const TopicView &, std::string_view) { handleMqttMessage(); }, TopicRouter::Subscription::Local);
 }
 
 PowerService::~PowerService()
@@ -265,7 +267,7 @@ void PowerService::handleCardScanned(const Event & /* event */)
     }
 }
 
-void PowerService::handleMqttMessage(const Event & /* event */)
+void PowerService::handleMqttMessage()
 {
     recordActivityInternal(ActivityType::MqttMessage);
 }
@@ -386,6 +388,12 @@ void PowerService::requestSleep(const PowerState state, std::uint32_t durationMs
         }
     }
 
+    // Light sleep ends no later than the next bus timer (batch flush, health check, ...)
+    if (state == PowerState::LightSleep)
+    {
+        durationMs = std::min(durationMs, m_bus.msUntilNextTimer());
+    }
+
     LOG_INFO(m_name, "Sleep requested: state=%s, duration=%ums", toString(state), durationMs);
     publishSleepRequested(state, durationMs);
 
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""
+ISIC Packed Attendance Decoder
+
+Reference decoder for the packed attendance payload (AttendanceConfig
+payloadFormat 1, published on <base_topic>/<device_id>/attendance/packed).
+Prints the records as the JSON the device sends on .../attendance, plus
+"tap_ts", the unix time of the tap in ms, when the record carries its age.
+
+Format (little-endian, varints are LEB128: 7 bits per byte, low group first):
+
+    u8      format version (1)
+    varint  record count
+    u64     unix time in ms when the batch was packed (the JSON "ts"), 0 if unknown
+    varint  sequence number of the first record
+    per record:
+      u8[7]   card UID as read; the JSON "uid" is these bytes reversed, in hex
+      varint  zigzag(sequence - (previous sequence + 1))
+      varint  age + 1: ms from the tap to the packing; 0 if unknown
+
+Usage:
+    mosquitto_sub -t 'device/+/attendance/packed' -C 1 -N | python attendance_decode.py
+    python attendance_decode.py payload.bin
+    python attendance_decode.py --hex 0102...
+"""
+
+import argparse
+import json
+import sys
+
+FORMAT_VERSION = 1
+UID_SIZE = 7
+
+
+class DecodeError(ValueError):
+    pass
+
+
+class Reader:
+    def __init__(self, data: bytes):
+        self.data = data
+        self.offset = 0
+
+    def take(self, count: int) -> bytes:
+        if self.offset + count > len(self.data):
+            raise DecodeError(f'truncated at byte {self.offset}, wanted {count} more')
+        chunk = self.data[self.offset:self.offset + count]
+        self.offset += count
+        return chunk
+
+    def varint(self) -> int:
+        value, shift = 0, 0
+        while True:
+            byte = self.take(1)[0]
+            value |= (byte & 0x7F) << shift
+            if byte < 0x80:
+                return value
+            shift += 7
+            if shift > 35:
+                raise DecodeError(f'varint too long at byte {self.offset}')
+
+
+def unzigzag(value: int) -> int:
+    return (value >> 1) ^ -(value & 1)
+
+
+def decode(payload: bytes):
+    """Return the records of a packed payload as dicts: uid, ts, seq and, if known, tap_ts."""
+    reader = Reader(payload)
+    version = reader.take(1)[0]
+    if version != FORMAT_VERSION:
+        raise DecodeError(f'unknown format version {version}')
+
+    count = reader.varint()
+    unix_ms = int.from_bytes(reader.take(8), 'little')
+    expected = reader.varint()
+
+    records = []
+    for _ in range(count):
+        uid = reader.take(UID_SIZE)
+        sequence = (expected + unzigzag(reader.varint())) & 0xFFFFFFFF
+        age = reader.varint()
+        record = {'uid': uid[::-1].hex().upper(), 'ts': unix_ms, 'seq': sequence}
+        if age != 0 and unix_ms != 0:
+            record['tap_ts'] = unix_ms - (age - 1)
+        records.append(record)
+        expected = (sequence + 1) & 0xFFFFFFFF
+
+    if reader.offset != len(payload):
+        raise DecodeError(f'{len(payload) - reader.offset} bytes after the last record')
+    return records
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode a packed attendance payload to JSON')
+    parser.add_argument('file', nargs='?', help='raw payload (default: stdin)')
+    parser.add_argument('--hex', help='payload as a hex string instead of a file')
+    args = parser.parse_args()
+
+    if args.hex is not None:
+        payload = bytes.fromhex(args.hex)
+    elif args.file:
+        with open(args.file, 'rb') as f:
+            payload = f.read()
+    else:
+        payload = sys.stdin.buffer.read()
+
+    try:
+        records = decode(payload)
+    except DecodeError as error:
+        print(f'Error: {error}', file=sys.stderr)
+        return 1
+
+    print(json.dumps(records, indent=2))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
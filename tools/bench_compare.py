@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""
+ISIC Benchmark Comparison
+
+Compares two JSON results of the native micro-benchmarks (isic_bench, see
+native/README.md) and flags regressions in CPU time per operation and in
+heap allocations per operation.
+
+With --benchmark_repetitions the median of each benchmark is compared,
+otherwise its single run.
+
+Usage:
+    python bench_compare.py bench-1.0.2.json bench-1.0.3.json
+    python bench_compare.py old.json new.json --threshold 5   # fail on >5% slower
+"""
+
+import argparse
+import json
+import sys
+
+TIME_UNIT_NS = {'ns': 1, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+# Google Benchmark's own bookkeeping adds a few allocations per run, i.e. a
+# few millionths per op; anything below this is noise, not a regression
+ALLOCATION_TOLERANCE = 0.01
+
+
+def load_results(path: str):
+    """Return (firmware version, {benchmark name: (cpu ns/op, allocs/op)})."""
+    with open(path, encoding='utf-8') as f:
+        data = json.load(f)
+
+    runs, medians = {}, {}
+    for bench in data.get('benchmarks', []):
+        cpu_ns = bench['cpu_time'] * TIME_UNIT_NS[bench.get('time_unit', 'ns')]
+        entry = (cpu_ns, bench.get('allocs/op', 0.0))
+        if bench.get('run_type') == 'aggregate':
+            if bench.get('aggregate_name') == 'median':
+                medians[bench['run_name']] = entry
+        else:
+            runs.setdefault(bench.get('run_name', bench['name']), entry)
+
+    runs.update(medians)
+    return data.get('context', {}).get('firmware_version', '?'), runs
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two isic_bench JSON results")
+    parser.add_argument('baseline', help='Earlier result (--benchmark_out=... --benchmark_out_format=json)')
+    parser.add_argument('candidate', help='Result to check against the baseline')
+    parser.add_argument('--threshold', '-t', type=float, default=10.0,
+                        help='Allowed CPU time increase in percent (default: 10)')
+    args = parser.parse_args()
+
+    try:
+        old_version, old = load_results(args.baseline)
+        new_version, new = load_results(args.candidate)
+    except (OSError, ValueError, KeyError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        return 2
+
+    print(f"baseline {old_version}  ->  candidate {new_version}")
+    print(f"{'benchmark':<44}{'old ns':>11}{'new ns':>11}{'change':>9}{'old alloc':>11}{'new alloc':>11}")
+
+    regressions = 0
+    for name in sorted(new):
+        new_ns, new_allocs = new[name]
+        if name not in old:
+            print(f"{name:<44}{'-':>11}{new_ns:>11.1f}{'new':>9}{'-':>11}{new_allocs:>11.2f}")
+            continue
+
+        old_ns, old_allocs = old[name]
+        change = (new_ns - old_ns) / old_ns * 100 if old_ns else 0.0
+        slower = change > args.threshold
+        allocates_more = new_allocs - old_allocs > ALLOCATION_TOLERANCE
+        marker = '  <-- REGRESSION' if slower or allocates_more else ''
+        regressions += 1 if marker else 0
+        print(f"{name:<44}{old_ns:>11.1f}{new_ns:>11.1f}{change:>+8.1f}%{old_allocs:>11.2f}{new_allocs:>11.2f}{marker}")
+
+    for name in sorted(set(old) - set(new)):
+        print(f"{name:<44}  (missing from candidate)")
+
+    print(f"\n{regressions} regression(s)")
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -11,6 +11,7 @@ Usage:
     python esp_fs_inspector.py --port /dev/ttyUSB0 cat /config.json
     python esp_fs_inspector.py --port /dev/ttyUSB0 tail /logs/device.log
     python esp_fs_inspector.py --port /dev/ttyUSB0 info
+    python esp_fs_inspector.py --port /dev/ttyUSB0 trace -o tap.trace  # ISIC_ENABLE_TRACE builds
     python esp_fs_inspector.py --port /dev/ttyUSB0 terminal  # Interactive mode
 """
 
@@ -169,6 +170,21 @@ class ESPFilesystemInspector:
             return True
         return False
 
+    def save_trace(self, output: str) -> bool:
+        """Dump the firmware event trace ring to a file (convert with trace_to_chrome.py)."""
+        print("Dumping event trace...")
+        response = self.send_command("TRACE")
+
+        if not response or not response.startswith("EVENTS "):
+            print("Error: No trace in response (firmware built without ISIC_ENABLE_TRACE?)", file=sys.stderr)
+            return False
+
+        with open(output, 'w', encoding='utf-8') as f:
+            f.write(response + '\n')
+        records = sum(len(line) - 2 for line in response.split('\n') if line.startswith('R ')) // 16
+        print(f"Saved {records} records to {output}")
+        return True
+
     def monitor(self, filepath: str, interval: float = 1.0):
         """Monitor a file for changes (like tail -f)."""
         print(f"Monitoring '{filepath}' (Ctrl+C to stop)...")
@@ -364,6 +380,10 @@ Examples:
     # Info command
     info_parser = subparsers.add_parser('info', help='Get filesystem information')
 
+    # Trace command
+    trace_parser = subparsers.add_parser('trace', help='Save the event trace ring (ISIC_ENABLE_TRACE builds)')
+    trace_parser.add_argument('--output', '-o', default='isic.trace', help='Output file (default: isic.trace)')
+
     # Terminal command
     terminal_parser = subparsers.add_parser('terminal', help='Interactive terminal mode')
 
@@ -410,6 +430,8 @@ Examples:
             success = True
         elif args.command == 'info':
             success = inspector.get_info()
+        elif args.command == 'trace':
+            success = inspector.save_trace(args.output)
         elif args.command == 'terminal':
             inspector.interactive_terminal()
             success = True
@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""
+ISIC Event Trace Converter
+
+Converts an event trace dumped from the firmware (ISIC_ENABLE_TRACE builds,
+saved with `esp_fs_inspector.py trace`) into Chrome trace JSON. Open the
+result in chrome://tracing or https://ui.perfetto.dev.
+
+Timeline layout:
+  - one track per source (scheduler task, or "isr")
+  - scheduler task runs and event deliveries as slices
+  - publishes as instants, with a flow arrow to the delivery of that event
+
+Publishes are matched to deliveries FIFO per event type, which is exact
+unless the ring wrapped mid-burst or an overflow policy evicted events.
+
+Usage:
+    python trace_to_chrome.py isic.trace -o isic.json
+    python trace_to_chrome.py isic.trace --summary   # tap-to-delivery latencies
+"""
+
+import argparse
+import json
+import struct
+import sys
+from collections import defaultdict, deque
+
+RECORD_FORMAT = '<IBBBB'  # timestampUs, phase, eventType, source, flags (trace::Record)
+RECORD_SIZE = struct.calcsize(RECORD_FORMAT)
+
+PHASE_PUBLISH, PHASE_DISPATCH_BEGIN, PHASE_DISPATCH_END, PHASE_TASK_BEGIN, PHASE_TASK_END = range(5)
+FLAG_DIRECT = 0x01
+FLAG_REFUSED = 0x02
+NO_EVENT_TYPE = 0xFF
+
+
+def parse_dump(text: str):
+    """Parse a TRACE dump into (event names, source names, records, total recorded)."""
+    events, sources, payload, total = [], [], bytearray(), None
+
+    for raw in text.splitlines():
+        line = raw.strip()
+        if line.startswith('FS_RESP:'):
+            line = line[len('FS_RESP:'):]
+
+        if line.startswith('EVENTS '):
+            events = line[len('EVENTS '):].split(',')
+        elif line.startswith('SOURCES '):
+            sources = line[len('SOURCES '):].split(',')
+        elif line.startswith('R '):
+            payload += bytes.fromhex(line[2:])
+        elif line.startswith('TRACE '):
+            fields = line.split()
+            if fields[1] != '1' or int(fields[2]) != RECORD_SIZE:
+                raise ValueError(f"Unsupported trace format: {line}")
+            total = int(fields[3])
+
+    if total is None:
+        raise ValueError("No TRACE header found (incomplete dump?)")
+
+    records = [struct.unpack_from(RECORD_FORMAT, payload, offset)
+               for offset in range(0, len(payload) - RECORD_SIZE + 1, RECORD_SIZE)]
+    return events, sources, records, total
+
+
+def unwrap_timestamps(records):
+    """micros() wraps every ~71 minutes; make timestamps monotonic from the first record."""
+    result, offset, previous = [], 0, None
+    for timestamp, *rest in records:
+        if previous is not None and timestamp < previous and previous - timestamp > 0x80000000:
+            offset += 1 << 32
+        previous = timestamp
+        result.append((timestamp + offset, *rest))
+    return result
+
+
+def name_of(names, index, fallback):
+    return names[index] if index < len(names) else f"{fallback}{index}"
+
+
+def to_chrome(events, sources, records):
+    """Build Chrome trace events; returns (trace events, per-type publish-to-delivery latencies in us)."""
+    out = []
+    depth = defaultdict(int)               # open slices per track, to drop ends whose begin was overwritten
+    pending = defaultdict(deque)           # eventType -> [(publish ts, flow id)] awaiting queued delivery
+    latencies = defaultdict(list)
+    flow_id = 0
+
+    for source in sorted({record[3] for record in records}):
+        out.append({'ph': 'M', 'name': 'thread_name', 'pid': 0, 'tid': source,
+                    'args': {'name': name_of(sources, source, 'source')}})
+
+    for timestamp, phase, event_type, source, flags in records:
+        base = {'pid': 0, 'tid': source, 'ts': timestamp}
+        event_name = name_of(events, event_type, 'event') if event_type != NO_EVENT_TYPE else None
+
+        if phase == PHASE_PUBLISH:
+            refused = bool(flags & FLAG_REFUSED)
+            out.append({**base, 'ph': 'i', 's': 't', 'cat': 'publish',
+                        'name': f"{'refused' if refused else 'publish'} {event_name}"})
+            if not refused:
+                flow_id += 1
+                pending[event_type].append((timestamp, flow_id))
+                out.append({**base, 'ph': 's', 'cat': 'flow', 'name': event_name, 'id': flow_id})
+
+        elif phase == PHASE_DISPATCH_BEGIN:
+            direct = bool(flags & FLAG_DIRECT)
+            out.append({**base, 'ph': 'B', 'cat': 'dispatch', 'name': event_name + (' (direct)' if direct else ''),
+                        'args': {'direct': direct}})
+            depth[source] += 1
+            # Every accepted publish is delivered once from the queue (after any direct delivery)
+            if not direct and pending[event_type]:
+                published, flow = pending[event_type].popleft()
+                latencies[event_name].append(timestamp - published)
+                out.append({**base, 'ph': 'f', 'bp': 'e', 'cat': 'flow', 'name': event_name, 'id': flow})
+
+        elif phase == PHASE_TASK_BEGIN:
+            out.append({**base, 'ph': 'B', 'cat': 'task', 'name': name_of(sources, source, 'source')})
+            depth[source] += 1
+
+        elif phase in (PHASE_DISPATCH_END, PHASE_TASK_END):
+            if depth[source] > 0:
+                depth[source] -= 1
+                out.append({**base, 'ph': 'E'})
+
+    return out, latencies
+
+
+def print_summary(latencies, records, total):
+    print(f"{len(records)} records ({total - len(records)} overwritten)")
+    print(f"{'event':<24}{'count':>8}{'min us':>10}{'avg us':>10}{'max us':>10}")
+    for name, values in sorted(latencies.items()):
+        print(f"{name:<24}{len(values):>8}{min(values):>10}{sum(values) // len(values):>10}{max(values):>10}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert an ISIC event trace dump to Chrome trace JSON")
+    parser.add_argument('input', help='Trace dump saved by esp_fs_inspector.py trace')
+    parser.add_argument('--output', '-o', help='Output JSON (default: input with .json extension)')
+    parser.add_argument('--summary', '-s', action='store_true',
+                        help='Print publish-to-delivery latency per event type')
+    args = parser.parse_args()
+
+    try:
+        with open(args.input, encoding='utf-8') as f:
+            events, sources, records, total = parse_dump(f.read())
+    except (OSError, ValueError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        return 1
+
+    records = unwrap_timestamps(records)
+    trace_events, latencies = to_chrome(events, sources, records)
+
+    output = args.output or (args.input.rsplit('.', 1)[0] + '.json')
+    with open(output, 'w', encoding='utf-8') as f:
+        json.dump({'traceEvents': trace_events, 'displayTimeUnit': 'ms'}, f)
+    print(f"Wrote {len(trace_events)} trace events to {output}")
+
+    if args.summary:
+        print_summary(latencies, records, total)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())